@@ -0,0 +1,267 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "hugepage_alloc.hpp"
+
+/**@file
+ * @brief size-bucketed caching arena for host storages and temporaries
+ */
+namespace gridtools {
+
+    /**
+     * @brief Pair of functions that allocate and free raw memory, used by `caching_arena` on cache misses. The
+     * allocation function throws on failure.
+     */
+    struct upstream_allocator {
+        void *(*allocate)(std::size_t);
+        void (*deallocate)(void *);
+    };
+
+    namespace _impl_caching_arena {
+        inline void *heap_alloc(std::size_t size) { return ::operator new(size); }
+        inline void heap_free(void *ptr) { ::operator delete(ptr); }
+    } // namespace _impl_caching_arena
+
+    /**
+     * @brief Upstream allocator using the global `operator new`, used by the host storage.
+     */
+    inline upstream_allocator const &heap_upstream() {
+        static const upstream_allocator res{&_impl_caching_arena::heap_alloc, &_impl_caching_arena::heap_free};
+        return res;
+    }
+
+    /**
+     * @brief Upstream allocator using `hugepage_alloc`, used by the mc storage and temporaries.
+     */
+    inline upstream_allocator const &hugepage_upstream() {
+        static const upstream_allocator res{&hugepage_alloc, &hugepage_free};
+        return res;
+    }
+
+    /**
+     * @brief Allocation statistics of a `caching_arena`.
+     */
+    struct caching_arena_stats {
+        // allocations served from the cache
+        std::size_t hits = 0;
+        // allocations forwarded to the upstream allocator
+        std::size_t misses = 0;
+        // bytes of the blocks currently handed out
+        std::size_t bytes_in_use = 0;
+        // bytes of the blocks currently kept in the cache
+        std::size_t bytes_cached = 0;
+        // maximum number of bytes held from the upstream allocators (in use and cached)
+        std::size_t peak_bytes = 0;
+    };
+
+    /**
+     * @brief Thread-safe cache of freed memory blocks.
+     *
+     * Requested sizes are rounded up to a bucket size: a power of two below 2MB, a multiple of 2MB above. Freed blocks
+     * are kept per upstream allocator and bucket and are handed out again for the next request of the same bucket,
+     * hence the pages of a reused block are already mapped (and, with transparent huge pages, already backed by huge
+     * pages), which avoids the page faults of a fresh allocation. The cached blocks are returned to the upstream
+     * allocators by `release` and on destruction.
+     */
+    class caching_arena {
+        using bucket_key_t = std::pair<upstream_allocator const *, std::size_t>;
+
+        struct key_less {
+            bool operator()(bucket_key_t const &lhs, bucket_key_t const &rhs) const {
+                if (lhs.first != rhs.first)
+                    return std::less<upstream_allocator const *>()(lhs.first, rhs.first);
+                return lhs.second < rhs.second;
+            }
+        };
+
+        std::size_t m_max_cached_bytes;
+        mutable std::mutex m_mutex;
+        std::map<bucket_key_t, std::vector<void *>, key_less> m_cache;
+        caching_arena_stats m_stats;
+
+        void update_peak() {
+            m_stats.peak_bytes = std::max(m_stats.peak_bytes, m_stats.bytes_in_use + m_stats.bytes_cached);
+        }
+
+      public:
+        /**
+         * @param max_cached_bytes maximum number of bytes kept in the cache, blocks that do not fit are freed.
+         */
+        explicit caching_arena(std::size_t max_cached_bytes = std::size_t(-1)) : m_max_cached_bytes(max_cached_bytes) {}
+
+        caching_arena(caching_arena const &) = delete;
+        caching_arena &operator=(caching_arena const &) = delete;
+
+        ~caching_arena() { release(); }
+
+        /**
+         * @brief Size of the blocks that are allocated for a request of `size` bytes.
+         */
+        static std::size_t bucket_size(std::size_t size) {
+            constexpr std::size_t page = 2 * 1024 * 1024;
+            if (size >= page)
+                return (size + page - 1) / page * page;
+            std::size_t bucket = 64;
+            while (bucket < size)
+                bucket *= 2;
+            return bucket;
+        }
+
+        /**
+         * @brief Allocates at least `size` bytes, `deallocate` must be called with the same `size` and `upstream`.
+         */
+        void *allocate(std::size_t size, upstream_allocator const &upstream) {
+            const std::size_t bucket = bucket_size(size);
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                auto it = m_cache.find(bucket_key_t(&upstream, bucket));
+                if (it != m_cache.end() && !it->second.empty()) {
+                    void *ptr = it->second.back();
+                    it->second.pop_back();
+                    ++m_stats.hits;
+                    m_stats.bytes_cached -= bucket;
+                    m_stats.bytes_in_use += bucket;
+                    return ptr;
+                }
+            }
+            void *ptr = upstream.allocate(bucket);
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ++m_stats.misses;
+            m_stats.bytes_in_use += bucket;
+            update_peak();
+            return ptr;
+        }
+
+        /**
+         * @brief Returns a block to the cache.
+         */
+        void deallocate(void *ptr, std::size_t size, upstream_allocator const &upstream) {
+            const std::size_t bucket = bucket_size(size);
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                assert(m_stats.bytes_in_use >= bucket);
+                m_stats.bytes_in_use -= bucket;
+                if (m_stats.bytes_cached + bucket <= m_max_cached_bytes) {
+                    m_cache[bucket_key_t(&upstream, bucket)].push_back(ptr);
+                    m_stats.bytes_cached += bucket;
+                    return;
+                }
+            }
+            upstream.deallocate(ptr);
+        }
+
+        /**
+         * @brief Returns all cached blocks to their upstream allocators.
+         */
+        void release() {
+            std::map<bucket_key_t, std::vector<void *>, key_less> cache;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                cache.swap(m_cache);
+                m_stats.bytes_cached = 0;
+            }
+            for (auto &bucket : cache)
+                for (void *ptr : bucket.second)
+                    bucket.first.first->deallocate(ptr);
+        }
+
+        caching_arena_stats stats() const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_stats;
+        }
+    };
+
+    namespace _impl_caching_arena {
+        inline std::shared_ptr<caching_arena> &current() {
+            thread_local std::shared_ptr<caching_arena> arena;
+            return arena;
+        }
+    } // namespace _impl_caching_arena
+
+    /**
+     * @brief Deleter of the blocks allocated by `arena_allocate`, holds a reference to the arena of the block.
+     */
+    struct arena_deleter {
+        std::shared_ptr<caching_arena> m_arena;
+        upstream_allocator const *m_upstream = nullptr;
+        std::size_t m_size = 0;
+
+        void operator()(void *ptr) const {
+            if (m_arena)
+                m_arena->deallocate(ptr, m_size, *m_upstream);
+            else
+                m_upstream->deallocate(ptr);
+        }
+    };
+
+    using arena_ptr = std::unique_ptr<void, arena_deleter>;
+
+    /**
+     * @brief Allocates `size` bytes from the arena of the innermost active `caching_arena_scope` of the calling
+     * thread, directly from `upstream` if there is none. The block is returned to its arena when the pointer is
+     * destroyed, even if the scope has ended in the meantime.
+     */
+    inline arena_ptr arena_allocate(std::size_t size, upstream_allocator const &upstream) {
+        auto const &arena = _impl_caching_arena::current();
+        if (arena)
+            return {arena->allocate(size, upstream), arena_deleter{arena, &upstream, size}};
+        return {upstream.allocate(size), arena_deleter{nullptr, &upstream, size}};
+    }
+
+    /**
+     * @brief Routes the allocations of storages and temporaries made by the calling thread through a caching arena
+     * during its lifetime.
+     *
+     * Scopes nest, the previous arena is restored on destruction. A scope constructed without argument uses a private
+     * arena, whose cached blocks are freed as soon as the scope and all storages allocated in it are gone. Pass a
+     * shared arena to keep the cache across scopes, e.g. across the members of an ensemble:
+     *
+     *     auto arena = std::make_shared<caching_arena>();
+     *     for (auto &member : ensemble) {
+     *         caching_arena_scope scope(arena);
+     *         ...
+     *     }
+     */
+    class caching_arena_scope {
+        std::shared_ptr<caching_arena> m_arena;
+        std::shared_ptr<caching_arena> m_previous;
+
+      public:
+        explicit caching_arena_scope(std::shared_ptr<caching_arena> arena = std::make_shared<caching_arena>())
+            : m_arena(std::move(arena)), m_previous(std::move(_impl_caching_arena::current())) {
+            assert(m_arena);
+            _impl_caching_arena::current() = m_arena;
+        }
+
+        caching_arena_scope(caching_arena_scope const &) = delete;
+        caching_arena_scope &operator=(caching_arena_scope const &) = delete;
+
+        ~caching_arena_scope() {
+            assert(_impl_caching_arena::current() == m_arena);
+            _impl_caching_arena::current() = std::move(m_previous);
+        }
+
+        caching_arena &arena() const { return *m_arena; }
+
+        caching_arena_stats stats() const { return m_arena->stats(); }
+    };
+} // namespace gridtools
@@ -0,0 +1,35 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <cstdlib>
+#include <string>
+
+#ifdef __GNUG__
+#include <cxxabi.h>
+#endif
+
+namespace gridtools {
+    /**
+     * @brief Human readable form of a type name as returned by `typeid(...).name()`, if the compiler supports it.
+     */
+    inline std::string demangle(char const *name) {
+#ifdef __GNUG__
+        int status = 0;
+        char *demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+        if (status == 0) {
+            std::string res = demangled;
+            std::free(demangled);
+            return res;
+        }
+#endif
+        return name;
+    }
+} // namespace gridtools
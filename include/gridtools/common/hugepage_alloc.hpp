@@ -10,42 +10,275 @@
 
 #pragma once
 
+#include <algorithm>
 #include <atomic>
+#include <cstdint>
+#include <cstdio>
 #include <cstdlib>
+#include <fstream>
 #include <new>
+#include <stdexcept>
+#include <string>
 
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+/**@file
+ * @brief huge page allocation for the mc storage and temporaries
+ *
+ * The strategy used by `hugepage_alloc(size)` can be set with `set_hugepage_strategy` or with the environment variable
+ * GT_HUGEPAGE_STRATEGY (`transparent`, `madvise`, `hugetlb` or `hugetlb_1gb`). The default is `madvise`, or
+ * `transparent` if GT_NO_HUGETLB is defined.
+ */
 namespace gridtools {
 
     /**
-     * @brief Allocates huge page memory (if GT_NO_HUGETLB is not defined) and shifts allocations by some bytes to
-     * reduce cache set conflicts.
+     * @brief How `hugepage_alloc` asks the system for huge pages.
+     */
+    enum class hugepage_strategy {
+        // 2MB aligned heap memory, huge pages are used if transparent huge pages are enabled unconditionally
+        transparent,
+        // as `transparent`, additionally requests transparent huge pages with madvise(MADV_HUGEPAGE)
+        madvise,
+        // 2MB pages from the hugetlbfs pool with mmap(MAP_HUGETLB), falls back to `madvise` if the pool is exhausted
+        hugetlb,
+        // as `hugetlb` with 1GB pages, falls back to `hugetlb`
+        hugetlb_1gb
+    };
+
+    inline char const *hugepage_strategy_name(hugepage_strategy strategy) {
+        switch (strategy) {
+        case hugepage_strategy::transparent:
+            return "transparent";
+        case hugepage_strategy::madvise:
+            return "madvise";
+        case hugepage_strategy::hugetlb:
+            return "hugetlb";
+        case hugepage_strategy::hugetlb_1gb:
+            return "hugetlb_1gb";
+        }
+        return "";
+    }
+
+    /**
+     * @brief Inverse of `hugepage_strategy_name`, throws std::invalid_argument for unknown names.
+     */
+    inline hugepage_strategy parse_hugepage_strategy(std::string const &name) {
+        for (auto strategy : {hugepage_strategy::transparent,
+                 hugepage_strategy::madvise,
+                 hugepage_strategy::hugetlb,
+                 hugepage_strategy::hugetlb_1gb})
+            if (name == hugepage_strategy_name(strategy))
+                return strategy;
+        throw std::invalid_argument("unknown huge page strategy \"" + name + "\"");
+    }
+
+    /**
+     * @brief Strategy and huge page coverage of an allocation of `hugepage_alloc`.
      */
-    inline void *hugepage_alloc(std::size_t size) {
-        static std::atomic<std::size_t> s_offset(64);
-        auto offset = s_offset.load(std::memory_order_relaxed);
-        auto next_offset = offset;
-        while (!s_offset.compare_exchange_weak(
-            next_offset, 2 * next_offset <= 4096 ? 2 * next_offset : 64, std::memory_order_relaxed)) {
+    struct hugepage_allocation_info {
+        hugepage_strategy requested = hugepage_strategy::transparent; /** Strategy passed to `hugepage_alloc`. */
+        hugepage_strategy strategy = hugepage_strategy::transparent;  /** Strategy used after the fallbacks. */
+        std::size_t size = 0;                                         /** Requested bytes. */
+        std::size_t page_size = 0;                                    /** Size of the huge pages in bytes. */
+        std::size_t huge_bytes = 0; /** Bytes of the allocation backed by huge pages. */
+
+        double coverage() const { return size ? double(huge_bytes) / size : 0.; }
+    };
+
+    namespace _impl_hugepage_alloc {
+        constexpr std::size_t huge_page_2mb = std::size_t(1) << 21;
+        constexpr std::size_t huge_page_1gb = std::size_t(1) << 30;
+
+        struct header {
+            void *base;
+            std::size_t mapped_size;
+            std::size_t size;
+            hugepage_strategy requested;
+            hugepage_strategy strategy;
+        };
+        static_assert(sizeof(header) <= 64, "the allocation header must fit into the smallest offset");
+
+        inline hugepage_strategy initial_strategy() {
+            if (char const *env = std::getenv("GT_HUGEPAGE_STRATEGY"))
+                return parse_hugepage_strategy(env);
+#ifdef GT_NO_HUGETLB
+            return hugepage_strategy::transparent;
+#else
+            return hugepage_strategy::madvise;
+#endif
         }
 
-        void *ptr;
-        if (posix_memalign(&ptr, 2 * 1024 * 1024, size + offset))
-            throw std::bad_alloc();
+        inline std::atomic<hugepage_strategy> &current_strategy() {
+            static std::atomic<hugepage_strategy> res(initial_strategy());
+            return res;
+        }
+
+        /**
+         * @brief Rotates through the offsets 64, 128, ..., 4096, so that consecutive allocations differ in their
+         * last 12 bits.
+         */
+        inline std::size_t next_offset() {
+            static std::atomic<std::size_t> s_offset(64);
+            auto offset = s_offset.load(std::memory_order_relaxed);
+            while (!s_offset.compare_exchange_weak(
+                offset, 2 * offset <= 4096 ? 2 * offset : 64, std::memory_order_relaxed)) {
+            }
+            return offset;
+        }
+
+        inline std::size_t page_size(hugepage_strategy strategy) {
+            return strategy == hugepage_strategy::hugetlb_1gb ? huge_page_1gb : huge_page_2mb;
+        }
+
+#ifdef __linux__
+        inline std::size_t hugetlb_size(std::size_t size, hugepage_strategy strategy) {
+            const std::size_t page = page_size(strategy);
+            return (size + page - 1) / page * page;
+        }
+
+        /**
+         * @brief Maps `size` bytes, rounded up to full pages, from the hugetlbfs pool with the page size of the given
+         * strategy, returns nullptr if no pages are available.
+         */
+        inline void *map_hugetlb(std::size_t size, hugepage_strategy strategy) {
+#ifdef MAP_HUGETLB
+            constexpr int huge_shift = 26; // MAP_HUGE_SHIFT, missing in old headers
+            const int log2_page = strategy == hugepage_strategy::hugetlb_1gb ? 30 : 21;
+            void *ptr = mmap(nullptr,
+                hugetlb_size(size, strategy),
+                PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (log2_page << huge_shift),
+                -1,
+                0);
+            return ptr == MAP_FAILED ? nullptr : ptr;
+#else
+            return nullptr;
+#endif
+        }
 
-        ptr = static_cast<char *>(ptr) + offset;
-        static_cast<std::size_t *>(ptr)[-1] = offset;
+        /**
+         * @brief Estimates the bytes of the address range [first, last) backed by transparent huge pages from the
+         * AnonHugePages entries of /proc/self/smaps. The huge pages of a mapping are assumed to be evenly distributed
+         * over the mapping, as smaps does not report their addresses.
+         */
+        inline std::size_t transparent_huge_bytes(std::uintptr_t first, std::uintptr_t last) {
+            std::ifstream smaps("/proc/self/smaps");
+            std::string line;
+            double res = 0;
+            std::uintptr_t overlap = 0, mapping_size = 0;
+            while (std::getline(smaps, line)) {
+                unsigned long long begin, end, kb;
+                if (std::sscanf(line.c_str(), "%llx-%llx ", &begin, &end) == 2) {
+                    std::uintptr_t lo = std::max<std::uintptr_t>(begin, first);
+                    std::uintptr_t hi = std::min<std::uintptr_t>(end, last);
+                    overlap = hi > lo ? hi - lo : 0;
+                    mapping_size = end - begin;
+                } else if (overlap && std::sscanf(line.c_str(), "AnonHugePages: %llu kB", &kb) == 1) {
+                    res += kb * 1024. * overlap / mapping_size;
+                }
+            }
+            return std::min<std::size_t>(res, last - first);
+        }
+#endif
+
+        inline header &get_header(void const *ptr) {
+            return reinterpret_cast<header *>(const_cast<void *>(ptr))[-1];
+        }
+    } // namespace _impl_hugepage_alloc
+
+    /**
+     * @brief The strategy used by `hugepage_alloc(size)`.
+     */
+    inline hugepage_strategy get_hugepage_strategy() { return _impl_hugepage_alloc::current_strategy().load(); }
+
+    /**
+     * @brief Sets the strategy used by subsequent calls of `hugepage_alloc(size)`, e.g., by the allocations of mc
+     * storages and temporaries. Existing allocations are not affected.
+     */
+    inline void set_hugepage_strategy(hugepage_strategy strategy) {
+        _impl_hugepage_alloc::current_strategy().store(strategy);
+    }
+
+    /**
+     * @brief Allocates huge page memory with the given strategy and shifts allocations by some bytes to reduce cache
+     * set conflicts. Strategies that are not available fall back as described at `hugepage_strategy`, on systems other
+     * than Linux all strategies fall back to `transparent`.
+     */
+    inline void *hugepage_alloc(std::size_t size, hugepage_strategy strategy) {
+        using namespace _impl_hugepage_alloc;
+        const std::size_t offset = next_offset();
+        header h{nullptr, size + offset, size, strategy, strategy};
+#ifdef __linux__
+        if (h.strategy == hugepage_strategy::hugetlb_1gb && !(h.base = map_hugetlb(h.mapped_size, h.strategy)))
+            h.strategy = hugepage_strategy::hugetlb;
+        if (h.strategy == hugepage_strategy::hugetlb && !(h.base = map_hugetlb(h.mapped_size, h.strategy)))
+            h.strategy = hugepage_strategy::madvise;
+        if (h.base)
+            h.mapped_size = hugetlb_size(h.mapped_size, h.strategy);
+#else
+        h.strategy = hugepage_strategy::transparent;
+#endif
+        if (!h.base) {
+            if (posix_memalign(&h.base, huge_page_2mb, h.mapped_size))
+                throw std::bad_alloc();
+#ifdef __linux__
+            // fails if the kernel does not support transparent huge pages
+            if (h.strategy == hugepage_strategy::madvise && madvise(h.base, h.mapped_size, MADV_HUGEPAGE))
+                h.strategy = hugepage_strategy::transparent;
+#endif
+        }
+
+        void *ptr = static_cast<char *>(h.base) + offset;
+        get_header(ptr) = h;
         return ptr;
     }
 
+    /**
+     * @brief Allocates huge page memory with the current strategy (see `set_hugepage_strategy`).
+     */
+    inline void *hugepage_alloc(std::size_t size) { return hugepage_alloc(size, get_hugepage_strategy()); }
+
     /**
      * @brief Frees memory allocated by hugepage_alloc.
      */
     inline void hugepage_free(void *ptr) {
         if (!ptr)
             return;
-        std::size_t offset = static_cast<std::size_t *>(ptr)[-1];
-        ptr = static_cast<char *>(ptr) - offset;
-        free(ptr);
+        auto const &h = _impl_hugepage_alloc::get_header(ptr);
+#ifdef __linux__
+        if (h.strategy == hugepage_strategy::hugetlb || h.strategy == hugepage_strategy::hugetlb_1gb) {
+            munmap(h.base, h.mapped_size);
+            return;
+        }
+#endif
+        free(h.base);
+    }
+
+    /**
+     * @brief Reports the strategy and the huge page coverage of an allocation of `hugepage_alloc`.
+     *
+     * Pages from the hugetlbfs pool cover the whole allocation. Transparent huge pages are only used for memory that
+     * has been touched, their coverage is estimated from /proc/self/smaps and hence is expensive to query.
+     */
+    inline hugepage_allocation_info hugepage_info(void const *ptr) {
+        hugepage_allocation_info res;
+        if (!ptr)
+            return res;
+        auto const &h = _impl_hugepage_alloc::get_header(ptr);
+        res.requested = h.requested;
+        res.strategy = h.strategy;
+        res.size = h.size;
+        res.page_size = _impl_hugepage_alloc::page_size(h.strategy);
+        if (h.strategy == hugepage_strategy::hugetlb || h.strategy == hugepage_strategy::hugetlb_1gb)
+            res.huge_bytes = h.size;
+#ifdef __linux__
+        else
+            res.huge_bytes = _impl_hugepage_alloc::transparent_huge_bytes(
+                reinterpret_cast<std::uintptr_t>(ptr), reinterpret_cast<std::uintptr_t>(ptr) + h.size);
+#endif
+        return res;
     }
 
 } // namespace gridtools
@@ -0,0 +1,147 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "host_device.hpp"
+
+/**
+ * @file
+ * 16-bit floating point types for storages of fields that tolerate a reduced precision.
+ *
+ * The types only store values: they widen implicitly to float when they are read and round to nearest even when a
+ * value is assigned to them. Hence, in stencils, all arithmetic is performed in float (or double, if mixed with
+ * doubles), while the storages move half the bytes of float storages.
+ */
+namespace gridtools {
+    namespace _impl_reduced_precision {
+        GT_FUNCTION std::uint32_t float_bits(float value) {
+            std::uint32_t res;
+            std::memcpy(&res, &value, sizeof(res));
+            return res;
+        }
+
+        GT_FUNCTION float bits_float(std::uint32_t bits) {
+            float res;
+            std::memcpy(&res, &bits, sizeof(res));
+            return res;
+        }
+
+        GT_FUNCTION std::uint16_t float_to_bfloat16(float value) {
+            std::uint32_t bits = float_bits(value);
+            if ((bits & 0x7fffffff) > 0x7f800000)
+                return (bits >> 16) | 0x40; // quiet NaN
+            return (bits + 0x7fff + ((bits >> 16) & 1)) >> 16;
+        }
+
+        GT_FUNCTION std::uint16_t float_to_half(float value) {
+            const std::uint32_t bits = float_bits(value);
+            const std::uint16_t sign = (bits >> 16) & 0x8000;
+            const std::uint32_t abs_bits = bits & 0x7fffffff;
+            if (abs_bits > 0x7f800000)
+                return sign | 0x7e00; // quiet NaN
+            if (abs_bits >= 0x47800000)
+                return sign | 0x7c00; // infinity, also for overflows
+            if (abs_bits >= 0x38800000) {
+                // normal number: rebias the exponent and round the mantissa to 10 bits
+                std::uint32_t res = ((abs_bits >> 23) - 112) << 10 | (abs_bits >> 13 & 0x3ff);
+                const std::uint32_t rest = abs_bits & 0x1fff;
+                if (rest > 0x1000 || (rest == 0x1000 && (res & 1)))
+                    ++res; // may carry into the exponent, up to infinity
+                return sign | res;
+            }
+            // subnormal number or zero
+            const std::uint32_t shift = 126 - (abs_bits >> 23);
+            if (shift > 24)
+                return sign;
+            const std::uint32_t mantissa = (abs_bits & 0x7fffff) | 0x800000;
+            std::uint32_t res = mantissa >> shift;
+            const std::uint32_t rest = mantissa & ((1u << shift) - 1);
+            const std::uint32_t halfway = 1u << (shift - 1);
+            if (rest > halfway || (rest == halfway && (res & 1)))
+                ++res;
+            return sign | res;
+        }
+
+        GT_FUNCTION float half_to_float(std::uint16_t value) {
+            const std::uint32_t sign = std::uint32_t(value & 0x8000) << 16;
+            const std::uint32_t exponent = value >> 10 & 0x1f;
+            const std::uint32_t mantissa = value & 0x3ff;
+            if (exponent == 0x1f)
+                return bits_float(sign | 0x7f800000 | mantissa << 13);
+            if (exponent == 0) {
+                // subnormal number or zero: mantissa * 2^-24
+                const float abs_value = mantissa * 5.9604644775390625e-8f;
+                return sign ? -abs_value : abs_value;
+            }
+            return bits_float(sign | (exponent + 112) << 23 | mantissa << 13);
+        }
+    } // namespace _impl_reduced_precision
+
+    /**
+     * @brief The bfloat16 format: the upper 16 bits of a float, i.e. 8 exponent and 7 mantissa bits.
+     */
+    class bfloat16 {
+        std::uint16_t m_bits;
+
+      public:
+        bfloat16() = default;
+        GT_FUNCTION bfloat16(float value) : m_bits(_impl_reduced_precision::float_to_bfloat16(value)) {}
+
+        GT_FUNCTION operator float() const { return _impl_reduced_precision::bits_float(std::uint32_t(m_bits) << 16); }
+
+        GT_FUNCTION std::uint16_t bits() const { return m_bits; }
+
+        GT_FUNCTION static bfloat16 from_bits(std::uint16_t bits) {
+            bfloat16 res;
+            res.m_bits = bits;
+            return res;
+        }
+    };
+
+    /**
+     * @brief The IEEE 754 binary16 format, with 5 exponent and 10 mantissa bits.
+     */
+    class float16 {
+        std::uint16_t m_bits;
+
+      public:
+        float16() = default;
+        GT_FUNCTION float16(float value) : m_bits(_impl_reduced_precision::float_to_half(value)) {}
+
+        GT_FUNCTION operator float() const { return _impl_reduced_precision::half_to_float(m_bits); }
+
+        GT_FUNCTION std::uint16_t bits() const { return m_bits; }
+
+        GT_FUNCTION static float16 from_bits(std::uint16_t bits) {
+            float16 res;
+            res.m_bits = bits;
+            return res;
+        }
+    };
+
+    template <class T>
+    struct is_reduced_precision : std::false_type {};
+
+    template <>
+    struct is_reduced_precision<bfloat16> : std::true_type {};
+
+    template <>
+    struct is_reduced_precision<float16> : std::true_type {};
+
+    /**
+     * @brief The type in which values of type T are computed: float for the reduced precision types, T otherwise.
+     */
+    template <class T>
+    using widened_t = std::conditional_t<is_reduced_precision<T>::value, float, T>;
+} // namespace gridtools
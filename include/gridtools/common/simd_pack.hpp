@@ -0,0 +1,298 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+
+#include "defs.hpp"
+#include "gt_math.hpp"
+#include "host_device.hpp"
+#include "reduced_precision.hpp"
+
+/**
+ * @file
+ * SIMD packs of values, as used by the mc backend to evaluate stages on several i-positions at once.
+ *
+ * The arithmetic operators are implemented with the vector extensions of GCC-compatible compilers, such that they are
+ * always compiled to SIMD instructions, independently of the auto-vectorization heuristics of the compiler.
+ */
+namespace gridtools {
+    /**
+     * @brief Lane-wise booleans, the result of comparing SIMD packs.
+     */
+    template <int_t N>
+    class simd_mask {
+        bool m_values[N];
+
+      public:
+        simd_mask() = default;
+        GT_FORCE_INLINE simd_mask(bool value) {
+            for (int_t lane = 0; lane < N; ++lane)
+                m_values[lane] = value;
+        }
+
+        GT_FORCE_INLINE bool operator[](int_t lane) const { return m_values[lane]; }
+        GT_FORCE_INLINE bool &operator[](int_t lane) { return m_values[lane]; }
+
+        GT_FORCE_INLINE friend simd_mask operator!(simd_mask const &mask) {
+            simd_mask res;
+            for (int_t lane = 0; lane < N; ++lane)
+                res[lane] = !mask[lane];
+            return res;
+        }
+        GT_FORCE_INLINE friend simd_mask operator&&(simd_mask const &lhs, simd_mask const &rhs) {
+            simd_mask res;
+            for (int_t lane = 0; lane < N; ++lane)
+                res[lane] = lhs[lane] && rhs[lane];
+            return res;
+        }
+        GT_FORCE_INLINE friend simd_mask operator||(simd_mask const &lhs, simd_mask const &rhs) {
+            simd_mask res;
+            for (int_t lane = 0; lane < N; ++lane)
+                res[lane] = lhs[lane] || rhs[lane];
+            return res;
+        }
+    };
+
+    /**
+     * @brief A pack of N values of an arithmetic type T.
+     *
+     * Scalars are implicitly broadcast to all lanes, so packs can be mixed with scalars in arithmetic expressions.
+     */
+    template <class T, int_t N>
+    class simd_pack {
+        GT_STATIC_ASSERT(std::is_arithmetic<T>::value, "simd_pack requires an arithmetic value type");
+        GT_STATIC_ASSERT(N > 0 && (N & (N - 1)) == 0, "the number of lanes of a simd_pack should be a power of two");
+
+        typedef T vector_t __attribute__((vector_size(N * sizeof(T))));
+
+        vector_t m_data;
+
+        GT_FORCE_INLINE static simd_pack from_vector(vector_t const &data) {
+            simd_pack res;
+            res.m_data = data;
+            return res;
+        }
+
+      public:
+        using value_type = T;
+        static constexpr int_t lanes = N;
+
+        simd_pack() = default;
+        GT_FORCE_INLINE simd_pack(T value) : m_data(vector_t{} + value) {}
+
+        // integral packs, like positionals, are implicitly widened to floating point packs
+        template <class U,
+            std::enable_if_t<std::is_integral<U>::value && std::is_floating_point<T>::value, int> = 0>
+        GT_FORCE_INLINE simd_pack(simd_pack<U, N> const &other) {
+            for (int_t lane = 0; lane < N; ++lane)
+                m_data[lane] = other[lane];
+        }
+
+        template <class U,
+            std::enable_if_t<!std::is_same<U, T>::value &&
+                                 !(std::is_integral<U>::value && std::is_floating_point<T>::value),
+                int> = 0>
+        GT_FORCE_INLINE explicit simd_pack(simd_pack<U, N> const &other) {
+            for (int_t lane = 0; lane < N; ++lane)
+                m_data[lane] = other[lane];
+        }
+
+        GT_FORCE_INLINE T operator[](int_t lane) const { return m_data[lane]; }
+
+        /**
+         * @brief Loads the values `ptr[lane * stride]` of the first `active` lanes, the remaining lanes repeat the
+         * value of the first one.
+         */
+        GT_FORCE_INLINE static simd_pack load(T const *ptr, int_t stride, int_t active) {
+            simd_pack res;
+            if (active == N && stride == 1) {
+                std::memcpy(&res.m_data, ptr, sizeof(vector_t));
+            } else {
+                for (int_t lane = 0; lane < N; ++lane)
+                    res.m_data[lane] = ptr[lane < active ? lane * stride : 0];
+            }
+            return res;
+        }
+
+        /**
+         * @brief Stores the values of the first `active` lanes to `ptr[lane * stride]`.
+         */
+        GT_FORCE_INLINE void store(T *ptr, int_t stride, int_t active) const {
+            if (active == N && stride == 1) {
+                std::memcpy(ptr, &m_data, sizeof(vector_t));
+            } else {
+                for (int_t lane = 0; lane < active; ++lane)
+                    ptr[lane * stride] = m_data[lane];
+            }
+        }
+
+        /**
+         * @brief Loads and widens values of a reduced precision type, see `load` above.
+         */
+        template <class U,
+            std::enable_if_t<std::is_same<widened_t<U>, T>::value && !std::is_same<U, T>::value, int> = 0>
+        GT_FORCE_INLINE static simd_pack load(U const *ptr, int_t stride, int_t active) {
+            simd_pack res;
+            for (int_t lane = 0; lane < N; ++lane)
+                res.m_data[lane] = ptr[lane < active ? lane * stride : 0];
+            return res;
+        }
+
+        /**
+         * @brief Rounds and stores values to a reduced precision type, see `store` above.
+         */
+        template <class U,
+            std::enable_if_t<std::is_same<widened_t<U>, T>::value && !std::is_same<U, T>::value, int> = 0>
+        GT_FORCE_INLINE void store(U *ptr, int_t stride, int_t active) const {
+            for (int_t lane = 0; lane < active; ++lane)
+                ptr[lane * stride] = m_data[lane];
+        }
+
+        /**
+         * @brief The pack `first, first + 1, ..., first + N - 1`.
+         */
+        GT_FORCE_INLINE static simd_pack iota(T first) {
+            simd_pack res;
+            for (int_t lane = 0; lane < N; ++lane)
+                res.m_data[lane] = first + lane;
+            return res;
+        }
+
+        GT_FORCE_INLINE friend simd_pack operator+(simd_pack const &value) { return value; }
+        GT_FORCE_INLINE friend simd_pack operator-(simd_pack const &value) { return from_vector(-value.m_data); }
+
+#define GT_SIMD_PACK_BINARY_OPERATOR(op)                                                  \
+    GT_FORCE_INLINE friend simd_pack operator op(simd_pack const &lhs, simd_pack const &rhs) { \
+        return from_vector(lhs.m_data op rhs.m_data);                                     \
+    }                                                                                     \
+    GT_FORCE_INLINE simd_pack &operator op##=(simd_pack const &rhs) {                     \
+        m_data = m_data op rhs.m_data;                                                    \
+        return *this;                                                                     \
+    }
+        GT_SIMD_PACK_BINARY_OPERATOR(+)
+        GT_SIMD_PACK_BINARY_OPERATOR(-)
+        GT_SIMD_PACK_BINARY_OPERATOR(*)
+        GT_SIMD_PACK_BINARY_OPERATOR(/)
+#undef GT_SIMD_PACK_BINARY_OPERATOR
+
+#define GT_SIMD_PACK_COMPARISON_OPERATOR(op)                                                    \
+    GT_FORCE_INLINE friend simd_mask<N> operator op(simd_pack const &lhs, simd_pack const &rhs) { \
+        simd_mask<N> res;                                                                       \
+        for (int_t lane = 0; lane < N; ++lane)                                                  \
+            res[lane] = lhs.m_data[lane] op rhs.m_data[lane];                                   \
+        return res;                                                                             \
+    }
+        GT_SIMD_PACK_COMPARISON_OPERATOR(<)
+        GT_SIMD_PACK_COMPARISON_OPERATOR(<=)
+        GT_SIMD_PACK_COMPARISON_OPERATOR(>)
+        GT_SIMD_PACK_COMPARISON_OPERATOR(>=)
+        GT_SIMD_PACK_COMPARISON_OPERATOR(==)
+        GT_SIMD_PACK_COMPARISON_OPERATOR(!=)
+#undef GT_SIMD_PACK_COMPARISON_OPERATOR
+
+        /**
+         * @brief Lane-wise application of a unary function.
+         */
+        template <class F>
+        GT_FORCE_INLINE friend simd_pack transform(F const &f, simd_pack const &value) {
+            simd_pack res;
+            for (int_t lane = 0; lane < N; ++lane)
+                res.m_data[lane] = f(value.m_data[lane]);
+            return res;
+        }
+
+        /**
+         * @brief Lane-wise application of a binary function.
+         */
+        template <class F>
+        GT_FORCE_INLINE friend simd_pack transform(F const &f, simd_pack const &lhs, simd_pack const &rhs) {
+            simd_pack res;
+            for (int_t lane = 0; lane < N; ++lane)
+                res.m_data[lane] = f(lhs.m_data[lane], rhs.m_data[lane]);
+            return res;
+        }
+
+        GT_FORCE_INLINE friend simd_pack select(simd_mask<N> const &mask, simd_pack const &lhs, simd_pack const &rhs) {
+            simd_pack res;
+            for (int_t lane = 0; lane < N; ++lane)
+                res.m_data[lane] = mask[lane] ? lhs.m_data[lane] : rhs.m_data[lane];
+            return res;
+        }
+    };
+
+    /**
+     * @brief Scalar version of the lane-wise selection, such that functors can be written for scalars and packs.
+     */
+    template <class T, class U>
+    GT_FUNCTION std::common_type_t<T, U> select(bool condition, T const &lhs, U const &rhs) {
+        return condition ? lhs : rhs;
+    }
+
+    namespace math {
+        template <class T, int_t N>
+        GT_FORCE_INLINE simd_pack<T, N> max(simd_pack<T, N> const &lhs, simd_pack<T, N> const &rhs) {
+            return select(lhs > rhs, lhs, rhs);
+        }
+        template <class T, int_t N>
+        GT_FORCE_INLINE simd_pack<T, N> max(simd_pack<T, N> const &lhs, typename simd_pack<T, N>::value_type rhs) {
+            return max(lhs, simd_pack<T, N>(rhs));
+        }
+        template <class T, int_t N>
+        GT_FORCE_INLINE simd_pack<T, N> max(typename simd_pack<T, N>::value_type lhs, simd_pack<T, N> const &rhs) {
+            return max(simd_pack<T, N>(lhs), rhs);
+        }
+
+        template <class T, int_t N>
+        GT_FORCE_INLINE simd_pack<T, N> min(simd_pack<T, N> const &lhs, simd_pack<T, N> const &rhs) {
+            return select(lhs < rhs, lhs, rhs);
+        }
+        template <class T, int_t N>
+        GT_FORCE_INLINE simd_pack<T, N> min(simd_pack<T, N> const &lhs, typename simd_pack<T, N>::value_type rhs) {
+            return min(lhs, simd_pack<T, N>(rhs));
+        }
+        template <class T, int_t N>
+        GT_FORCE_INLINE simd_pack<T, N> min(typename simd_pack<T, N>::value_type lhs, simd_pack<T, N> const &rhs) {
+            return min(simd_pack<T, N>(lhs), rhs);
+        }
+
+        template <class T, int_t N>
+        GT_FORCE_INLINE simd_pack<T, N> fabs(simd_pack<T, N> const &value) {
+            return select(value < T(0), -value, value);
+        }
+
+        template <class T, int_t N>
+        GT_FORCE_INLINE simd_pack<T, N> abs(simd_pack<T, N> const &value) {
+            return select(value < T(0), -value, value);
+        }
+
+        template <class T, int_t N>
+        GT_FORCE_INLINE simd_pack<T, N> sqrt(simd_pack<T, N> const &value) {
+            return transform([](T x) { return std::sqrt(x); }, value);
+        }
+
+        template <class T, int_t N>
+        GT_FORCE_INLINE simd_pack<T, N> exp(simd_pack<T, N> const &value) {
+            return transform([](T x) { return std::exp(x); }, value);
+        }
+
+        template <class T, int_t N>
+        GT_FORCE_INLINE simd_pack<T, N> log(simd_pack<T, N> const &value) {
+            return transform([](T x) { return std::log(x); }, value);
+        }
+
+        template <class T, int_t N>
+        GT_FORCE_INLINE simd_pack<T, N> pow(simd_pack<T, N> const &base, simd_pack<T, N> const &exponent) {
+            return transform([](T x, T y) { return std::pow(x, y); }, base, exponent);
+        }
+    } // namespace math
+} // namespace gridtools
@@ -274,6 +274,33 @@ namespace gridtools {
         */
         pattern_type const &pattern() const { return hd.pattern(); }
 
+        /**
+           Selects whether the pattern sends the messages with persistent MPI requests, see
+           Halo_Exchange_3D::set_persistent_requests. Must not be called while an exchange is in progress.
+        */
+        void set_persistent_requests(bool enable) { hd.m_haloexch.set_persistent_requests(enable); }
+
+        /**
+           Selects whether the pattern exchanges the messages with a single neighborhood collective, see
+           Halo_Exchange_3D::set_neighbor_collectives. Must be called by all the processes, not while an exchange is
+           in progress.
+        */
+        void set_neighbor_collectives(bool enable) { hd.m_haloexch.set_neighbor_collectives(enable); }
+
+        /**
+           Selects how the halos are moved between the fields and the messages (only available for gcl_cpu), see
+           hndlr_dynamic_ut::set_exchange_mode.
+        */
+        void set_exchange_mode(halo_exchange_mode mode, std::size_t min_run_bytes = 1024) {
+            hd.set_exchange_mode(mode, min_run_bytes);
+        }
+
+        /**
+           Selects whether the halos are exchanged through shared memory with the neighbors running on the same node
+           (only available for gcl_cpu), see Halo_Exchange_3D::setup_shared_memory. Must be called before setup.
+        */
+        void set_shared_memory(bool enable) { hd.set_shared_memory(enable); }
+
         /**
            Function to setup internal data structures for data exchange and preparing eventual underlying layers
 
@@ -14,6 +14,7 @@
 #include "../../common/make_array.hpp"
 #include "../low_level/Halo_Exchange_3D.hpp"
 #include "../low_level/proc_grids_3D.hpp"
+#include <algorithm>
 #include <vector>
 
 #include "../../common/boollist.hpp"
@@ -24,6 +25,7 @@
 #include "descriptors_fwd.hpp"
 #include "empty_field_base.hpp"
 #include "gcl_parameters.hpp"
+#include "halo_region.hpp"
 #include "helpers_impl.hpp"
 
 namespace gridtools {
@@ -62,74 +64,28 @@ namespace gridtools {
 
         const halo_descriptor *raw_array() const { return &(base_type::halos[0]); }
 
+        /**
+           Packs the halo of `field_ptr` to be sent to the neighbor eta at the position pointed by `it`, which points
+           to the next free position at the end of the operation.
+        */
         template <typename iterator_in, typename iterator_out>
         void pack(gridtools::array<int, 3> const &eta, iterator_in const *field_ptr, iterator_out *&it) const {
-            // std::cout << "BASE ADDR IN PACK " << std::hex << reinterpret_cast<void*>(it) << std::dec << std::endl;
-            // std::cout << "k=" << base_type::halos[2].loop_low_bound_inside(eta[2])
-            //           << " to <= " << base_type::halos[2].loop_high_bound_inside(eta[2]) << ",\n"
-            //           << "j=" << base_type::halos[1].loop_low_bound_inside(eta[1])
-            //           << " to <= " << base_type::halos[1].loop_high_bound_inside(eta[1]) << ",\n"
-            //           << "i=" << base_type::halos[0].loop_low_bound_inside(eta[0])
-            //           << " to <= " << base_type::halos[0].loop_high_bound_inside(eta[0])
-            //           << std::endl;
-            for (int k = halos[2].loop_low_bound_inside(eta[2]); k <= halos[2].loop_high_bound_inside(eta[2]); ++k) {
-                for (int j = halos[1].loop_low_bound_inside(eta[1]); j <= halos[1].loop_high_bound_inside(eta[1]);
-                     ++j) {
-                    for (int i = halos[0].loop_low_bound_inside(eta[0]); i <= halos[0].loop_high_bound_inside(eta[0]);
-                         ++i) {
-
-                        // std::cout << "      "
-                        //           << i << ", "
-                        //           << j << ", "
-                        //           << k << ", "
-                        //           << base_type::halos[0].total_length() << ", "
-                        //           << base_type::halos[1].total_length() << ", "
-                        //           << base_type::halos[2].total_length() << ", "
-                        //           << field_ptr[gridtools::access
-                        //                        (i,j,k,
-                        //                         base_type::halos[0].total_length(),
-                        //                         base_type::halos[1].total_length(),
-                        //                         base_type::halos[2].total_length())]
-                        //           << std::endl;
-
-                        *(reinterpret_cast<iterator_in *>(it)) = field_ptr[gridtools::access(
-                            i, j, k, halos[0].total_length(), halos[1].total_length(), halos[2].total_length())];
-                        reinterpret_cast<char *&>(it) += sizeof(iterator_in);
-                    }
-                }
-            }
+            auto region = _impl::make_halo_region<true>(halos, eta);
+            auto *buffer = reinterpret_cast<iterator_in *>(it);
+            _impl::pack_rows(region, field_ptr, buffer, 0, region.rows());
+            it = reinterpret_cast<iterator_out *>(buffer + region.size());
         }
 
+        /**
+           Unpacks the halo received from the neighbor eta into `field_ptr` from the position pointed by `it`, which
+           points to the next element to be read at the end of the operation.
+        */
         template <typename iterator_in, typename iterator_out>
         void unpack(gridtools::array<int, 3> const &eta, iterator_in *field_ptr, iterator_out *&it) const {
-            // std::cout << "k=" << base_type::halos[2].loop_low_bound_outside(eta[2])
-            //           << " to <= " << base_type::halos[2].loop_high_bound_outside(eta[2]) << ",\n"
-            //           << "j=" << base_type::halos[1].loop_low_bound_outside(eta[1])
-            //           << " to <= " << base_type::halos[1].loop_high_bound_outside(eta[1]) << ",\n"
-            //           << "i=" << base_type::halos[0].loop_low_bound_outside(eta[0])
-            //           << " to <= " << base_type::halos[0].loop_high_bound_outside(eta[0])
-            //           << std::endl;
-            for (int k = halos[2].loop_low_bound_outside(eta[2]); k <= halos[2].loop_high_bound_outside(eta[2]); ++k) {
-                for (int j = halos[1].loop_low_bound_outside(eta[1]); j <= halos[1].loop_high_bound_outside(eta[1]);
-                     ++j) {
-                    for (int i = halos[0].loop_low_bound_outside(eta[0]); i <= halos[0].loop_high_bound_outside(eta[0]);
-                         ++i) {
-                        // std::cout << "      "
-                        //           << i << ", "
-                        //           << j << ", "
-                        //           << k << ", "
-                        //           << base_type::halos[0].total_length() << ", "
-                        //           << base_type::halos[1].total_length() << ", "
-                        //           << base_type::halos[2].total_length() << ", "
-                        //           << *(reinterpret_cast<iterator_in*>(it))
-                        //           << std::endl;
-                        field_ptr[gridtools::access(
-                            i, j, k, halos[0].total_length(), halos[1].total_length(), halos[2].total_length())] =
-                            *(reinterpret_cast<iterator_in *>(it));
-                        reinterpret_cast<char *&>(it) += sizeof(iterator_in);
-                    }
-                }
-            }
+            auto region = _impl::make_halo_region<false>(halos, eta);
+            auto const *buffer = reinterpret_cast<iterator_in const *>(it);
+            _impl::unpack_rows(region, buffer, field_ptr, 0, region.rows());
+            it = reinterpret_cast<iterator_out *>(const_cast<iterator_in *>(buffer + region.size()));
         }
 
         template <typename iterator>
@@ -400,6 +356,18 @@ namespace gridtools {
         friend class _impl::unpack_service<this_type>;
     };
 
+    /**
+       How the CPU halo exchange moves the halos between the fields and the messages.
+    */
+    enum class halo_exchange_mode {
+        // halos are packed into and unpacked from communication buffers (the default)
+        packing,
+        // halos are sent from and received into the fields directly using MPI derived datatypes
+        datatypes,
+        // datatypes for the neighbors whose halo regions consist of long enough contiguous runs, packing otherwise
+        automatic
+    };
+
     /**
         Class containing the description of one halo and a communication
         pattern.  A communication is triggered when a list of data
@@ -426,6 +394,72 @@ namespace gridtools {
         gridtools::array<DataType *, _impl::static_pow3<DIMS>::value> recv_buffer;
         array<int, _impl::static_pow3<DIMS>::value> send_size;
         array<int, _impl::static_pow3<DIMS>::value> recv_size;
+        mutable _impl::halo_copy_tasks<DataType> m_copy_tasks;
+
+        halo_exchange_mode m_mode = halo_exchange_mode::packing;
+        std::size_t m_min_run_bytes = 1024;
+        _impl::compute_type<DataType> m_element_type;
+        // datatypes of the halos of m_typed_fields, MPI_DATATYPE_NULL if not used or not yet created
+        array<MPI_Datatype, _impl::static_pow3<DIMS>::value> m_send_types = null_datatypes();
+        array<MPI_Datatype, _impl::static_pow3<DIMS>::value> m_recv_types = null_datatypes();
+        std::vector<void const *> m_typed_fields;
+        // true for the neighbors whose data is received directly into the fields by the last pack
+        array<bool, _impl::static_pow3<DIMS>::value> m_recv_typed = {};
+
+        bool m_shared_memory = false;
+        // true for the receive buffers allocated in the shared memory window of the pattern
+        array<bool, _impl::static_pow3<DIMS>::value> m_recv_shared = {};
+
+        static array<MPI_Datatype, _impl::static_pow3<DIMS>::value> null_datatypes() {
+            array<MPI_Datatype, _impl::static_pow3<DIMS>::value> res;
+            for (auto &t : res)
+                t = MPI_DATATYPE_NULL;
+            return res;
+        }
+
+        bool use_datatype(_impl::halo_region const &region) const {
+            switch (m_mode) {
+            case halo_exchange_mode::packing:
+                return false;
+            case halo_exchange_mode::datatypes:
+                return region.size() > 0;
+            case halo_exchange_mode::automatic:
+                return region.size() > 0 && region.run * sizeof(DataType) >= m_min_run_bytes;
+            }
+            return false;
+        }
+
+        /**
+           Frees the datatypes if they have been created for other fields. The buffers are registered again for the
+           neighbors using datatypes, so that the pattern notices the change even if MPI reuses the handles.
+        */
+        template <typename Fields>
+        void select_typed_fields(Fields const &fields) {
+            if (m_typed_fields.size() == fields.size() &&
+                std::equal(fields.begin(), fields.end(), m_typed_fields.begin()))
+                return;
+            free_datatypes();
+            m_typed_fields.assign(fields.begin(), fields.end());
+        }
+
+        void free_datatypes() {
+            for (int i = -1; i <= 1; ++i) {
+                for (int j = -1; j <= 1; ++j) {
+                    for (int k = -1; k <= 1; ++k) {
+                        const int idx = translate()(i, j, k);
+                        if (m_send_types[idx] != MPI_DATATYPE_NULL) {
+                            base_type::m_haloexch.register_send_to_buffer(send_buffer[idx], 0, i, j, k);
+                            MPI_Type_free(&m_send_types[idx]);
+                        }
+                        if (m_recv_types[idx] != MPI_DATATYPE_NULL) {
+                            base_type::m_haloexch.register_receive_from_buffer(recv_buffer[idx], 0, i, j, k);
+                            MPI_Type_free(&m_recv_types[idx]);
+                        }
+                    }
+                }
+            }
+            m_typed_fields.clear();
+        }
 
       public:
         typedef gcl_cpu arch_type;
@@ -460,6 +494,10 @@ namespace gridtools {
 #ifdef GCL_CHECK_DESTRUCTOR
             std::cout << "Destructor " << __FILE__ << ":" << __LINE__ << std::endl;
 #endif
+            int finalized;
+            MPI_Finalized(&finalized);
+            if (!finalized)
+                free_datatypes();
 
             _destroy_dynamic_ut<DIMS, 0>().do_it(this);
         }
@@ -489,7 +527,11 @@ namespace gridtools {
 
            \param max_fields_n Maximum number of data fields that will be passed to the communication functions
         */
-        void setup(int max_fields_n) { _impl::allocation_service<this_type>()(this, max_fields_n); }
+        void setup(int max_fields_n) {
+            _impl::allocation_service<this_type>()(this, max_fields_n);
+            if (m_shared_memory)
+                setup_shared_memory();
+        }
 
 #ifdef GCL_TRACE
         void set_pattern_tag(int tag) { base_type::m_haloexch.set_pattern_tag(tag); };
@@ -502,7 +544,7 @@ namespace gridtools {
         */
         template <typename... FIELDS>
         void pack(const FIELDS &... _fields) {
-            pack_dims<DIMS, 0>()(*this, _fields...);
+            pack_dims<DIMS, 0>()(*this, std::vector<DataType const *>{_fields...});
         }
 
         /**
@@ -512,7 +554,7 @@ namespace gridtools {
         */
         template <typename... FIELDS>
         void unpack(const FIELDS &... _fields) const {
-            unpack_dims<DIMS, 0>()(*this, _fields...);
+            unpack_dims<DIMS, 0>()(*this, std::vector<DataType *>{_fields...});
         }
 
         /**
@@ -520,14 +562,39 @@ namespace gridtools {
 
            \param[in] fields vector with data fields pointers to be packed from
         */
-        void pack(std::vector<DataType *> const &fields) { pack_vector_dims<DIMS, 0>()(*this, fields); }
+        void pack(std::vector<DataType *> const &fields) { pack_dims<DIMS, 0>()(*this, fields); }
 
         /**
            Function to unpack received data
 
            \param[in] fields vector with data fields pointers to be unpacked into
         */
-        void unpack(std::vector<DataType *> const &fields) { unpack_vector_dims<DIMS, 0>()(*this, fields); }
+        void unpack(std::vector<DataType *> const &fields) { unpack_dims<DIMS, 0>()(*this, fields); }
+
+        /**
+           Selects how the halos are moved between the fields and the messages, see halo_exchange_mode.
+
+           With datatypes, the halos are received directly into the fields passed to pack, hence pack must be called
+           before the receives are posted and unpack must be called with the same fields. The datatypes are created
+           in the first pack and reused as long as the same fields are passed.
+
+           \param[in] mode The exchange mode
+           \param[in] min_run_bytes Minimal size in bytes of the contiguous runs of a halo region for which automatic
+           mode uses datatypes
+        */
+        void set_exchange_mode(halo_exchange_mode mode, std::size_t min_run_bytes = 1024) {
+            free_datatypes();
+            m_mode = mode;
+            m_min_run_bytes = min_run_bytes;
+        }
+
+        halo_exchange_mode exchange_mode() const { return m_mode; }
+
+        /**
+           Selects whether the halos are exchanged through shared memory with the neighbors running on the same
+           node, see Halo_Exchange_3D::setup_shared_memory. Must be called before setup.
+        */
+        void set_shared_memory(bool enable) { m_shared_memory = enable; }
 
         /// Utilities
 
@@ -548,77 +615,46 @@ namespace gridtools {
         // friend class _impl::unpack_service<this_type>;
 
       private:
-        template <int I, int dummy>
-        struct pack_dims {};
-
-        template <int dummy>
-        struct pack_dims<3, dummy> {
-            template <typename T, typename... FIELDS>
-            void operator()(T &hm, const FIELDS &... _fields) const {
-#pragma omp parallel for schedule(dynamic, 1) collapse(3)
-                for (int ii = -1; ii <= 1; ++ii) {
-                    for (int jj = -1; jj <= 1; ++jj) {
-                        for (int kk = -1; kk <= 1; ++kk) {
-                            typedef proc_layout map_type;
-                            const int ii_P = make_array(ii, jj, kk)[map_type::template at<0>()];
-                            const int jj_P = make_array(ii, jj, kk)[map_type::template at<1>()];
-                            const int kk_P = make_array(ii, jj, kk)[map_type::template at<2>()];
-                            if ((ii != 0 || jj != 0 || kk != 0) &&
-                                (hm.pattern().proc_grid().proc(ii_P, jj_P, kk_P) != -1)) {
-                                DataType *it = &(hm.send_buffer[translate()(ii, jj, kk)][0]);
-                                hm.halo.pack_all(make_array(ii, jj, kk), it, _fields...);
-
-                                hm.m_haloexch.set_send_to_size(
-                                    hm.send_size[translate()(ii, jj, kk)] * sizeof...(_fields) * sizeof(DataType),
-                                    ii_P,
-                                    jj_P,
-                                    kk_P);
-                                hm.m_haloexch.set_receive_from_size(
-                                    hm.recv_size[translate()(ii, jj, kk)] * sizeof...(_fields) * sizeof(DataType),
-                                    ii_P,
-                                    jj_P,
-                                    kk_P);
-                            }
-                        }
-                    }
-                }
-            }
-        };
-
-        template <int I, int dummy>
-        struct unpack_dims {};
-
-        template <int dummy>
-        struct unpack_dims<3, dummy> {
-            template <typename T, typename... FIELDS>
-            void operator()(const T &hm, const FIELDS &... _fields) const {
-#pragma omp parallel for schedule(dynamic, 1) collapse(3)
-                for (int ii = -1; ii <= 1; ++ii) {
-                    for (int jj = -1; jj <= 1; ++jj) {
-                        for (int kk = -1; kk <= 1; ++kk) {
-                            typedef proc_layout map_type;
-                            const int ii_P = make_array(ii, jj, kk)[map_type::template at<0>()];
-                            const int jj_P = make_array(ii, jj, kk)[map_type::template at<1>()];
-                            const int kk_P = make_array(ii, jj, kk)[map_type::template at<2>()];
-                            if ((ii != 0 || jj != 0 || kk != 0) &&
-                                (hm.pattern().proc_grid().proc(ii_P, jj_P, kk_P) != -1)) {
-                                DataType *it = &(hm.recv_buffer[translate()(ii, jj, kk)][0]);
-                                hm.halo.unpack_all(make_array(ii, jj, kk), it, _fields...);
-                            }
-                        }
+        /**
+           Moves the receive buffers of the neighbors on the same node into the shared memory window.
+        */
+        void setup_shared_memory() {
+            base_type::m_haloexch.setup_shared_memory();
+            for (int ii = -1; ii <= 1; ++ii) {
+                for (int jj = -1; jj <= 1; ++jj) {
+                    for (int kk = -1; kk <= 1; ++kk) {
+                        typedef proc_layout map_type;
+                        const int ii_P = make_array(ii, jj, kk)[map_type::template at<0>()];
+                        const int jj_P = make_array(ii, jj, kk)[map_type::template at<1>()];
+                        const int kk_P = make_array(ii, jj, kk)[map_type::template at<2>()];
+                        const int idx = translate()(ii, jj, kk);
+                        void *p = base_type::m_haloexch.shared_receive_buffer(ii_P, jj_P, kk_P);
+                        if (!(ii || jj || kk) || !p)
+                            continue;
+                        _impl::gcl_alloc<DataType, arch_type>::free(recv_buffer[idx]);
+                        recv_buffer[idx] = static_cast<DataType *>(p);
+                        m_recv_shared[idx] = true;
+                        base_type::m_haloexch.register_receive_from_buffer(
+                            p, base_type::m_haloexch.recv_size(ii_P, jj_P, kk_P), ii_P, jj_P, kk_P);
                     }
                 }
             }
-        };
+        }
 
+        /**
+           The copies of all fields and neighbors are collected first and then executed in parallel, see
+           _impl::halo_copy_tasks.
+        */
         template <int I, int dummy>
-        struct pack_vector_dims {};
+        struct pack_dims {};
 
         template <int dummy>
-        struct pack_vector_dims<3, dummy> {
-            template <typename T>
-            void operator()(T &hm, std::vector<DataType *> const &fields) const {
-#pragma omp parallel for schedule(dynamic, 1) collapse(3)
+        struct pack_dims<3, dummy> {
+            template <typename T, typename Fields>
+            void operator()(T &hm, Fields const &fields) const {
+                hm.m_copy_tasks.clear();
+                if (hm.m_mode != halo_exchange_mode::packing)
+                    hm.select_typed_fields(fields);
                 for (int ii = -1; ii <= 1; ++ii) {
                     for (int jj = -1; jj <= 1; ++jj) {
                         for (int kk = -1; kk <= 1; ++kk) {
@@ -628,36 +664,58 @@ namespace gridtools {
                             const int kk_P = make_array(ii, jj, kk)[map_type::template at<2>()];
                             if ((ii != 0 || jj != 0 || kk != 0) &&
                                 (hm.pattern().proc_grid().proc(ii_P, jj_P, kk_P) != -1)) {
-                                DataType *it = &(hm.send_buffer[translate()(ii, jj, kk)][0]);
-                                for (size_t i = 0; i < fields.size(); ++i) {
-                                    hm.halo.pack(make_array(ii, jj, kk), fields[i], it);
+                                const auto eta = make_array(ii, jj, kk);
+                                const int idx = translate()(ii, jj, kk);
+
+                                auto send_region = _impl::make_halo_region<true>(hm.halo.halos, eta);
+                                if (hm.use_datatype(send_region)) {
+                                    if (hm.m_send_types[idx] == MPI_DATATYPE_NULL)
+                                        hm.m_send_types[idx] = _impl::make_fields_datatype<true>(
+                                            hm.halo.halos, eta, hm.m_element_type.value, fields);
+                                    hm.m_haloexch.register_send_to_datatype(
+                                        MPI_BOTTOM, hm.m_send_types[idx], ii_P, jj_P, kk_P);
+                                } else {
+                                    DataType *it = hm.send_buffer[idx];
+                                    for (std::size_t i = 0; i < fields.size(); ++i)
+                                        it = hm.m_copy_tasks.add_pack(send_region, fields[i], it);
+                                    hm.m_haloexch.register_send_to_buffer(hm.send_buffer[idx],
+                                        hm.send_size[idx] * fields.size() * sizeof(DataType),
+                                        ii_P,
+                                        jj_P,
+                                        kk_P);
                                 }
 
-                                hm.m_haloexch.set_send_to_size(
-                                    hm.send_size[translate()(ii, jj, kk)] * fields.size() * sizeof(DataType),
-                                    ii_P,
-                                    jj_P,
-                                    kk_P);
-                                hm.m_haloexch.set_receive_from_size(
-                                    hm.recv_size[translate()(ii, jj, kk)] * fields.size() * sizeof(DataType),
-                                    ii_P,
-                                    jj_P,
-                                    kk_P);
+                                auto recv_region = _impl::make_halo_region<false>(hm.halo.halos, eta);
+                                hm.m_recv_typed[idx] = hm.use_datatype(recv_region);
+                                if (hm.m_recv_typed[idx]) {
+                                    if (hm.m_recv_types[idx] == MPI_DATATYPE_NULL)
+                                        hm.m_recv_types[idx] = _impl::make_fields_datatype<false>(
+                                            hm.halo.halos, eta, hm.m_element_type.value, fields);
+                                    hm.m_haloexch.register_receive_from_datatype(
+                                        MPI_BOTTOM, hm.m_recv_types[idx], ii_P, jj_P, kk_P);
+                                } else {
+                                    hm.m_haloexch.register_receive_from_buffer(hm.recv_buffer[idx],
+                                        hm.recv_size[idx] * fields.size() * sizeof(DataType),
+                                        ii_P,
+                                        jj_P,
+                                        kk_P);
+                                }
                             }
                         }
                     }
                 }
+                hm.m_copy_tasks.pack();
             }
         };
 
         template <int I, int dummy>
-        struct unpack_vector_dims {};
+        struct unpack_dims {};
 
         template <int dummy>
-        struct unpack_vector_dims<3, dummy> {
-            template <typename T>
-            void operator()(const T &hm, std::vector<DataType *> const &fields) const {
-#pragma omp parallel for schedule(dynamic, 1) collapse(3)
+        struct unpack_dims<3, dummy> {
+            template <typename T, typename Fields>
+            void operator()(const T &hm, Fields const &fields) const {
+                hm.m_copy_tasks.clear();
                 for (int ii = -1; ii <= 1; ++ii) {
                     for (int jj = -1; jj <= 1; ++jj) {
                         for (int kk = -1; kk <= 1; ++kk) {
@@ -667,14 +725,17 @@ namespace gridtools {
                             const int kk_P = make_array(ii, jj, kk)[map_type::template at<2>()];
                             if ((ii != 0 || jj != 0 || kk != 0) &&
                                 (hm.pattern().proc_grid().proc(ii_P, jj_P, kk_P) != -1)) {
-                                DataType *it = &(hm.recv_buffer[translate()(ii, jj, kk)][0]);
-                                for (size_t i = 0; i < fields.size(); ++i) {
-                                    hm.halo.unpack(make_array(ii, jj, kk), fields[i], it);
-                                }
+                                if (hm.m_recv_typed[translate()(ii, jj, kk)])
+                                    continue;
+                                auto region = _impl::make_halo_region<false>(hm.halo.halos, make_array(ii, jj, kk));
+                                DataType const *it = hm.recv_buffer[translate()(ii, jj, kk)];
+                                for (std::size_t i = 0; i < fields.size(); ++i)
+                                    it = hm.m_copy_tasks.add_unpack(region, it, fields[i]);
                             }
                         }
                     }
                 }
+                hm.m_copy_tasks.unpack();
             }
         };
 
@@ -689,7 +750,8 @@ namespace gridtools {
                     for (int j = -1; j <= 1; ++j) {
                         for (int k = -1; k <= 1; ++k) {
                             _impl::gcl_alloc<DataType, arch_type>::free(hm->send_buffer[translate()(i, j, k)]);
-                            _impl::gcl_alloc<DataType, arch_type>::free(hm->recv_buffer[translate()(i, j, k)]);
+                            if (!hm->m_recv_shared[translate()(i, j, k)])
+                                _impl::gcl_alloc<DataType, arch_type>::free(hm->recv_buffer[translate()(i, j, k)]);
                         }
                     }
                 }
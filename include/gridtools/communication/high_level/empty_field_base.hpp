@@ -9,6 +9,9 @@
  */
 #pragma once
 
+#include <vector>
+
+#include "../../common/array.hpp"
 #include "../../common/boollist.hpp"
 #include "../../common/halo_descriptor.hpp"
 #include "../../common/ndloops.hpp"
@@ -80,6 +83,50 @@ namespace gridtools {
             }
         };
 
+        /**
+           Datatype describing the halo region of the neighbor eta in all the fields, inside the fields for sends and
+           outside for receives. The datatype uses absolute addresses and must be used with MPI_BOTTOM. Returns
+           MPI_DATATYPE_NULL if the region is empty.
+        */
+        template <bool Inside, typename Fields>
+        MPI_Datatype make_fields_datatype(array<halo_descriptor, 3> const &halo,
+            array<int, 3> const &eta,
+            MPI_Datatype element,
+            Fields const &fields) {
+            int sizes[3], subsizes[3], starts[3];
+            for (int i = 0; i < 3; ++i) {
+                const int first =
+                    Inside ? halo[i].loop_low_bound_inside(eta[i]) : halo[i].loop_low_bound_outside(eta[i]);
+                const int last =
+                    Inside ? halo[i].loop_high_bound_inside(eta[i]) : halo[i].loop_high_bound_outside(eta[i]);
+                if (last < first)
+                    return MPI_DATATYPE_NULL;
+                sizes[i] = halo[i].total_length();
+                subsizes[i] = last - first + 1;
+                starts[i] = first;
+            }
+
+            MPI_Datatype region;
+            MPI_Type_create_subarray(3,
+                sizes,
+                subsizes,
+                starts,
+                MPI_ORDER_FORTRAN, // increasing strides
+                element,
+                &region);
+
+            std::vector<int> blocks(fields.size(), 1);
+            std::vector<MPI_Aint> displacements(fields.size());
+            for (std::size_t i = 0; i < fields.size(); ++i)
+                MPI_Get_address(fields[i], &displacements[i]);
+
+            MPI_Datatype res;
+            MPI_Type_create_hindexed(fields.size(), blocks.data(), displacements.data(), region, &res);
+            MPI_Type_commit(&res);
+            MPI_Type_free(&region);
+            return res;
+        }
+
         template <typename Array>
         int neigh_idx(Array const &tuple) {
             int idx = 0;
@@ -0,0 +1,168 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "../../common/array.hpp"
+#include "../../common/halo_descriptor.hpp"
+
+/**@file
+ * @brief Copy engine used to pack and unpack halos of CPU fields.
+ *
+ * The halo descriptors of the communication patterns are given in increasing stride order (the halo of the stride-1
+ * dimension first), hence the strides of a field follow from the total lengths of the descriptors. A halo region is
+ * described as rows of contiguous elements: dimensions which are entirely covered by the region are merged into the
+ * rows, so that, e.g., the halo of a face normal to the largest stride is a single row. Rows are copied with
+ * `std::copy_n`, which turns into a `memmove` for trivially copyable types.
+ */
+namespace gridtools {
+    namespace _impl {
+        /**
+         * @brief Elements of a field in a halo region, stored as `rows()` rows of `run` contiguous elements.
+         *
+         * The rows are enumerated with the first outer dimension running fastest, which is the order of the elements
+         * in the communication buffers.
+         */
+        struct halo_region {
+            std::ptrdiff_t offset = 0; // offset of the first element of the region in the field
+            std::ptrdiff_t run = 0;    // number of contiguous elements in a row
+            array<std::ptrdiff_t, 2> count = {{1, 1}};
+            array<std::ptrdiff_t, 2> stride = {{0, 0}};
+
+            std::ptrdiff_t rows() const { return run ? count[0] * count[1] : 0; }
+            std::ptrdiff_t size() const { return rows() * run; }
+
+            std::ptrdiff_t row_offset(std::ptrdiff_t row) const {
+                return offset + row % count[0] * stride[0] + row / count[0] * stride[1];
+            }
+        };
+
+        /**
+         * @brief Region of the elements sent to (`Inside == true`) or received from (`Inside == false`) the neighbor
+         * identified by eta (see \link MULTI_DIM_ACCESS \endlink).
+         */
+        template <bool Inside>
+        halo_region make_halo_region(array<halo_descriptor, 3> const &halos, array<int, 3> const &eta) {
+            array<std::ptrdiff_t, 3> length, stride;
+            halo_region res;
+            std::ptrdiff_t s = 1;
+            for (int d = 0; d < 3; ++d) {
+                const int first =
+                    Inside ? halos[d].loop_low_bound_inside(eta[d]) : halos[d].loop_low_bound_outside(eta[d]);
+                const int last =
+                    Inside ? halos[d].loop_high_bound_inside(eta[d]) : halos[d].loop_high_bound_outside(eta[d]);
+                if (last < first)
+                    return res;
+                length[d] = last - first + 1;
+                stride[d] = s;
+                res.offset += first * s;
+                s *= halos[d].total_length();
+            }
+
+            int d = 0;
+            res.run = 1;
+            // a dimension can be merged into the rows as long as the rows span the whole field in the lower dimensions
+            for (; d < 3 && res.run == stride[d]; ++d)
+                res.run *= length[d];
+            for (int c = 0; d < 3; ++c, ++d) {
+                res.count[c] = length[d];
+                res.stride[c] = stride[d];
+            }
+            return res;
+        }
+
+        template <typename T>
+        void pack_rows(
+            halo_region const &region, T const *field, T *buffer, std::ptrdiff_t first_row, std::ptrdiff_t last_row) {
+            for (std::ptrdiff_t row = first_row; row < last_row; ++row)
+                std::copy_n(field + region.row_offset(row), region.run, buffer + row * region.run);
+        }
+
+        template <typename T>
+        void unpack_rows(
+            halo_region const &region, T const *buffer, T *field, std::ptrdiff_t first_row, std::ptrdiff_t last_row) {
+            for (std::ptrdiff_t row = first_row; row < last_row; ++row)
+                std::copy_n(buffer + row * region.run, region.run, field + region.row_offset(row));
+        }
+
+        /**
+         * @brief List of halo copies between fields and communication buffers, executed in parallel.
+         *
+         * Large regions are split into chunks of rows, so that the threads share the work within the faces and not
+         * only across neighbors and fields.
+         */
+        template <typename T>
+        class halo_copy_tasks {
+            // number of elements copied by a task, if the rows are short enough
+            static constexpr std::ptrdiff_t chunk_size = 1 << 14;
+
+            struct task {
+                halo_region region;
+                T *field;
+                T *buffer;
+                std::ptrdiff_t first_row;
+                std::ptrdiff_t last_row;
+            };
+
+            std::vector<task> m_tasks;
+
+            void add(halo_region const &region, T *field, T *buffer) {
+                const std::ptrdiff_t rows = region.rows();
+                if (!rows)
+                    return;
+                const std::ptrdiff_t chunk_rows = std::max(chunk_size / region.run, std::ptrdiff_t(1));
+                for (std::ptrdiff_t first = 0; first < rows; first += chunk_rows)
+                    m_tasks.push_back({region, field, buffer, first, std::min(first + chunk_rows, rows)});
+            }
+
+          public:
+            void clear() { m_tasks.clear(); }
+
+            /**
+             * @brief Adds the copy of `region` of `field` into `buffer`, returns the end of the packed data.
+             */
+            T *add_pack(halo_region const &region, T const *field, T *buffer) {
+                // the field is only read by `pack`
+                add(region, const_cast<T *>(field), buffer);
+                return buffer + region.size();
+            }
+
+            /**
+             * @brief Adds the copy of `buffer` into `region` of `field`, returns the end of the unpacked data.
+             */
+            T const *add_unpack(halo_region const &region, T const *buffer, T *field) {
+                // the buffer is only read by `unpack`
+                add(region, field, const_cast<T *>(buffer));
+                return buffer + region.size();
+            }
+
+            void pack() const {
+                const int n = m_tasks.size();
+#pragma omp parallel for schedule(dynamic, 1)
+                for (int t = 0; t < n; ++t) {
+                    task const &tk = m_tasks[t];
+                    pack_rows<T>(tk.region, tk.field, tk.buffer, tk.first_row, tk.last_row);
+                }
+            }
+
+            void unpack() const {
+                const int n = m_tasks.size();
+#pragma omp parallel for schedule(dynamic, 1)
+                for (int t = 0; t < n; ++t) {
+                    task const &tk = m_tasks[t];
+                    unpack_rows<T>(tk.region, tk.buffer, tk.field, tk.first_row, tk.last_row);
+                }
+            }
+        };
+    } // namespace _impl
+} // namespace gridtools
@@ -9,6 +9,10 @@
  */
 #pragma once
 
+#include <cstring>
+#include <memory>
+#include <vector>
+
 #ifdef GT_VERBOSE
 #include <iostream>
 #endif
@@ -17,6 +21,8 @@
 #include "../../common/gt_assert.hpp"
 #include "../GCL.hpp"
 #include "has_communicator.hpp"
+#include "intra_node_window.hpp"
+#include "neighbor_collective.hpp"
 #include "translate.hpp"
 
 /** \file
@@ -153,70 +159,31 @@ namespace gridtools {
         typedef translate_t<3, typename default_layout_map<3>::type> translate;
 
         class sr_buffers {
-            char *m_buffers[27]; // there is ona buffer more to allow for a simple indexing
-            int m_size[27];      // Sizes in bytes
+            char *m_buffers[27];      // there is ona buffer more to allow for a simple indexing
+            int m_size[27];           // Sizes in bytes
+            MPI_Datatype m_types[27]; // MPI_DATATYPE_NULL for messages of m_size bytes
           public:
             explicit sr_buffers() {
-                m_buffers[0] = nullptr;
-                m_buffers[1] = nullptr;
-                m_buffers[2] = nullptr;
-                m_buffers[3] = nullptr;
-                m_buffers[4] = nullptr;
-                m_buffers[5] = nullptr;
-                m_buffers[6] = nullptr;
-                m_buffers[7] = nullptr;
-                m_buffers[8] = nullptr;
-                m_buffers[9] = nullptr;
-                m_buffers[10] = nullptr;
-                m_buffers[11] = nullptr;
-                m_buffers[12] = nullptr;
-                m_buffers[13] = nullptr;
-                m_buffers[14] = nullptr;
-                m_buffers[15] = nullptr;
-                m_buffers[16] = nullptr;
-                m_buffers[17] = nullptr;
-                m_buffers[18] = nullptr;
-                m_buffers[19] = nullptr;
-                m_buffers[20] = nullptr;
-                m_buffers[21] = nullptr;
-                m_buffers[22] = nullptr;
-                m_buffers[23] = nullptr;
-                m_buffers[24] = nullptr;
-                m_buffers[25] = nullptr;
-                m_buffers[26] = nullptr;
-
-                m_size[0] = 0;
-                m_size[1] = 0;
-                m_size[2] = 0;
-                m_size[3] = 0;
-                m_size[4] = 0;
-                m_size[5] = 0;
-                m_size[6] = 0;
-                m_size[7] = 0;
-                m_size[8] = 0;
-                m_size[9] = 0;
-                m_size[10] = 0;
-                m_size[11] = 0;
-                m_size[12] = 0;
-                m_size[13] = 0;
-                m_size[14] = 0;
-                m_size[15] = 0;
-                m_size[16] = 0;
-                m_size[17] = 0;
-                m_size[18] = 0;
-                m_size[19] = 0;
-                m_size[20] = 0;
-                m_size[21] = 0;
-                m_size[22] = 0;
-                m_size[23] = 0;
-                m_size[24] = 0;
-                m_size[25] = 0;
-                m_size[26] = 0;
+                for (int i = 0; i < 27; ++i) {
+                    m_buffers[i] = nullptr;
+                    m_size[i] = 0;
+                    m_types[i] = MPI_DATATYPE_NULL;
+                }
             }
 
             char *&buffer(int I, int J, int K) { return m_buffers[translate()(I, J, K)]; }
             int &size(int I, int J, int K) { return m_size[translate()(I, J, K)]; }
             int size(int I, int J, int K) const { return m_size[translate()(I, J, K)]; }
+            MPI_Datatype &type(int I, int J, int K) { return m_types[translate()(I, J, K)]; }
+
+            // count and datatype of the message
+            int mpi_count(int I, int J, int K) const {
+                return m_types[translate()(I, J, K)] == MPI_DATATYPE_NULL ? m_size[translate()(I, J, K)] : 1;
+            }
+            MPI_Datatype mpi_type(int I, int J, int K) const {
+                MPI_Datatype t = m_types[translate()(I, J, K)];
+                return t == MPI_DATATYPE_NULL ? MPI_CHAR : t;
+            }
         };
 
         template <int I, int J, int K>
@@ -224,6 +191,8 @@ namespace gridtools {
             static const int value = (K + 1) * 9 + (I + 1) * 3 + J + 1;
         };
 
+        static int tag(int I, int J, int K) { return (K + 1) * 9 + (I + 1) * 3 + J + 1; }
+
         struct request_t {
             MPI_Request request[27];
             MPI_Request &operator()(int i, int j, int k) { return request[translate()(i, j, k)]; }
@@ -249,11 +218,217 @@ namespace gridtools {
         request_t request;
         request_t_mark send_request;
 
+        /**
+           Persistent requests for all receives or all sends of the pattern, see set_persistent_requests. The
+           requests are created on the first start after a change of the buffers and are not copied with the
+           pattern.
+        */
+        struct persistent_requests_t {
+            std::vector<MPI_Request> requests;
+            bool dirty = true;
+            bool active = false;
+
+            persistent_requests_t() = default;
+            persistent_requests_t(persistent_requests_t const &) {}
+            persistent_requests_t &operator=(persistent_requests_t const &) {
+                free();
+                return *this;
+            }
+            ~persistent_requests_t() {
+                int finalized;
+                MPI_Finalized(&finalized);
+                if (!finalized)
+                    free();
+            }
+
+            void free() {
+                if (active)
+                    MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+                for (auto &r : requests)
+                    MPI_Request_free(&r);
+                requests.clear();
+                dirty = true;
+                active = false;
+            }
+        };
+
+        bool m_persistent;
+        persistent_requests_t m_persistent_recv;
+        persistent_requests_t m_persistent_send;
+
+        // see setup_shared_memory, shared by the copies of the pattern
+        std::shared_ptr<_impl::intra_node_window> m_shared;
+        // messages received from or sent to the neighbors through m_shared in the current exchange
+        bool m_shared_recv[27] = {};
+        bool m_shared_send[27] = {};
+
+        // see set_neighbor_collectives
+        std::shared_ptr<_impl::neighbor_collective> m_neighbor;
+
         const PROC_GRID /*&*/ m_proc_grid;
 
+        void build_persistent_receives() {
+            m_persistent_recv.free();
+            for (int i = -1; i <= 1; ++i)
+                for (int j = -1; j <= 1; ++j)
+                    for (int k = -1; k <= 1; ++k)
+                        if ((i || j || k) && m_proc_grid.proc(i, j, k) != -1 && m_recv_buffers.size(i, j, k) &&
+                            !m_shared_recv[translate()(i, j, k)]) {
+                            m_persistent_recv.requests.emplace_back();
+                            MPI_Recv_init(m_recv_buffers.buffer(i, j, k),
+                                m_recv_buffers.mpi_count(i, j, k),
+                                m_recv_buffers.mpi_type(i, j, k),
+                                m_proc_grid.proc(i, j, k),
+                                tag(-i, -j, -k),
+                                get_communicator(m_proc_grid),
+                                &m_persistent_recv.requests.back());
+                        }
+            m_persistent_recv.dirty = false;
+        }
+
+        void build_persistent_sends() {
+            m_persistent_send.free();
+            for (int i = -1; i <= 1; ++i)
+                for (int j = -1; j <= 1; ++j)
+                    for (int k = -1; k <= 1; ++k)
+                        if ((i || j || k) && m_proc_grid.proc(i, j, k) != -1 && m_send_buffers.size(i, j, k) &&
+                            !m_shared_send[translate()(i, j, k)]) {
+                            m_persistent_send.requests.emplace_back();
+                            MPI_Send_init(m_send_buffers.buffer(i, j, k),
+                                m_send_buffers.mpi_count(i, j, k),
+                                m_send_buffers.mpi_type(i, j, k),
+                                m_proc_grid.proc(i, j, k),
+                                tag(i, j, k),
+                                get_communicator(m_proc_grid),
+                                &m_persistent_send.requests.back());
+                        }
+            m_persistent_send.dirty = false;
+        }
+
+        void start_persistent(persistent_requests_t &requests) {
+            assert(!requests.active);
+            if (!requests.requests.empty())
+                MPI_Startall(requests.requests.size(), requests.requests.data());
+            requests.active = true;
+        }
+
+        void wait_persistent(persistent_requests_t &requests) {
+            if (!requests.active)
+                return;
+            MPI_Waitall(requests.requests.size(), requests.requests.data(), MPI_STATUSES_IGNORE);
+            requests.active = false;
+        }
+
+        static void update(sr_buffers &buffers,
+            int I,
+            int J,
+            int K,
+            char *new_buffer,
+            int new_size,
+            MPI_Datatype new_type,
+            persistent_requests_t &requests) {
+            if (buffers.buffer(I, J, K) != new_buffer || buffers.size(I, J, K) != new_size ||
+                buffers.type(I, J, K) != new_type)
+                requests.dirty = true;
+            buffers.buffer(I, J, K) = new_buffer;
+            buffers.size(I, J, K) = new_size;
+            buffers.type(I, J, K) = new_type;
+        }
+
+        /**
+           Announces the messages received through shared memory, which are those received into the buffers of the
+           window with their byte size, and waits for the processes of the node to do the same.
+        */
+        void post_shared_receives() {
+            for (int i = -1; i <= 1; ++i)
+                for (int j = -1; j <= 1; ++j)
+                    for (int k = -1; k <= 1; ++k) {
+                        const int n = translate()(i, j, k);
+                        const bool shared = (i || j || k) && m_recv_buffers.size(i, j, k) &&
+                                            m_recv_buffers.buffer(i, j, k) == m_shared->buffer(n) &&
+                                            m_recv_buffers.type(i, j, k) == MPI_DATATYPE_NULL &&
+                                            m_recv_buffers.size(i, j, k) <= m_shared->capacity(n);
+                        if (shared != m_shared_recv[n])
+                            m_persistent_recv.dirty = true;
+                        m_shared_recv[n] = shared;
+                        m_shared->expect(n, shared ? m_recv_buffers.size(i, j, k) : 0);
+                    }
+            m_shared->synchronize();
+        }
+
+        /**
+           Copies the messages to the neighbors expecting them through shared memory into their receive buffers.
+        */
+        void do_shared_sends() {
+            for (int i = -1; i <= 1; ++i)
+                for (int j = -1; j <= 1; ++j)
+                    for (int k = -1; k <= 1; ++k) {
+                        const int n = translate()(i, j, k);
+                        std::int64_t size = 0;
+                        char *dst = (i || j || k) && m_send_buffers.size(i, j, k)
+                                        ? m_shared->remote_buffer(n, translate()(-i, -j, -k), size)
+                                        : nullptr;
+                        if (bool(dst) != m_shared_send[n])
+                            m_persistent_send.dirty = true;
+                        m_shared_send[n] = dst;
+                        if (!dst)
+                            continue;
+                        if (m_send_buffers.type(i, j, k) == MPI_DATATYPE_NULL) {
+                            assert(m_send_buffers.size(i, j, k) <= size);
+                            std::memcpy(dst, m_send_buffers.buffer(i, j, k), m_send_buffers.size(i, j, k));
+                        } else {
+                            int position = 0;
+                            MPI_Pack(m_send_buffers.buffer(i, j, k),
+                                1,
+                                m_send_buffers.type(i, j, k),
+                                dst,
+                                size,
+                                &position,
+                                get_communicator(m_proc_grid));
+                        }
+                    }
+        }
+
+        /**
+           The edges of the neighborhood collective are the neighbors in the order of the loops below. The data
+           sent to neighbor (i, j, k) is received from neighbor (-i, -j, -k) of the destination, hence the sources
+           are listed in the opposite directions.
+        */
+        void build_neighbor_collective() {
+            std::vector<int> sources, destinations;
+            for (int i = -1; i <= 1; ++i)
+                for (int j = -1; j <= 1; ++j)
+                    for (int k = -1; k <= 1; ++k) {
+                        if ((i || j || k) && m_proc_grid.proc(i, j, k) != -1)
+                            destinations.push_back(m_proc_grid.proc(i, j, k));
+                        if ((i || j || k) && m_proc_grid.proc(-i, -j, -k) != -1)
+                            sources.push_back(m_proc_grid.proc(-i, -j, -k));
+                    }
+            m_neighbor = std::make_shared<_impl::neighbor_collective>(
+                get_communicator(m_proc_grid), sources, destinations);
+        }
+
+        void start_neighbor_collective() {
+            _impl::neighbor_collective::message recvs[26], sends[26];
+            int n_recvs = 0, n_sends = 0;
+            for (int i = -1; i <= 1; ++i)
+                for (int j = -1; j <= 1; ++j)
+                    for (int k = -1; k <= 1; ++k) {
+                        if ((i || j || k) && m_proc_grid.proc(i, j, k) != -1)
+                            sends[n_sends++] = {m_send_buffers.buffer(i, j, k),
+                                m_shared_send[translate()(i, j, k)] ? 0 : m_send_buffers.mpi_count(i, j, k),
+                                m_send_buffers.mpi_type(i, j, k)};
+                        if ((i || j || k) && m_proc_grid.proc(-i, -j, -k) != -1)
+                            recvs[n_recvs++] = {m_recv_buffers.buffer(-i, -j, -k),
+                                m_shared_recv[translate()(-i, -j, -k)] ? 0 : m_recv_buffers.mpi_count(-i, -j, -k),
+                                m_recv_buffers.mpi_type(-i, -j, -k)};
+                    }
+            m_neighbor->start(recvs, sends);
+        }
+
         template <int I, int J, int K>
         void post_receive() {
-            if (m_recv_buffers.size(I, J, K)) {
+            if (m_recv_buffers.size(I, J, K) && !m_shared_recv[translate()(I, J, K)]) {
 #ifdef GT_VERBOSE
                 std::cout << "@" << gridtools::PID << "@ IRECV (" << I << "," << J << "," << K << ") "
                           << " P " << m_proc_grid.template proc<I, J, K>() << " - "
@@ -267,8 +442,8 @@ namespace gridtools {
 #endif
 
                 MPI_Irecv(static_cast<char *>(m_recv_buffers.buffer(I, J, K)),
-                    m_recv_buffers.size(I, J, K),
-                    MPI_CHAR,
+                    m_recv_buffers.mpi_count(I, J, K),
+                    m_recv_buffers.mpi_type(I, J, K),
                     m_proc_grid.template proc<I, J, K>(),
                     TAG<-I, -J, -K>::value,
                     get_communicator(m_proc_grid),
@@ -288,7 +463,7 @@ namespace gridtools {
 
         template <int I, int J, int K>
         void perform_isend() {
-            if (m_send_buffers.size(I, J, K)) {
+            if (m_send_buffers.size(I, J, K) && !m_shared_send[translate()(I, J, K)]) {
 #ifdef GT_VERBOSE
                 std::cout << "@" << gridtools::PID << "@ ISEND (" << I << "," << J << "," << K << ") "
                           << " P " << m_proc_grid.template proc<I, J, K>() << " - "
@@ -302,8 +477,8 @@ namespace gridtools {
 #endif
 
                 MPI_Isend(static_cast<char *>(m_send_buffers.buffer(I, J, K)),
-                    m_send_buffers.size(I, J, K),
-                    MPI_CHAR,
+                    m_send_buffers.mpi_count(I, J, K),
+                    m_send_buffers.mpi_type(I, J, K),
                     m_proc_grid.template proc<I, J, K>(),
                     TAG<I, J, K>::value,
                     get_communicator(m_proc_grid),
@@ -351,7 +526,7 @@ namespace gridtools {
 
         template <int I, int J, int K>
         void wait() {
-            if (m_recv_buffers.size(I, J, K)) {
+            if (m_recv_buffers.size(I, J, K) && !m_shared_recv[translate()(I, J, K)]) {
 #ifdef GT_VERBOSE
                 std::cout << "@" << gridtools::PID << "@ WAIT  (" << I << "," << J << "," << K << ") "
                           << " R " << translate()(-I, -J, -K) << "\n";
@@ -398,7 +573,7 @@ namespace gridtools {
          *
          */
         explicit Halo_Exchange_3D(PROC_GRID /*const&*/ _pg)
-            : m_send_buffers(), m_recv_buffers(), request(), send_request(), m_proc_grid(_pg)
+            : m_send_buffers(), m_recv_buffers(), request(), send_request(), m_persistent(false), m_proc_grid(_pg)
 #ifdef GCL_TRACE
               ,
               pattern_tag(-1)
@@ -444,8 +619,7 @@ namespace gridtools {
 //                 << " (" << translate()(I,J,K) << ")\n";
 #endif
 
-            m_send_buffers.buffer(I, J, K) = reinterpret_cast<char *>(p);
-            m_send_buffers.size(I, J, K) = s;
+            update(m_send_buffers, I, J, K, reinterpret_cast<char *>(p), s, MPI_DATATYPE_NULL, m_persistent_send);
         }
 
         /** Function to register send buffers with the communication patter.
@@ -507,8 +681,7 @@ namespace gridtools {
 //                 <<  " (" << translate()(I,J,K) << ")\n";
 #endif
 
-            m_recv_buffers.buffer(I, J, K) = reinterpret_cast<char *>(p);
-            m_recv_buffers.size(I, J, K) = s;
+            update(m_recv_buffers, I, J, K, reinterpret_cast<char *>(p), s, MPI_DATATYPE_NULL, m_persistent_recv);
         }
 
         /** Function to register buffers for received data with the communication patter.
@@ -539,6 +712,47 @@ namespace gridtools {
             register_receive_from_buffer(p, s, I, J, K);
         }
 
+        /** Function to register a derived datatype describing the data to be sent to a neighbor.
+
+           The message consists of one element of type t at address p, which may be MPI_BOTTOM if t uses absolute
+           addresses. This allows to send data directly from the user fields. The datatype is used until another
+           buffer or datatype is registered for the same destination, and must not be freed before.
+
+           \param[in] p Address of the data described by the datatype
+           \param[in] t Committed MPI datatype
+           \param[in] I Relative coordinates of the receiving process along the first dimension
+           \param[in] J Relative coordinates of the receiving process along the second dimension
+           \param[in] K Relative coordinates of the receiving process along the third dimension
+        */
+        void register_send_to_datatype(void *p, MPI_Datatype t, int I, int J, int K) {
+            assert((I >= -1 && I <= 1));
+            assert((J >= -1 && J <= 1));
+            assert((K >= -1 && K <= 1));
+
+            int s;
+            MPI_Type_size(t, &s);
+            update(m_send_buffers, I, J, K, reinterpret_cast<char *>(p), s, t, m_persistent_send);
+        }
+
+        /** Function to register a derived datatype describing where to put the data received from a neighbor, see
+           register_send_to_datatype.
+
+           \param[in] p Address of the data described by the datatype
+           \param[in] t Committed MPI datatype
+           \param[in] I Relative coordinates of the sending process along the first dimension
+           \param[in] J Relative coordinates of the sending process along the second dimension
+           \param[in] K Relative coordinates of the sending process along the third dimension
+        */
+        void register_receive_from_datatype(void *p, MPI_Datatype t, int I, int J, int K) {
+            assert((I >= -1 && I <= 1));
+            assert((J >= -1 && J <= 1));
+            assert((K >= -1 && K <= 1));
+
+            int s;
+            MPI_Type_size(t, &s);
+            update(m_recv_buffers, I, J, K, reinterpret_cast<char *>(p), s, t, m_persistent_recv);
+        }
+
         /* Setting sizes */
 
         /** Function to set send buffers sizes if the size must be updated
@@ -561,7 +775,14 @@ namespace gridtools {
             assert((J >= -1 && J <= 1));
             assert((K >= -1 && K <= 1));
 
-            m_send_buffers.size(I, J, K) = s;
+            update(m_send_buffers,
+                I,
+                J,
+                K,
+                m_send_buffers.buffer(I, J, K),
+                s,
+                m_send_buffers.type(I, J, K),
+                m_persistent_send);
         }
 
         /** Function to set send buffers sizes if the size must be updated
@@ -611,7 +832,14 @@ namespace gridtools {
             assert((J >= -1 && J <= 1));
             assert((K >= -1 && K <= 1));
 
-            m_recv_buffers.size(I, J, K) = s;
+            update(m_recv_buffers,
+                I,
+                J,
+                K,
+                m_recv_buffers.buffer(I, J, K),
+                s,
+                m_recv_buffers.type(I, J, K),
+                m_persistent_recv);
         }
 
         /** Function to set receive buffers sizes if the size must be
@@ -657,6 +885,89 @@ namespace gridtools {
         */
         int recv_size(int I, int J, int K) const { return m_recv_buffers.size(I, J, K); }
 
+        /** Selects whether the messages are sent with persistent requests.
+
+            Persistent requests (MPI_Recv_init/MPI_Send_init) are created for all neighbors on the first exchange and
+            started with a single MPI_Startall per direction afterwards, which reduces the MPI overhead of exchanges
+            of small halos. The requests are recreated when the pointer or the size of a buffer changes.
+
+            Must not be called while an exchange is in progress.
+
+            \param[in] enable true to use persistent requests, false for a nonblocking send and receive per
+            neighbor in each exchange (the default)
+        */
+        void set_persistent_requests(bool enable) {
+            if (!enable) {
+                m_persistent_recv.free();
+                m_persistent_send.free();
+            }
+            m_persistent = enable;
+        }
+
+        /** Returns true if the messages are sent with persistent requests, see set_persistent_requests.
+         */
+        bool persistent_requests() const { return m_persistent; }
+
+        /** Selects whether the messages are exchanged with a neighborhood collective.
+
+            A distributed graph communicator with the neighbors of the process grid as edges is created, and the
+            messages of an exchange are sent and received by a single MPI_Ineighbor_alltoallw, started in do_sends
+            and completed in wait; post_receives does not post any MPI receive. MPI libraries can then schedule all
+            the messages of the exchange together. The messages sent through shared memory (see
+            setup_shared_memory) are not affected, while persistent requests are not used in this mode.
+
+            Must be called by all the processes in the grid, and not while an exchange is in progress.
+
+            \param[in] enable true to use a neighborhood collective, false for point-to-point messages (the default)
+        */
+        void set_neighbor_collectives(bool enable) {
+            if (enable && !m_neighbor)
+                build_neighbor_collective();
+            else if (!enable)
+                m_neighbor.reset();
+        }
+
+        /** Returns true if the messages are exchanged with a neighborhood collective, see set_neighbor_collectives.
+         */
+        bool neighbor_collectives() const { return bool(m_neighbor); }
+
+        /** Sets up the transport through shared memory for the neighbors running on the same node.
+
+            An MPI-3 shared memory window is allocated among the processes of the node, with a receive buffer for
+            each neighbor on the node, of the size of the receive buffer currently registered for it. A message
+            received into such a buffer (see shared_receive_buffer) is copied by the sender directly into it, instead
+            of being sent with MPI. The messages from the other neighbors, or received elsewhere, keep using MPI.
+            The processes of the node synchronize when receives are posted and in wait.
+
+            Must be called by all the processes in the grid, after the receive buffers have been registered.
+        */
+        void setup_shared_memory() {
+            int neighbors[27], capacities[27];
+            for (int i = -1; i <= 1; ++i)
+                for (int j = -1; j <= 1; ++j)
+                    for (int k = -1; k <= 1; ++k) {
+                        neighbors[translate()(i, j, k)] = (i || j || k) ? m_proc_grid.proc(i, j, k) : -1;
+                        capacities[translate()(i, j, k)] = m_recv_buffers.size(i, j, k);
+                    }
+            m_shared = std::make_shared<_impl::intra_node_window>(
+                get_communicator(m_proc_grid), neighbors, capacities);
+        }
+
+        /** Returns true if setup_shared_memory has been called.
+         */
+        bool shared_memory() const { return bool(m_shared); }
+
+        /** Receive buffer in shared memory for the data received from neighbor I, J, K, nullptr if the neighbor
+            does not run on the same node or if setup_shared_memory has not been called.
+
+            \param[in] I Relative coordinates of the sending process along the first dimension
+            \param[in] J Relative coordinates of the sending process along the second dimension
+            \param[in] K Relative coordinates of the sending process along the third dimension
+        */
+        void *shared_receive_buffer(int I, int J, int K) const {
+            return m_shared ? m_shared->buffer(translate()(I, J, K)) : nullptr;
+        }
+
         /** When called this function executes the communication pattern,
             that is, send all the send-buffers to the correspondinf
             receive-buffers. When the function returns the data in receive
@@ -668,6 +979,20 @@ namespace gridtools {
         }
 
         void post_receives() {
+            if (m_shared)
+                post_shared_receives();
+
+            // the receives are posted together with the sends
+            if (m_neighbor)
+                return;
+
+            if (m_persistent) {
+                if (m_persistent_recv.dirty)
+                    build_persistent_receives();
+                start_persistent(m_persistent_recv);
+                return;
+            }
+
             /* Posting receives face -1
              */
             if (m_proc_grid.template proc<1, 0, -1>() != -1) {
@@ -786,6 +1111,21 @@ namespace gridtools {
         }
 
         void do_sends() {
+            if (m_shared)
+                do_shared_sends();
+
+            if (m_neighbor) {
+                start_neighbor_collective();
+                return;
+            }
+
+            if (m_persistent) {
+                if (m_persistent_send.dirty)
+                    build_persistent_sends();
+                start_persistent(m_persistent_send);
+                return;
+            }
+
             /* Sending data face -1
              */
             if (m_proc_grid.template proc<-1, 0, -1>() != -1) {
@@ -934,8 +1274,23 @@ namespace gridtools {
         }
 
         void wait() {
+            if (m_neighbor) {
+                m_neighbor->wait();
+            } else if (m_persistent) {
+                wait_persistent(m_persistent_send);
+                wait_persistent(m_persistent_recv);
+            } else {
+                wait_for_sends();
+                wait_receives();
+            }
+
+            // the messages sent through shared memory have arrived once all the processes of the node are here
+            if (m_shared)
+                m_shared->synchronize();
+        }
 
-            wait_for_sends();
+      private:
+        void wait_receives() {
 
             /* Actual receives face -1
              */
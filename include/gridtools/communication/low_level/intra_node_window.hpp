@@ -0,0 +1,160 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+
+#include "../GCL.hpp"
+
+namespace gridtools {
+    namespace _impl {
+        /**
+         * @brief MPI-3 shared memory window holding the receive buffers of the processes of a node for the messages
+         * coming from their neighbors on the same node.
+         *
+         * Every process of the node owns a part of the window, made of a header with one entry per neighbor and the
+         * receive buffers. Before each exchange, a receiver announces in its header the messages it expects through
+         * shared memory; the sender then copies such a message directly into the receive buffer instead of sending
+         * it with MPI. The accesses to the window are ordered by synchronize(), which is a barrier among the
+         * processes of the node.
+         *
+         * The neighbors are identified by an index in [0, 27), as given by the translate map of the pattern.
+         * Construction and destruction are collective over the communicator.
+         */
+        class intra_node_window {
+            static constexpr int n_neighbors = 27;
+            static constexpr std::int64_t alignment = 64;
+
+            struct slot {
+                std::int64_t offset;   // offset of the receive buffer from the part of the window of its owner
+                std::int64_t capacity; // size in bytes of the receive buffer, 0 if the neighbor is not on the node
+                std::int64_t size;     // size in bytes of the expected message, 0 if it is not sent through the window
+            };
+
+            MPI_Comm m_node_comm;
+            MPI_Win m_win;
+            slot *m_slots;
+            int m_node_rank[n_neighbors]; // rank in m_node_comm of each neighbor, -1 if not on the node
+            char *m_remote[n_neighbors];  // part of the window of each neighbor on the node
+
+            static std::int64_t aligned(std::int64_t size) { return (size + alignment - 1) / alignment * alignment; }
+
+          public:
+            /**
+             * @param comm Communicator of the pattern
+             * @param neighbors Ranks in comm of the neighbors, -1 if there is no neighbor
+             * @param capacities Sizes in bytes of the receive buffers for the messages from the neighbors
+             */
+            intra_node_window(MPI_Comm comm, int const *neighbors, int const *capacities) {
+                MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &m_node_comm);
+
+                MPI_Group group, node_group;
+                MPI_Comm_group(comm, &group);
+                MPI_Comm_group(m_node_comm, &node_group);
+                for (int n = 0; n < n_neighbors; ++n)
+                    m_node_rank[n] = MPI_UNDEFINED;
+                for (int n = 0; n < n_neighbors; ++n)
+                    if (neighbors[n] != -1)
+                        MPI_Group_translate_ranks(group, 1, &neighbors[n], node_group, &m_node_rank[n]);
+                MPI_Group_free(&group);
+                MPI_Group_free(&node_group);
+
+                std::int64_t size = aligned(n_neighbors * sizeof(slot));
+                for (int n = 0; n < n_neighbors; ++n) {
+                    if (m_node_rank[n] == MPI_UNDEFINED)
+                        m_node_rank[n] = -1;
+                    else
+                        size += aligned(capacities[n]);
+                    m_remote[n] = nullptr;
+                }
+
+                // each process places its part of the window in its own memory
+                MPI_Info info;
+                MPI_Info_create(&info);
+                MPI_Info_set(info, "alloc_shared_noncontig", "true");
+                MPI_Win_allocate_shared(size, 1, info, m_node_comm, &m_slots, &m_win);
+                MPI_Info_free(&info);
+
+                std::int64_t offset = aligned(n_neighbors * sizeof(slot));
+                for (int n = 0; n < n_neighbors; ++n) {
+                    m_slots[n].offset = offset;
+                    m_slots[n].capacity = m_node_rank[n] == -1 ? 0 : capacities[n];
+                    m_slots[n].size = 0;
+                    offset += aligned(m_slots[n].capacity);
+                    if (m_node_rank[n] != -1) {
+                        MPI_Aint remote_size;
+                        int disp_unit;
+                        MPI_Win_shared_query(m_win, m_node_rank[n], &remote_size, &disp_unit, &m_remote[n]);
+                    }
+                }
+
+                MPI_Win_lock_all(MPI_MODE_NOCHECK, m_win);
+                synchronize();
+            }
+
+            intra_node_window(intra_node_window const &) = delete;
+            intra_node_window &operator=(intra_node_window const &) = delete;
+
+            ~intra_node_window() {
+                int finalized;
+                MPI_Finalized(&finalized);
+                if (finalized)
+                    return;
+                MPI_Win_unlock_all(m_win);
+                MPI_Win_free(&m_win);
+                MPI_Comm_free(&m_node_comm);
+            }
+
+            /**
+             * @brief Receive buffer for the messages from neighbor n, nullptr if the neighbor is not on the node.
+             */
+            char *buffer(int n) const {
+                return m_slots[n].capacity ? reinterpret_cast<char *>(m_slots) + m_slots[n].offset : nullptr;
+            }
+
+            std::int64_t capacity(int n) const { return m_slots[n].capacity; }
+
+            /**
+             * @brief Announces the size of the message expected from neighbor n in the next exchange, 0 if it is
+             * received with MPI. Must be followed by synchronize() before the neighbors send.
+             */
+            void expect(int n, std::int64_t size) {
+                assert(size <= m_slots[n].capacity);
+                m_slots[n].size = size;
+            }
+
+            /**
+             * @brief Receive buffer in which the message to neighbor n is written, nullptr if the neighbor does not
+             * expect it through the window.
+             *
+             * @param n Index of the destination in the neighbors of the calling process
+             * @param remote_n Index of the calling process in the neighbors of the destination
+             * @param size Set to the size of the message expected by the destination
+             */
+            char *remote_buffer(int n, int remote_n, std::int64_t &size) const {
+                if (!m_remote[n])
+                    return nullptr;
+                slot const &s = reinterpret_cast<slot const *>(m_remote[n])[remote_n];
+                size = s.size;
+                return size ? m_remote[n] + s.offset : nullptr;
+            }
+
+            /**
+             * @brief Orders the accesses to the window of the processes of the node.
+             */
+            void synchronize() {
+                MPI_Win_sync(m_win);
+                MPI_Barrier(m_node_comm);
+                MPI_Win_sync(m_win);
+            }
+        };
+    } // namespace _impl
+} // namespace gridtools
@@ -0,0 +1,117 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <cassert>
+#include <vector>
+
+#include "../GCL.hpp"
+
+namespace gridtools {
+    namespace _impl {
+        /**
+         * @brief Exchange of one message per neighbor with a single nonblocking neighborhood collective.
+         *
+         * The neighbors are the edges of a distributed graph communicator. A process may appear several times among
+         * the sources and the destinations (e.g. in periodic grids with few processes), the k-th message sent by a
+         * process to another one is then received in the k-th source entry of the receiver for that process.
+         *
+         * The messages are given by absolute addresses, so that every neighbor can use its own buffer or datatype,
+         * and are exchanged with MPI_Ineighbor_alltoallw. Construction and destruction are collective over the
+         * communicator.
+         */
+        class neighbor_collective {
+          public:
+            struct message {
+                void *buffer;
+                int count;
+                MPI_Datatype type;
+            };
+
+          private:
+            MPI_Comm m_comm;
+            MPI_Request m_request = MPI_REQUEST_NULL;
+            std::vector<int> m_send_counts, m_recv_counts;
+            std::vector<MPI_Aint> m_send_displs, m_recv_displs;
+            std::vector<MPI_Datatype> m_send_types, m_recv_types;
+
+            static void set(message const &m, int &count, MPI_Aint &displ, MPI_Datatype &type) {
+                count = m.count;
+                type = m.type;
+                displ = 0;
+                if (m.count)
+                    MPI_Get_address(m.buffer, &displ);
+            }
+
+          public:
+            /**
+             * @param comm Communicator of the pattern
+             * @param sources Ranks in comm of the processes the messages are received from
+             * @param destinations Ranks in comm of the processes the messages are sent to
+             */
+            neighbor_collective(MPI_Comm comm, std::vector<int> const &sources, std::vector<int> const &destinations)
+                : m_send_counts(destinations.size()), m_recv_counts(sources.size()),
+                  m_send_displs(destinations.size()), m_recv_displs(sources.size()),
+                  m_send_types(destinations.size()), m_recv_types(sources.size()) {
+                MPI_Dist_graph_create_adjacent(comm,
+                    sources.size(),
+                    sources.data(),
+                    MPI_UNWEIGHTED,
+                    destinations.size(),
+                    destinations.data(),
+                    MPI_UNWEIGHTED,
+                    MPI_INFO_NULL,
+                    false,
+                    &m_comm);
+            }
+
+            neighbor_collective(neighbor_collective const &) = delete;
+            neighbor_collective &operator=(neighbor_collective const &) = delete;
+
+            ~neighbor_collective() {
+                int finalized;
+                MPI_Finalized(&finalized);
+                if (finalized)
+                    return;
+                wait();
+                MPI_Comm_free(&m_comm);
+            }
+
+            /**
+             * @brief Starts the exchange of the messages, given in the order of the sources and the destinations.
+             */
+            void start(message const *recvs, message const *sends) {
+                assert(m_request == MPI_REQUEST_NULL);
+                for (std::size_t n = 0; n < m_recv_counts.size(); ++n)
+                    set(recvs[n], m_recv_counts[n], m_recv_displs[n], m_recv_types[n]);
+                for (std::size_t n = 0; n < m_send_counts.size(); ++n)
+                    set(sends[n], m_send_counts[n], m_send_displs[n], m_send_types[n]);
+                MPI_Ineighbor_alltoallw(MPI_BOTTOM,
+                    m_send_counts.data(),
+                    m_send_displs.data(),
+                    m_send_types.data(),
+                    MPI_BOTTOM,
+                    m_recv_counts.data(),
+                    m_recv_displs.data(),
+                    m_recv_types.data(),
+                    m_comm,
+                    &m_request);
+            }
+
+            /**
+             * @brief Waits for the end of the exchange, if any.
+             */
+            void wait() {
+                if (m_request != MPI_REQUEST_NULL)
+                    MPI_Wait(&m_request, MPI_STATUS_IGNORE);
+            }
+        };
+    } // namespace _impl
+} // namespace gridtools
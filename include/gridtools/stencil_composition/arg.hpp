@@ -104,14 +104,15 @@ namespace gridtools {
         template <unsigned Id, typename T>
         struct tmp_storage_info;
 
-        template <template <unsigned, typename, typename, typename> class StorageInfo,
+        template <template <unsigned, typename, typename, typename, typename> class StorageInfo,
             unsigned Id,
             unsigned OldId,
             typename Layout,
             typename Halo,
-            typename Alignment>
-        struct tmp_storage_info<Id, StorageInfo<OldId, Layout, Halo, Alignment>> {
-            using type = StorageInfo<Id, Layout, Halo, Alignment>;
+            typename Alignment,
+            typename Padding>
+        struct tmp_storage_info<Id, StorageInfo<OldId, Layout, Halo, Alignment, Padding>> {
+            using type = StorageInfo<Id, Layout, Halo, Alignment, Padding>;
         };
 
         // replace the storage_info ID contained in a given storage with the new value
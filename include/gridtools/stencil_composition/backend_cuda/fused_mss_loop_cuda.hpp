@@ -32,7 +32,9 @@ namespace gridtools {
     }
 
     /**
-     * @brief determines whether ESFs should be fused in one single kernel execution or not for this backend.
+     * @brief determines whether the ESFs of an MSS should be fused in one single kernel execution or not for this
+     * backend.
      */
-    constexpr std::true_type mss_fuse_esfs(backend::cuda) { return {}; }
+    template <class Mss>
+    constexpr std::true_type mss_fuse_esfs(backend::cuda, Mss) { return {}; }
 } // namespace gridtools
@@ -0,0 +1,221 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+#include "../../common/defs.hpp"
+#include "../scheduler.hpp"
+#include "../structured_grids/backend_mc/execinfo_mc.hpp"
+
+/**@file
+ * @brief block size auto-tuning for the mc backend
+ */
+namespace gridtools {
+    namespace _impl_block_tuner_mc {
+        /**
+         * @brief FNV-1a hash, used to shorten the type names in the keys of the tuning cache.
+         *
+         * Unlike std::hash, the result is stable between runs and standard library implementations. The hashed names
+         * come from `typeid`, they depend on the compiler ABI, hence cache files are only reused by binaries built
+         * with the same compiler.
+         */
+        inline std::string hash(char const *str) {
+            std::uint64_t res = 14695981039346656037ull;
+            for (; *str; ++str)
+                res = (res ^ static_cast<unsigned char>(*str)) * 1099511628211ull;
+            std::ostringstream out;
+            out << std::hex << res;
+            return out.str();
+        }
+
+        /**
+         * @brief Candidate block sizes: the default ones and successive halvings of them.
+         *
+         * Only blocks that are not larger than the default ones are considered, as temporaries are allocated for those.
+         * The i-size is kept above 8 to not cripple vectorization.
+         */
+        inline std::vector<std::pair<int_t, int_t>> candidates(int_t i_block_size, int_t j_block_size) {
+            std::vector<int_t> is = {i_block_size};
+            while (is.size() < 4 && (is.back() + 1) / 2 >= 8)
+                is.push_back((is.back() + 1) / 2);
+            std::vector<int_t> js = {j_block_size};
+            while (js.size() < 4 && js.back() > 1)
+                js.push_back((js.back() + 1) / 2);
+            std::vector<std::pair<int_t, int_t>> res;
+            for (auto i : is)
+                for (auto j : js)
+                    res.emplace_back(i, j);
+            return res;
+        }
+    } // namespace _impl_block_tuner_mc
+
+    /**
+     * @brief Block size auto-tuner for the mc backend.
+     *
+     * Pass an instance to `make_computation<backend::mc>` to select it for a computation. The first runs of the
+     * computation are used to time candidate block sizes (`runs_per_candidate` runs each, the fastest one counts).
+     * The best candidate is used for all following runs and is stored in the tuning cache, keyed by the stencil type,
+     * the domain size and the number of threads. If a cache file is given, it is read on the first use and written
+     * whenever a tuning finishes, such that production runs start with the tuned block sizes. The file is replaced
+     * atomically, so it is never seen half written; concurrent writers do not lock it and may drop each other's
+     * latest entries.
+     * Copies share the tuning cache.
+     */
+    class block_tuner_mc {
+        struct tuning {
+            std::vector<std::pair<int_t, int_t>> m_candidates;
+            std::vector<double> m_times;
+            std::size_t m_current = 0;
+            int_t m_runs = 0;
+        };
+
+        struct state {
+            std::string m_file;
+            int_t m_runs_per_candidate;
+            bool m_loaded = false;
+            std::map<std::string, std::pair<int_t, int_t>> m_cache;
+            std::map<std::string, tuning> m_tunings;
+
+            static void read(std::string const &file, std::map<std::string, std::pair<int_t, int_t>> &dst) {
+                std::ifstream in(file);
+                std::string key;
+                int_t i, j;
+                while (in >> key >> i >> j)
+                    dst[key] = {i, j};
+            }
+
+            void load() {
+                if (m_loaded)
+                    return;
+                m_loaded = true;
+                if (!m_file.empty())
+                    read(m_file, m_cache);
+            }
+
+            void store() const {
+                if (m_file.empty())
+                    return;
+                // keep the entries other processes have added in the meantime
+                std::map<std::string, std::pair<int_t, int_t>> cache;
+                read(m_file, cache);
+                for (auto const &item : m_cache)
+                    cache[item.first] = item.second;
+                // write a file of this process and rename it, such that readers never see a partial file
+                const std::string tmp_file = m_file + "." + std::to_string(getpid()) + ".tmp";
+                {
+                    std::ofstream out(tmp_file);
+                    for (auto const &item : cache)
+                        out << item.first << " " << item.second.first << " " << item.second.second << "\n";
+                    out.close();
+                    if (!out) {
+                        std::remove(tmp_file.c_str());
+                        throw std::runtime_error("block_tuner_mc: cannot write the tuning cache file " + m_file);
+                    }
+                }
+                if (std::rename(tmp_file.c_str(), m_file.c_str()) != 0) {
+                    std::remove(tmp_file.c_str());
+                    throw std::runtime_error("block_tuner_mc: cannot write the tuning cache file " + m_file);
+                }
+            }
+        };
+
+        std::shared_ptr<state> m_state;
+
+      public:
+        explicit block_tuner_mc(std::string cache_file = {}, int_t runs_per_candidate = 2)
+            : m_state(std::make_shared<state>()) {
+            assert(runs_per_candidate > 0);
+            m_state->m_file = std::move(cache_file);
+            m_state->m_runs_per_candidate = runs_per_candidate;
+        }
+
+        /**
+         * @brief The key of the tuning cache for the given stencil type and grid.
+         */
+        template <class Key, class Grid>
+        static std::string key(Grid const &grid) {
+            std::ostringstream out;
+            out << _impl_block_tuner_mc::hash(typeid(Key).name()) << ":"
+                << grid.i_high_bound() - grid.i_low_bound() + 1 << "x" << grid.j_high_bound() - grid.j_low_bound() + 1
+                << "x" << grid.k_max() - grid.k_min() + 1 << ":" << omp_get_max_threads();
+            return out.str();
+        }
+
+        /**
+         * @brief The tuned block sizes (i, j) per key.
+         */
+        std::map<std::string, std::pair<int_t, int_t>> const &cache() const {
+            m_state->load();
+            return m_state->m_cache;
+        }
+
+        /**
+         * @brief Calls `f(exinfo)` with the blocks to be used for the stencil identified by Key on the given grid.
+         */
+        template <class Key, class Grid, class F>
+        void run(Grid const &grid, F const &f) const {
+            auto &s = *m_state;
+            s.load();
+
+            execinfo_mc default_exinfo(grid);
+            auto const k = key<Key>(grid);
+            auto found = s.m_cache.find(k);
+            if (found != s.m_cache.end() && found->second.first <= default_exinfo.i_block_size() &&
+                found->second.second <= default_exinfo.j_block_size()) {
+                f(execinfo_mc(grid, found->second.first, found->second.second));
+                return;
+            }
+
+            auto &t = s.m_tunings[k];
+            if (t.m_candidates.empty()) {
+                t.m_candidates =
+                    _impl_block_tuner_mc::candidates(default_exinfo.i_block_size(), default_exinfo.j_block_size());
+                t.m_times.assign(t.m_candidates.size(), std::numeric_limits<double>::max());
+            }
+
+            auto const &candidate = t.m_candidates[t.m_current];
+            const double start = omp_get_wtime();
+            f(execinfo_mc(grid, candidate.first, candidate.second));
+            t.m_times[t.m_current] = std::min(t.m_times[t.m_current], omp_get_wtime() - start);
+
+            if (++t.m_runs < s.m_runs_per_candidate)
+                return;
+            t.m_runs = 0;
+            if (++t.m_current < t.m_candidates.size())
+                return;
+            std::size_t best = 0;
+            for (std::size_t c = 1; c < t.m_candidates.size(); ++c)
+                if (t.m_times[c] < t.m_times[best])
+                    best = c;
+            s.m_cache[k] = t.m_candidates[best];
+            s.m_tunings.erase(k);
+            s.store();
+        }
+    };
+
+    template <>
+    struct is_scheduler<block_tuner_mc> : std::true_type {};
+} // namespace gridtools
@@ -9,7 +9,11 @@
  */
 #pragma once
 
+#include "../caches/cache_metafunctions.hpp"
 #include "../mss_functor.hpp"
+#include "./block_tuner_mc.hpp"
+#include "./thread_team_mc.hpp"
+#include "./work_stealing_mc.hpp"
 
 /**@file
  * @brief fused mss loop implementations for the mc backend
@@ -27,58 +31,164 @@ namespace gridtools {
          */
         template <typename Msses>
         using all_mss_kparallel = meta::all_of<is_mss_kparallel, Msses>;
+
+        /**
+         * @brief loops over all blocks and execute sequentially all mss functors for each block
+         */
+        template <class MssComponents,
+            class LocalDomainListArray,
+            class Grid,
+            std::enable_if_t<!all_mss_kparallel<MssComponents>::value, int> = 0>
+        void fused_mss_loop_mc_blocks(
+            LocalDomainListArray const &local_domain_lists, const Grid &grid, execinfo_mc const &exinfo) {
+            const int_t i_blocks = exinfo.i_blocks();
+            const int_t j_blocks = exinfo.j_blocks();
+#pragma omp parallel for collapse(2)
+            for (int_t bj = 0; bj < j_blocks; ++bj) {
+                for (int_t bi = 0; bi < i_blocks; ++bi) {
+                    run_mss_functors<MssComponents>(backend::mc{}, local_domain_lists, grid, exinfo.block(bi, bj));
+                }
+            }
+        }
+
+        /**
+         * @brief loops over all blocks and k-levels and execute sequentially all mss functors for each block
+         */
+        template <class MssComponents,
+            class LocalDomainListArray,
+            class Grid,
+            std::enable_if_t<all_mss_kparallel<MssComponents>::value, int> = 0>
+        void fused_mss_loop_mc_blocks(
+            LocalDomainListArray const &local_domain_lists, const Grid &grid, execinfo_mc const &exinfo) {
+            const int_t i_blocks = exinfo.i_blocks();
+            const int_t j_blocks = exinfo.j_blocks();
+            const int_t k_first = grid.k_min();
+            const int_t k_last = grid.k_max();
+#pragma omp parallel for collapse(3)
+            for (int_t bj = 0; bj < j_blocks; ++bj) {
+                for (int_t k = k_first; k <= k_last; ++k) {
+                    for (int_t bi = 0; bi < i_blocks; ++bi) {
+                        run_mss_functors<MssComponents>(
+                            backend::mc{}, local_domain_lists, grid, exinfo.block(bi, bj, k));
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief distributes the blocks with a scheduler that provides `run(tasks, f)` and executes sequentially all
+         * mss functors for each block
+         */
+        template <class MssComponents,
+            class LocalDomainListArray,
+            class Grid,
+            class Scheduler,
+            std::enable_if_t<!all_mss_kparallel<MssComponents>::value, int> = 0>
+        void fused_mss_loop_mc_tasks(LocalDomainListArray const &local_domain_lists,
+            const Grid &grid,
+            execinfo_mc const &exinfo,
+            Scheduler const &scheduler) {
+            const int_t i_blocks = exinfo.i_blocks();
+            const int_t j_blocks = exinfo.j_blocks();
+            scheduler.run(i_blocks * j_blocks, [&](int_t block) {
+                run_mss_functors<MssComponents>(
+                    backend::mc{}, local_domain_lists, grid, exinfo.block(block % i_blocks, block / i_blocks));
+            });
+        }
+
+        /**
+         * @brief distributes the blocks and k-levels with a scheduler that provides `run(tasks, f)` and executes
+         * sequentially all mss functors for each block
+         */
+        template <class MssComponents,
+            class LocalDomainListArray,
+            class Grid,
+            class Scheduler,
+            std::enable_if_t<all_mss_kparallel<MssComponents>::value, int> = 0>
+        void fused_mss_loop_mc_tasks(LocalDomainListArray const &local_domain_lists,
+            const Grid &grid,
+            execinfo_mc const &exinfo,
+            Scheduler const &scheduler) {
+            const int_t i_blocks = exinfo.i_blocks();
+            const int_t j_blocks = exinfo.j_blocks();
+            const int_t k_first = grid.k_min();
+            const int_t k_size = grid.k_max() - k_first + 1;
+            // same block order as the static schedule: i-blocks innermost, j-blocks outermost
+            scheduler.run(i_blocks * k_size * j_blocks, [&](int_t block) {
+                const int_t bi = block % i_blocks;
+                const int_t k = block / i_blocks % k_size + k_first;
+                const int_t bj = block / i_blocks / k_size;
+                run_mss_functors<MssComponents>(backend::mc{}, local_domain_lists, grid, exinfo.block(bi, bj, k));
+            });
+        }
     } // namespace _impl
 
     /**
      * @brief loops over all blocks and execute sequentially all mss functors for each block
      * @tparam MssComponents a meta array with the mss components of all MSS
      */
-    template <class MssComponents,
-        class LocalDomainListArray,
-        class Grid,
-        std::enable_if_t<!_impl::all_mss_kparallel<MssComponents>::value, int> = 0>
+    template <class MssComponents, class LocalDomainListArray, class Grid>
     void fused_mss_loop(backend::mc, LocalDomainListArray const &local_domain_lists, const Grid &grid) {
         GT_STATIC_ASSERT((meta::all_of<is_mss_components, MssComponents>::value), GT_INTERNAL_ERROR);
 
-        execinfo_mc exinfo(grid);
-        const int_t i_blocks = exinfo.i_blocks();
-        const int_t j_blocks = exinfo.j_blocks();
-#pragma omp parallel for collapse(2)
-        for (int_t bj = 0; bj < j_blocks; ++bj) {
-            for (int_t bi = 0; bi < i_blocks; ++bi) {
-                run_mss_functors<MssComponents>(backend::mc{}, local_domain_lists, grid, exinfo.block(bi, bj));
-            }
-        }
+        _impl::fused_mss_loop_mc_blocks<MssComponents>(local_domain_lists, grid, execinfo_mc(grid));
     }
 
     /**
-     * @brief loops over all blocks and execute sequentially all mss functors for each block
+     * @brief loops over the blocks chosen by the block tuner and execute sequentially all mss functors for each block
      * @tparam MssComponents a meta array with the mss components of all MSS
      */
-    template <class MssComponents,
-        class LocalDomainListArray,
-        class Grid,
-        std::enable_if_t<_impl::all_mss_kparallel<MssComponents>::value, int> = 0>
-    void fused_mss_loop(backend::mc, LocalDomainListArray const &local_domain_lists, const Grid &grid) {
+    template <class MssComponents, class LocalDomainListArray, class Grid>
+    void fused_mss_loop(
+        backend::mc, LocalDomainListArray const &local_domain_lists, const Grid &grid, block_tuner_mc const &tuner) {
         GT_STATIC_ASSERT((meta::all_of<is_mss_components, MssComponents>::value), GT_INTERNAL_ERROR);
 
-        execinfo_mc exinfo(grid);
-        const int_t i_blocks = exinfo.i_blocks();
-        const int_t j_blocks = exinfo.j_blocks();
-        const int_t k_first = grid.k_min();
-        const int_t k_last = grid.k_max();
-#pragma omp parallel for collapse(3)
-        for (int_t bj = 0; bj < j_blocks; ++bj) {
-            for (int_t k = k_first; k <= k_last; ++k) {
-                for (int_t bi = 0; bi < i_blocks; ++bi) {
-                    run_mss_functors<MssComponents>(backend::mc{}, local_domain_lists, grid, exinfo.block(bi, bj, k));
-                }
-            }
-        }
+        tuner.run<MssComponents>(grid, [&](execinfo_mc const &exinfo) {
+            _impl::fused_mss_loop_mc_blocks<MssComponents>(local_domain_lists, grid, exinfo);
+        });
+    }
+
+    /**
+     * @brief distributes the over-decomposed blocks with the work-stealing scheduler and executes sequentially all mss
+     * functors for each block
+     * @tparam MssComponents a meta array with the mss components of all MSS
+     */
+    template <class MssComponents, class LocalDomainListArray, class Grid>
+    void fused_mss_loop(backend::mc,
+        LocalDomainListArray const &local_domain_lists,
+        const Grid &grid,
+        work_stealing_mc const &scheduler) {
+        GT_STATIC_ASSERT((meta::all_of<is_mss_components, MssComponents>::value), GT_INTERNAL_ERROR);
+
+        _impl::fused_mss_loop_mc_tasks<MssComponents>(local_domain_lists,
+            grid,
+            execinfo_mc(grid, scheduler.over_decomposition() * omp_get_max_threads()),
+            scheduler);
+    }
+
+    /**
+     * @brief distributes the blocks over the persistent thread team and executes sequentially all mss functors for
+     * each block
+     * @tparam MssComponents a meta array with the mss components of all MSS
+     */
+    template <class MssComponents, class LocalDomainListArray, class Grid>
+    void fused_mss_loop(
+        backend::mc, LocalDomainListArray const &local_domain_lists, const Grid &grid, thread_team_mc const &team) {
+        GT_STATIC_ASSERT((meta::all_of<is_mss_components, MssComponents>::value), GT_INTERNAL_ERROR);
+        // temporaries are allocated for omp_get_max_threads() threads and for the blocks of the default decomposition
+        GT_ASSERT_OR_THROW(team.size() == omp_get_max_threads(),
+            "thread_team_mc: the team size must match omp_get_max_threads() when the computation is run");
+
+        _impl::fused_mss_loop_mc_tasks<MssComponents>(local_domain_lists, grid, execinfo_mc(grid), team);
     }
 
     /**
-     * @brief determines whether ESFs should be fused in one single kernel execution or not for this backend.
+     * @brief determines whether the ESFs of an MSS should be fused in one single kernel execution or not for this
+     * backend. Only k-serial MSSs with k-caches are fused, so that the cached values are passed between the stages
+     * in the ring buffers.
      */
-    std::false_type mss_fuse_esfs(backend::mc);
+    template <class Mss>
+    bool_constant<!_impl::is_mss_kparallel<Mss>::value &&
+                  !meta::is_empty<k_caches<typename Mss::cache_sequence_t>>::value>
+    mss_fuse_esfs(backend::mc, Mss);
 } // namespace gridtools
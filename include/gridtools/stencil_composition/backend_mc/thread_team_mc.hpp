@@ -0,0 +1,168 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../../common/defs.hpp"
+#include "../scheduler.hpp"
+
+/**@file
+ * @brief persistent thread team for the mc backend
+ */
+namespace gridtools {
+    namespace _impl_thread_team_mc {
+        /**
+         * @brief Index of the calling thread in the running thread team, -1 outside of a team.
+         */
+        inline int_t &member_index() {
+            thread_local int_t index = -1;
+            return index;
+        }
+
+        class team {
+            int_t m_size;
+            int_t m_spin_count;
+            std::vector<std::thread> m_workers;
+
+            // the current job: `m_invoke(m_job, member)` is executed by all members
+            void (*m_invoke)(void const *, int_t) = nullptr;
+            void const *m_job = nullptr;
+
+            std::atomic<std::size_t> m_generation{0};
+            std::atomic<int_t> m_done{0};
+            std::atomic<int_t> m_sleeping{0};
+            bool m_stop = false;
+            std::mutex m_mutex;
+            std::condition_variable m_wake;
+
+            // spins on the generation counter for a while and then falls asleep until it changes
+            std::size_t wait_for(std::size_t generation) {
+                for (int_t i = 0; i < m_spin_count; ++i) {
+                    std::size_t current = m_generation.load(std::memory_order_acquire);
+                    if (current != generation)
+                        return current;
+                }
+                std::unique_lock<std::mutex> lock(m_mutex);
+                ++m_sleeping;
+                m_wake.wait(lock, [&] { return m_generation.load() != generation; });
+                --m_sleeping;
+                return m_generation.load(std::memory_order_acquire);
+            }
+
+            void work(int_t member) {
+                member_index() = member;
+                std::size_t generation = 0;
+                while (true) {
+                    generation = wait_for(generation);
+                    if (m_stop)
+                        return;
+                    m_invoke(m_job, member);
+                    m_done.fetch_add(1, std::memory_order_release);
+                }
+            }
+
+            void start(void (*invoke)(void const *, int_t), void const *job) {
+                m_invoke = invoke;
+                m_job = job;
+                m_done.store(0, std::memory_order_relaxed);
+                m_generation.fetch_add(1);
+                if (m_sleeping.load()) {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_wake.notify_all();
+                }
+            }
+
+          public:
+            team(int_t size, int_t spin_count) : m_size(size), m_spin_count(spin_count) {
+                assert(size > 0);
+                for (int_t member = 1; member < size; ++member)
+                    m_workers.emplace_back([this, member] { work(member); });
+            }
+
+            ~team() {
+                m_stop = true;
+                start(nullptr, nullptr);
+                for (auto &worker : m_workers)
+                    worker.join();
+            }
+
+            int_t size() const { return m_size; }
+
+            template <class F>
+            void run(F const &f) {
+                assert(member_index() == -1);
+                start([](void const *job, int_t member) { (*static_cast<F const *>(job))(member); }, &f);
+                member_index() = 0;
+                f(0);
+                member_index() = -1;
+                for (int_t i = 0; m_done.load(std::memory_order_acquire) != m_size - 1; ++i)
+                    if (i >= m_spin_count)
+                        std::this_thread::yield();
+            }
+        };
+    } // namespace _impl_thread_team_mc
+
+    /**
+     * @brief Index of the calling thread among the threads that execute a computation on the mc backend.
+     *
+     * This is the index in the running `thread_team_mc` if there is one, the OpenMP thread number otherwise.
+     */
+    inline int_t thread_index_mc() {
+        const int_t member = _impl_thread_team_mc::member_index();
+        return member >= 0 ? member : omp_get_thread_num();
+    }
+
+    /**
+     * @brief Persistent team of threads for the mc backend.
+     *
+     * The threads are created once and wait for work by spinning, for `spin_count` iterations after a job before they
+     * fall asleep, such that consecutive launches avoid the fork/join cost of an OpenMP parallel region. The team has
+     * as many members as OpenMP threads, the calling thread being the first one. The blocks are distributed statically,
+     * as in the default OpenMP schedule.
+     * Pass an instance to `make_computation<backend::mc>` to select it for a computation. Copies share the threads,
+     * hence a team can be shared by several computations that are run from the same thread.
+     */
+    class thread_team_mc {
+        std::shared_ptr<_impl_thread_team_mc::team> m_team;
+
+      public:
+        explicit thread_team_mc(int_t spin_count = 1 << 20)
+            : m_team(std::make_shared<_impl_thread_team_mc::team>(omp_get_max_threads(), spin_count)) {}
+
+        int_t size() const { return m_team->size(); }
+
+        /**
+         * @brief Executes `f(task)` for all tasks in [0, tasks), every member executing a contiguous range of tasks.
+         */
+        template <class F>
+        void run(int_t tasks, F const &f) const {
+            const int_t size = m_team->size();
+            m_team->run([&](int_t member) {
+                const int_t chunk = tasks / size;
+                const int_t rest = tasks % size;
+                const int_t first = member * chunk + std::min(member, rest);
+                const int_t last = first + chunk + (member < rest);
+                for (int_t task = first; task < last; ++task)
+                    f(task);
+            });
+        }
+    };
+
+    template <>
+    struct is_scheduler<thread_team_mc> : std::true_type {};
+} // namespace gridtools
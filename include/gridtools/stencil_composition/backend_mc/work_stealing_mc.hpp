@@ -0,0 +1,211 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../../common/defs.hpp"
+#include "../scheduler.hpp"
+
+/**@file
+ * @brief work-stealing block scheduler for the mc backend
+ */
+namespace gridtools {
+    namespace _impl_work_stealing_mc {
+        /**
+         * @brief Contiguous range of task indices owned by a thread.
+         *
+         * The owner takes tasks from the front, thieves take the back half of the remaining ones.
+         * The queue is padded to a cache line to avoid false sharing between the threads.
+         */
+        struct task_queue {
+            std::atomic_flag m_lock = ATOMIC_FLAG_INIT;
+            int_t m_first = 0;
+            int_t m_last = 0;
+            char m_padding[64 - sizeof(std::atomic_flag) - 2 * sizeof(int_t)];
+
+            void lock() {
+                while (m_lock.test_and_set(std::memory_order_acquire))
+                    ;
+            }
+            void unlock() { m_lock.clear(std::memory_order_release); }
+
+            bool pop(int_t &task) {
+                lock();
+                bool res = m_first < m_last;
+                if (res)
+                    task = m_first++;
+                unlock();
+                return res;
+            }
+
+            void push(int_t first, int_t last) {
+                lock();
+                m_first = first;
+                m_last = last;
+                unlock();
+            }
+
+            bool steal(int_t &first, int_t &last) {
+                lock();
+                bool res = m_first < m_last;
+                if (res) {
+                    last = m_last;
+                    first = m_last - (m_last - m_first + 1) / 2;
+                    m_last = first;
+                }
+                unlock();
+                return res;
+            }
+        };
+    } // namespace _impl_work_stealing_mc
+
+    /**
+     * @brief Statistics collected by the work-stealing scheduler, accumulated over all runs until reset.
+     */
+    struct work_stealing_mc_stats {
+        struct thread_stats {
+            std::size_t tasks = 0;  /** Number of executed tasks (blocks). */
+            std::size_t steals = 0; /** Number of successful steals. */
+            double busy_time = 0;   /** Time spent in executing tasks [s]. */
+        };
+
+        std::size_t runs = 0;              /** Number of scheduled loops. */
+        double time = 0;                   /** Wall time of the scheduled loops [s]. */
+        std::vector<thread_stats> threads; /** Statistics per thread. */
+
+        std::size_t tasks() const {
+            std::size_t res = 0;
+            for (auto const &t : threads)
+                res += t.tasks;
+            return res;
+        }
+
+        std::size_t steals() const {
+            std::size_t res = 0;
+            for (auto const &t : threads)
+                res += t.steals;
+            return res;
+        }
+
+        double max_busy_time() const {
+            double res = 0;
+            for (auto const &t : threads)
+                res = std::max(res, t.busy_time);
+            return res;
+        }
+
+        /**
+         * @brief Ratio of the maximum to the average busy time of the threads (1 for a perfectly balanced load).
+         */
+        double imbalance() const {
+            double sum = 0;
+            for (auto const &t : threads)
+                sum += t.busy_time;
+            return sum > 0 ? max_busy_time() * threads.size() / sum : 1;
+        }
+
+        void reset() { *this = {}; }
+
+        std::string to_string() const {
+            std::ostringstream out;
+            out << "runs: " << runs << ", time: " << time << "s, tasks: " << tasks() << ", steals: " << steals()
+                << ", imbalance: " << imbalance() << "\n";
+            for (std::size_t i = 0; i < threads.size(); ++i)
+                out << "  thread " << i << ": tasks: " << threads[i].tasks << ", steals: " << threads[i].steals
+                    << ", busy: " << threads[i].busy_time << "s\n";
+            return out.str();
+        }
+    };
+
+    /**
+     * @brief Work-stealing block scheduler for the mc backend.
+     *
+     * Over-decomposes the domain into `over_decomposition` blocks per thread. Every thread starts on a contiguous range
+     * of blocks and steals half of the remaining blocks of another thread when it runs out of work.
+     * Pass an instance to `make_computation<backend::mc>` to select it for a computation. Copies share the statistics,
+     * hence the instance passed to `make_computation` can be used to query them.
+     */
+    class work_stealing_mc {
+        int_t m_over_decomposition;
+        std::shared_ptr<work_stealing_mc_stats> m_stats;
+
+      public:
+        explicit work_stealing_mc(int_t over_decomposition = 4)
+            : m_over_decomposition(over_decomposition), m_stats(std::make_shared<work_stealing_mc_stats>()) {
+            assert(over_decomposition > 0);
+        }
+
+        int_t over_decomposition() const { return m_over_decomposition; }
+
+        work_stealing_mc_stats const &stats() const { return *m_stats; }
+
+        void reset_stats() const { m_stats->reset(); }
+
+        /**
+         * @brief Executes `f(task)` for all tasks in [0, tasks) distributed over all threads.
+         */
+        template <class F>
+        void run(int_t tasks, F const &f) const {
+            using namespace _impl_work_stealing_mc;
+            const int_t threads = omp_get_max_threads();
+
+            // queues of threads that do not show up in the parallel region are emptied by stealing
+            std::unique_ptr<task_queue[]> queues(new task_queue[threads]);
+            for (int_t t = 0; t < threads; ++t)
+                queues[t].push(tasks * t / threads, tasks * (t + 1) / threads);
+
+            auto &stats = *m_stats;
+            if (stats.threads.size() < (std::size_t)threads)
+                stats.threads.resize(threads);
+
+            const double start = omp_get_wtime();
+#pragma omp parallel
+            {
+                const int_t thread = omp_get_thread_num();
+                task_queue &own = queues[thread];
+                work_stealing_mc_stats::thread_stats local;
+                int_t task;
+                while (true) {
+                    if (!own.pop(task)) {
+                        int_t first, last;
+                        int_t victim = (thread + 1) % threads;
+                        for (; victim != thread && !queues[victim].steal(first, last); victim = (victim + 1) % threads)
+                            ;
+                        if (victim == thread)
+                            break;
+                        own.push(first, last);
+                        ++local.steals;
+                        continue;
+                    }
+                    const double task_start = omp_get_wtime();
+                    f(task);
+                    local.busy_time += omp_get_wtime() - task_start;
+                    ++local.tasks;
+                }
+                stats.threads[thread].tasks += local.tasks;
+                stats.threads[thread].steals += local.steals;
+                stats.threads[thread].busy_time += local.busy_time;
+            }
+            stats.time += omp_get_wtime() - start;
+            ++stats.runs;
+        }
+    };
+
+    template <>
+    struct is_scheduler<work_stealing_mc> : std::true_type {};
+} // namespace gridtools
@@ -16,6 +16,7 @@
 #include "../../meta.hpp"
 #include "../grid.hpp"
 #include "../local_domain.hpp"
+#include "../stage_meters.hpp"
 #include "iterate_domain_naive.hpp"
 
 namespace gridtools {
@@ -42,25 +43,34 @@ namespace gridtools {
                 int_t k_count = 1 + std::abs(k_to - k_from);
                 int_t k_step = k_to >= k_from ? 1 : -1;
 
-                iterate_domain_naive<LocalDomain> it_domain(m_local_domain, m_grid);
+#pragma omp parallel
+                {
+                    iterate_domain_naive<LocalDomain> it_domain(m_local_domain, m_grid);
 
-                // move to the start point of iteration
-                it_domain.increment_i(iminus);
-                it_domain.increment_j(jminus);
-                it_domain.increment_k(k_from);
+                    // move to the start point of iteration
+                    it_domain.increment_i(iminus);
+                    it_domain.increment_j(jminus);
+                    it_domain.increment_k(k_from);
 
-                // iterate over computation area
-                for (int_t i = 0; i != i_count; ++i) {
-                    for (int_t j = 0; j != j_count; ++j) {
-                        for (int_t k = 0; k != k_count; ++k) {
-                            Stage::exec(it_domain);
-                            it_domain.increment_k(k_step);
+                    // iterate over computation area, the (i, j) columns are independent
+                    stage_meter<Stage> meter;
+                    std::size_t columns = 0;
+#pragma omp for collapse(2) nowait
+                    for (int_t i = 0; i < i_count; ++i) {
+                        for (int_t j = 0; j < j_count; ++j) {
+                            ++columns;
+                            it_domain.increment_i(i);
+                            it_domain.increment_j(j);
+                            for (int_t k = 0; k != k_count; ++k) {
+                                Stage::exec(it_domain);
+                                it_domain.increment_k(k_step);
+                            }
+                            it_domain.increment_k(-k_count * k_step);
+                            it_domain.increment_j(-j);
+                            it_domain.increment_i(-i);
                         }
-                        it_domain.increment_k(-k_count * k_step);
-                        it_domain.increment_j();
                     }
-                    it_domain.increment_j(-j_count);
-                    it_domain.increment_i();
+                    meter.stop_share(i_count, j_count, k_count, columns * k_count);
                 }
             }
         };
@@ -101,7 +111,9 @@ namespace gridtools {
     }
 
     /**
-     * @brief determines whether ESFs should be fused in one single kernel execution or not for this backend.
+     * @brief determines whether the ESFs of an MSS should be fused in one single kernel execution or not for this
+     * backend.
      */
-    std::true_type mss_fuse_esfs(backend::naive);
+    template <class Mss>
+    std::true_type mss_fuse_esfs(backend::naive, Mss);
 } // namespace gridtools
@@ -50,7 +50,9 @@ namespace gridtools {
     }
 
     /**
-     * @brief determines whether ESFs should be fused in one single kernel execution or not for this backend.
+     * @brief determines whether the ESFs of an MSS should be fused in one single kernel execution or not for this
+     * backend.
      */
-    constexpr std::false_type mss_fuse_esfs(backend::x86) { return {}; }
+    template <class Mss>
+    constexpr std::false_type mss_fuse_esfs(backend::x86, Mss) { return {}; }
 } // namespace gridtools
@@ -0,0 +1,42 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include "../common/defs.hpp"
+#include "../meta.hpp"
+#include "fused_mss_loop.hpp"
+#include "mss_components.hpp"
+
+namespace gridtools {
+    /**
+     * @brief A computation with all its data stores bound, ready to be executed repeatedly.
+     *
+     * Holds copies of the local domains (the pointers and strides of all fields) of the computation it was created
+     * from, such that `run` directly launches the backend without updating them. The plan refers to the temporaries of
+     * the computation and to the bound data stores: it must not outlive them and the data stores must not be
+     * reallocated. Created by `make_plan` of the result of `make_computation`.
+     */
+    template <class Backend, class MssComponents, class LocalDomains, class Grid, class Scheduler>
+    class execution_plan {
+        GT_STATIC_ASSERT((meta::all_of<is_mss_components, MssComponents>::value), GT_INTERNAL_ERROR);
+
+        LocalDomains m_local_domains;
+        Grid m_grid;
+        Scheduler m_scheduler;
+
+      public:
+        execution_plan(LocalDomains const &local_domains, Grid const &grid, Scheduler const &scheduler)
+            : m_local_domains(local_domains), m_grid(grid), m_scheduler(scheduler) {}
+
+        void run() const { fused_mss_loop<MssComponents>(Backend{}, m_local_domains, m_grid, m_scheduler); }
+
+        Grid const &grid() const { return m_grid; }
+    };
+} // namespace gridtools
@@ -9,6 +9,8 @@
  */
 #pragma once
 
+#include "./scheduler.hpp"
+
 #ifdef __CUDACC__
 #include "./backend_cuda/fused_mss_loop_cuda.hpp"
 #endif
@@ -17,3 +19,14 @@
 #endif
 #include "./backend_naive/fused_mss_loop_naive.hpp"
 #include "./backend_x86/fused_mss_loop_x86.hpp"
+
+namespace gridtools {
+    /**
+     * @brief the default scheduler leaves the distribution of the blocks to the backend
+     */
+    template <class MssComponents, class Backend, class LocalDomainListArray, class Grid>
+    void fused_mss_loop(
+        Backend backend, LocalDomainListArray const &local_domain_lists, const Grid &grid, default_scheduler) {
+        fused_mss_loop<MssComponents>(backend, local_domain_lists, grid);
+    }
+} // namespace gridtools
@@ -9,8 +9,10 @@
  */
 #pragma once
 
+#include <cassert>
 #include <memory>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 
 #include "../common/timer/timer_traits.hpp"
@@ -19,6 +21,7 @@
 #include "compute_extents_metafunctions.hpp"
 #include "dim.hpp"
 #include "esf.hpp"
+#include "execution_plan.hpp"
 #include "extract_placeholders.hpp"
 #include "fused_mss_loop.hpp"
 #include "grid.hpp"
@@ -26,6 +29,8 @@
 #include "level.hpp"
 #include "local_domain.hpp"
 #include "mss_components_metafunctions.hpp"
+#include "scheduler.hpp"
+#include "temporal_blocking.hpp"
 
 /**
  * @file
@@ -34,14 +39,14 @@
 namespace gridtools {
     namespace _impl {
 
-        template <int I, uint_t Id, class Layout, class Halo, class Alignment>
-        std::enable_if_t<(I < Layout::masked_length), bool> storage_info_dim_fits(
-            storage_info<Id, Layout, Halo, Alignment> const &storage_info, int val) {
+        template <int I, class StorageInfo>
+        std::enable_if_t<(I < StorageInfo::layout_t::masked_length), bool> storage_info_dim_fits(
+            StorageInfo const &storage_info, int val) {
             return val < storage_info.template total_length<I>();
         }
-        template <int I, uint_t Id, class Layout, class Halo, class Alignment>
-        std::enable_if_t<(I >= Layout::masked_length), bool> storage_info_dim_fits(
-            storage_info<Id, Layout, Halo, Alignment> const &, int) {
+        template <int I, class StorageInfo>
+        std::enable_if_t<(I >= StorageInfo::layout_t::masked_length), bool> storage_info_dim_fits(
+            StorageInfo const &, int) {
             return true;
         }
 
@@ -49,8 +54,8 @@ namespace gridtools {
         struct storage_info_fits_grid_f {
             Grid const &grid;
 
-            template <uint_t Id, class Layout, class Halo, class Alignment>
-            bool operator()(storage_info<Id, Layout, Halo, Alignment> const &src) const {
+            template <class StorageInfo, std::enable_if_t<is_storage_info<StorageInfo>::value, int> = 0>
+            bool operator()(StorageInfo const &src) const {
                 return storage_info_dim_fits<dim::k::value>(src, grid.k_max()) &&
                        storage_info_dim_fits<dim::j::value>(src, grid.j_high_bound()) &&
                        storage_info_dim_fits<dim::i::value>(src, grid.i_high_bound());
@@ -76,7 +81,12 @@ namespace gridtools {
     /**
      *  @brief structure collecting helper metafunctions
      */
-    template <bool IsStateful, class Backend, class Grid, class BoundArgStoragePairs, class MssDescriptors>
+    template <bool IsStateful,
+        class Backend,
+        class Grid,
+        class BoundArgStoragePairs,
+        class MssDescriptors,
+        class Scheduler = default_scheduler>
     class intermediate;
 
     template <bool IsStateful,
@@ -84,13 +94,16 @@ namespace gridtools {
         class Grid,
         class... BoundPlaceholders,
         class... BoundDataStores,
-        class... MssDescriptors>
+        class... MssDescriptors,
+        class Scheduler>
     class intermediate<IsStateful,
         Backend,
         Grid,
         std::tuple<arg_storage_pair<BoundPlaceholders, BoundDataStores>...>,
-        std::tuple<MssDescriptors...>> {
+        std::tuple<MssDescriptors...>,
+        Scheduler> {
         GT_STATIC_ASSERT(is_grid<Grid>::value, GT_INTERNAL_ERROR);
+        GT_STATIC_ASSERT(is_scheduler<Scheduler>::value, GT_INTERNAL_ERROR);
 
         GT_STATIC_ASSERT(conjunction<is_mss_descriptor<MssDescriptors>...>::value,
             "make_computation args should be mss descriptors");
@@ -130,9 +143,12 @@ namespace gridtools {
         // This information is needed to allocate temporaries, and to provide the extent information to the user.
         using extent_map_t = get_extent_map<esfs_t>;
 
-        using fuse_esfs_t = decltype(mss_fuse_esfs(std::declval<Backend>()));
+        struct fuse_esfs_f {
+            template <class Mss>
+            using apply = decltype(mss_fuse_esfs(std::declval<Backend>(), std::declval<Mss>()));
+        };
         using mss_components_array_t =
-            build_mss_components_array<fuse_esfs_t::value, mss_descriptors_t, extent_map_t, typename Grid::axis_type>;
+            build_mss_components_array<fuse_esfs_f, mss_descriptors_t, extent_map_t, typename Grid::axis_type>;
 
         using max_extent_for_tmp_t = _impl::get_max_extent_for_tmp<mss_components_array_t>;
 
@@ -151,18 +167,24 @@ namespace gridtools {
 
         Grid m_grid;
 
+        Scheduler m_scheduler;
+
         std::unique_ptr<performance_meter_t> m_meter;
 
         /// tuple with temporary storages
         //
         tmp_arg_storage_pair_tuple_t m_tmp_arg_storage_pair_tuple;
 
+#ifdef GT_ENABLE_MEMORY_REGISTRY
+        computation_memory_registration m_tmp_memory_registration;
+#endif
+
         /// tuple with storages that are bound during costruction
         //  Each item holds a storage and its view
         bound_arg_storage_pair_tuple_t m_bound_arg_storage_pair_tuple;
 
         /// Here are local domains (structures with raw pointers for passing to backend.
-        //
+        //  The temporaries and the bound storages are set on construction, the free ones by every run.
         local_domains_t m_local_domains;
 
         struct check_grid_against_extents_f {
@@ -181,16 +203,26 @@ namespace gridtools {
       public:
         intermediate(Grid const &grid,
             std::tuple<arg_storage_pair<BoundPlaceholders, BoundDataStores>...> arg_storage_pairs,
-            bool timer_enabled = true)
+            bool timer_enabled = true,
+            Scheduler scheduler = {})
             // grid just stored to the member
-            : m_grid(grid),
+            : m_grid(grid), m_scheduler(wstd::move(scheduler)),
               // here we create temporary storages.
               m_tmp_arg_storage_pair_tuple(
-                  _impl::make_tmp_arg_storage_pairs<max_extent_for_tmp_t, Backend, tmp_arg_storage_pair_tuple_t>(grid)),
+                  _impl::make_tmp_arg_storage_pairs<max_extent_for_tmp_t,
+                      Backend,
+                      tmp_arg_storage_pair_tuple_t,
+                      mss_descriptors_t>(grid)),
               // stash bound storages
               m_bound_arg_storage_pair_tuple(wstd::move(arg_storage_pairs)) {
             if (timer_enabled)
                 m_meter.reset(new performance_meter_t{"NoName"});
+#ifdef GT_ENABLE_MEMORY_REGISTRY
+            m_tmp_memory_registration = _impl::register_tmp_memory(m_grid, m_tmp_arg_storage_pair_tuple);
+#endif
+            _impl::update_local_domains(
+                tuple_util::flatten(std::make_tuple(m_tmp_arg_storage_pair_tuple, m_bound_arg_storage_pair_tuple)),
+                m_local_domains);
 #ifndef NDEBUG
             for_each_type<non_tmp_placeholders_t>(check_grid_against_extents_f{m_grid});
 #endif
@@ -208,11 +240,126 @@ namespace gridtools {
                 meta::is_set_fast<meta::list<Args...>>::value, "free placeholders should be all different");
             if (m_meter)
                 m_meter->start();
-            fused_mss_loop<mss_components_array_t>(Backend{}, local_domains(srcs...), m_grid);
+            fused_mss_loop<mss_components_array_t>(Backend{}, local_domains(srcs...), m_grid, m_scheduler);
+            if (m_meter)
+                m_meter->pause();
+        }
+
+        /**
+         * @brief Binds the free placeholders and returns a plan that executes the computation with these data stores.
+         *
+         * Running the plan skips the binding of the data stores that is done by every `run`, which matters for small
+         * domains. Combined with a `thread_team_mc` scheduler on the mc backend, it also avoids the creation of an
+         * OpenMP parallel region per run. The plan does not update the performance meter of the computation.
+         */
+        template <class... Args, class... DataStores>
+        std::enable_if_t<sizeof...(Args) == meta::length<free_placeholders_t>::value,
+            execution_plan<Backend, mss_components_array_t, local_domains_t, Grid, Scheduler>>
+        make_plan(arg_storage_pair<Args, DataStores> const &... srcs) {
+            GT_STATIC_ASSERT((conjunction<meta::st_contains<free_placeholders_t, Args>...>::value),
+                "some placeholders are not used in mss descriptors");
+            GT_STATIC_ASSERT(
+                meta::is_set_fast<meta::list<Args...>>::value, "free placeholders should be all different");
+            return {local_domains(srcs...), m_grid, m_scheduler};
+        }
+
+        /**
+         * @brief Executes `steps` time steps of the computation, exchanging the data stores bound to the `In` and `Out`
+         * placeholders of `swap` after each step.
+         *
+         * The result is the same as calling `run` `steps` times and swapping the data stores in between: the result of
+         * the last step is in the data store that was bound to `Out` if `steps` is odd and in the one that was bound to
+         * `In` otherwise. The data stores of a pair should hold the same boundary values, as with the step-by-step
+         * execution the halo of either of them is read.
+         *
+         * On the mc backend, the steps are executed with temporal blocking: the j-axis is split into tiles which are
+         * skewed from step to step by the j-extent of the `In` and `Out` placeholders (as computed by
+         * `get_extent_map`). Every tile advances over all steps before the next one starts, such that its data stays in
+         * cache.
+         */
+        template <class... Swaps, class... Args, class... DataStores>
+        std::enable_if_t<sizeof...(Args) == meta::length<free_placeholders_t>::value> run_steps(
+            int_t steps, swap_spec<Swaps...> const &swap, arg_storage_pair<Args, DataStores> const &... srcs) {
+            using ins_t = meta::list<meta::first<Swaps>...>;
+            using outs_t = meta::list<meta::second<Swaps>...>;
+            using rw_args_t = meta::filter<meta::not_<is_tmp_arg>::apply, _impl::all_rw_args<mss_descriptors_t>>;
+            GT_STATIC_ASSERT((conjunction<meta::st_contains<non_tmp_placeholders_t, meta::first<Swaps>>...,
+                                 meta::st_contains<non_tmp_placeholders_t, meta::second<Swaps>>...>::value),
+                "swapped placeholders should be non temporary placeholders used in mss descriptors");
+            GT_STATIC_ASSERT((conjunction<negation<meta::st_contains<rw_args_t, meta::first<Swaps>>>...>::value),
+                "the first placeholder of a swapped pair should be read only");
+            GT_STATIC_ASSERT((meta::all_of<meta::curry<meta::st_contains, outs_t>::template apply, rw_args_t>::value),
+                "all non temporary placeholders that are written should be the second placeholder of a swapped pair");
+            GT_STATIC_ASSERT((meta::is_set_fast<meta::concat<ins_t, outs_t>>::value),
+                "swapped placeholders should be all different");
+            GT_STATIC_ASSERT(
+                (!disjunction<_impl::temporal_blocking::is_read_at_negative_j<esfs_t, meta::second<Swaps>>...>::value),
+                "the second placeholder of a swapped pair should not be read at a negative j-offset");
+            assert(steps >= 0);
+
+            if (m_meter)
+                m_meter->start();
+            local_domains(srcs...);
+            auto buffers = std::make_tuple(_impl::temporal_blocking::buffers<meta::first<Swaps>, meta::second<Swaps>>{
+                _impl::temporal_blocking::find_data_store<meta::first<Swaps>>(
+                    m_bound_arg_storage_pair_tuple, std::tie(srcs...)),
+                _impl::temporal_blocking::find_data_store<meta::second<Swaps>>(
+                    m_bound_arg_storage_pair_tuple, std::tie(srcs...))}...);
+            bool odd = false;
+            auto run_step = [&](int_t step, Grid const &grid) {
+                if (odd != (step % 2 == 1)) {
+                    odd = !odd;
+                    tuple_util::for_each([&](auto const &buffer) { buffer.bind(odd, m_local_domains); }, buffers);
+                }
+                fused_mss_loop<mss_components_array_t>(Backend{}, m_local_domains, grid, m_scheduler);
+            };
+            run_steps_impl(Backend{},
+                steps,
+                _impl::temporal_blocking::get_skew<extent_map_t, Swaps...>(),
+                swap.tile_size(),
+                run_step);
+            // restore the bindings of the bound data stores
+            if (odd)
+                tuple_util::for_each([&](auto const &buffer) { buffer.bind(false, m_local_domains); }, buffers);
             if (m_meter)
                 m_meter->pause();
         }
 
+        /**
+         * @brief Exchanges the data stores bound to the placeholders `In` and `Out` on construction, e.g., the fields
+         * of the old and the new time level of a time-stepping loop.
+         *
+         * The bound data stores are set in the local domains once, on construction, while `run` only sets the data
+         * stores passed to it. Hence, a swap merely exchanges the pointers of the two placeholders in the local
+         * domains, no other data store is bound again and no memory is allocated. The data stores must have equal
+         * storage infos.
+         *
+         *     auto comp = make_computation<backend_t>(grid, p_in() = in, p_out() = out, ...);
+         *     for (int step = 0; step < steps; ++step) {
+         *         comp.run();
+         *         comp.swap(p_in(), p_out());
+         *     }
+         *     // the result is in `out` if `steps` is odd, in `in` otherwise
+         */
+        template <class In, class Out>
+        void swap(In, Out) {
+            using bound_placeholders_t = meta::list<BoundPlaceholders...>;
+            GT_STATIC_ASSERT((meta::st_contains<bound_placeholders_t, In>::value &&
+                                 meta::st_contains<bound_placeholders_t, Out>::value),
+                "swapped placeholders should be bound on construction");
+            GT_STATIC_ASSERT((!std::is_same<In, Out>::value), "swapped placeholders should be different");
+            GT_STATIC_ASSERT((std::is_same<typename In::data_store_t, typename Out::data_store_t>::value),
+                "swapped placeholders should have the same data store type");
+            auto &in = tuple_util::get<meta::st_position<bound_placeholders_t, In>::value>(
+                m_bound_arg_storage_pair_tuple).m_value;
+            auto &out = tuple_util::get<meta::st_position<bound_placeholders_t, Out>::value>(
+                m_bound_arg_storage_pair_tuple).m_value;
+            assert(in.info() == out.info());
+            in.swap(out);
+            tuple_util::for_each(
+                _impl::swap_ptrs_f<In, Out, typename In::data_store_t>{in, out}, m_local_domains);
+        }
+
         std::string print_meter() const {
             assert(m_meter);
             return m_meter->to_string();
@@ -246,12 +393,34 @@ namespace gridtools {
             return {};
         }
 
+      private:
+        template <class F>
+        void run_steps_impl(backend::mc, int_t steps, int_t skew, int_t tile, F &&run_step) {
+            const int_t j_first = m_grid.j_low_bound();
+            const int_t j_last = m_grid.j_high_bound();
+            if (tile <= 0)
+                tile = _impl::temporal_blocking::default_tile_size(skew);
+            _impl::temporal_blocking::for_each_tile_step(
+                steps, j_first, j_last, skew, tile, [&](int_t step, int_t first, int_t last) {
+                    if (first == j_first && last == j_last)
+                        run_step(step, m_grid);
+                    else
+                        run_step(step, _impl::temporal_blocking::sub_grid(m_grid, first, last));
+                });
+        }
+
+        template <class OtherBackend, class F>
+        void run_steps_impl(OtherBackend, int_t steps, int_t, int_t, F &&run_step) {
+            for (int_t step = 0; step < steps; ++step)
+                run_step(step, m_grid);
+        }
+
+      public:
         template <class... Args, class... DataStores>
         local_domains_t const &local_domains(arg_storage_pair<Args, DataStores> const &... srcs) {
-            _impl::update_local_domains(
-                tuple_util::flatten(
-                    std::make_tuple(m_tmp_arg_storage_pair_tuple, m_bound_arg_storage_pair_tuple, std::tie(srcs...))),
-                m_local_domains);
+            // the pointers of the bound data stores are set once, but they may have been modified on the host since
+            tuple_util::for_each(_impl::sync_arg_store_pair_f{}, m_bound_arg_storage_pair_tuple);
+            _impl::update_local_domains(std::tie(srcs...), m_local_domains);
             return m_local_domains;
         }
     }; // namespace gridtools
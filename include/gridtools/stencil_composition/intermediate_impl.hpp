@@ -9,9 +9,14 @@
  */
 #pragma once
 
+#include <set>
+#include <type_traits>
+
 #include "../common/functional.hpp"
+#include "../common/generic_metafunctions/for_each.hpp"
 #include "../common/hymap.hpp"
 #include "../common/tuple_util.hpp"
+#include "../storage/common/memory_registry.hpp"
 #include "../storage/sid.hpp"
 #include "esf_metafunctions.hpp"
 #include "extract_placeholders.hpp"
@@ -47,6 +52,50 @@ namespace gridtools {
             tuple_util::for_each_in_cartesian_product(set_arg_store_pair_to_local_domain_f{}, srcs, local_domains);
         }
 
+        // bring the data of a data store to the target and reactivate its target write views, as `sid::get_origin`
+        // does when the pointers are set, without touching the local domains
+        struct sync_arg_store_pair_f {
+            template <class Arg, class DataStore>
+            void operator()(arg_storage_pair<Arg, DataStore> const &src) const {
+                sid::get_origin(src.m_value);
+            }
+        };
+
+        /**
+         * Exchanges the pointers of the placeholders `In` and `Out` in a local domain after the data stores bound to
+         * them have been swapped. A local domain that uses only one of them gets the origin of its new data store.
+         */
+        template <class In, class Out, class DataStore>
+        struct swap_ptrs_f {
+            DataStore const &m_in;
+            DataStore const &m_out;
+
+            template <class LocalDomain>
+            void operator()(LocalDomain &local_domain) const {
+                using args_t = typename LocalDomain::esf_args_t;
+                swap_ptrs(local_domain,
+                    bool_constant<meta::st_contains<args_t, In>::value>{},
+                    bool_constant<meta::st_contains<args_t, Out>::value>{});
+            }
+
+          private:
+            template <class LocalDomain>
+            void swap_ptrs(LocalDomain &local_domain, std::true_type, std::true_type) const {
+                using std::swap;
+                swap(at_key<In>(local_domain.m_ptr_holder_map), at_key<Out>(local_domain.m_ptr_holder_map));
+            }
+            template <class LocalDomain>
+            void swap_ptrs(LocalDomain &local_domain, std::true_type, std::false_type) const {
+                at_key<In>(local_domain.m_ptr_holder_map) = sid::get_origin(m_in);
+            }
+            template <class LocalDomain>
+            void swap_ptrs(LocalDomain &local_domain, std::false_type, std::true_type) const {
+                at_key<Out>(local_domain.m_ptr_holder_map) = sid::get_origin(m_out);
+            }
+            template <class LocalDomain>
+            void swap_ptrs(LocalDomain &, std::false_type, std::false_type) const {}
+        };
+
         template <class Mss>
         struct non_cached_tmp_f {
             using local_caches_t = meta::filter<is_local_cache, typename Mss::cache_sequence_t>;
@@ -63,14 +112,106 @@ namespace gridtools {
         template <class Msses, class ArgLists = meta::transform<extract_non_cached_tmp_args_from_mss, Msses>>
         using extract_non_cached_tmp_args_from_msses = meta::dedup<meta::flatten<ArgLists>>;
 
-        template <class MaxExtent, class Backend>
+        /**
+         * Liveness analysis of the temporaries of a computation: every temporary is live from the first to the last
+         * MSS that uses it. The MSSes are executed one after the other on every block (or on the whole domain), hence
+         * temporaries with the same data store type that are live in disjoint ranges of MSSes can share their storage.
+         * `owner(i)` is the index of the temporary whose storage is used by the i-th temporary, the storages are
+         * assigned greedily in the order of the first use.
+         */
+        template <class Msses, class TmpArgs>
+        struct tmp_liveness;
+
+        template <class Msses, template <class...> class L, class... TmpArgs>
+        struct tmp_liveness<Msses, L<TmpArgs...>> {
+          private:
+            static constexpr int_t n_args = sizeof...(TmpArgs);
+            static constexpr int_t n_msses = meta::length<Msses>::value;
+
+            template <class Arg>
+            struct uses_f {
+                template <class Mss>
+                using apply = meta::st_contains<extract_placeholders_from_mss<Mss>, Arg>;
+            };
+
+            template <class Arg, class Uses = meta::transform<uses_f<Arg>::template apply, Msses>>
+            struct live_range;
+
+            template <class Arg, template <class...> class UsesList, class... Uses>
+            struct live_range<Arg, UsesList<Uses...>> {
+                static constexpr int_t first() {
+                    bool uses[] = {Uses::value..., false};
+                    int_t res = 0;
+                    while (res < n_msses && !uses[res])
+                        ++res;
+                    return res;
+                }
+                static constexpr int_t last() {
+                    bool uses[] = {false, Uses::value...};
+                    int_t res = n_msses;
+                    while (res > 0 && !uses[res])
+                        --res;
+                    return res - 1;
+                }
+            };
+
+            // index of the first temporary with the same data store type
+            template <class Arg>
+            static constexpr int_t kind() {
+                bool same[] = {std::is_same<typename TmpArgs::data_store_t, typename Arg::data_store_t>::value...};
+                int_t res = 0;
+                while (!same[res])
+                    ++res;
+                return res;
+            }
+
+            struct owners_t {
+                int_t values[n_args + 1];
+            };
+
+            static constexpr owners_t compute_owners() {
+                int_t first[n_args + 1] = {live_range<TmpArgs>::first()...};
+                int_t last[n_args + 1] = {live_range<TmpArgs>::last()...};
+                int_t kinds[n_args + 1] = {kind<TmpArgs>()...};
+                int_t slot_last[n_args + 1] = {};
+                bool assigned[n_args + 1] = {};
+                owners_t res = {};
+                for (int_t i = 0; i < n_args; ++i)
+                    res.values[i] = i;
+                for (int_t mss = 0; mss < n_msses; ++mss)
+                    for (int_t i = 0; i < n_args; ++i) {
+                        if (first[i] != mss)
+                            continue;
+                        for (int_t j = 0; j < n_args; ++j)
+                            if (assigned[j] && res.values[j] == j && kinds[j] == kinds[i] && slot_last[j] < mss) {
+                                res.values[i] = j;
+                                slot_last[j] = last[i];
+                                break;
+                            }
+                        if (res.values[i] == i)
+                            slot_last[i] = last[i];
+                        assigned[i] = true;
+                    }
+                return res;
+            }
+
+          public:
+            static constexpr int_t owner(int_t i) { return compute_owners().values[i]; }
+        };
+
+        template <class MaxExtent, class Backend, class Res, class Liveness>
         struct get_tmp_arg_storage_pair_generator {
-            template <class ArgStoragePair>
+            template <class Index>
             struct generator {
+                using arg_storage_pair_t = meta::at<Res, Index>;
+
                 template <class Grid>
-                ArgStoragePair operator()(Grid const &grid) const {
+                arg_storage_pair_t operator()(Grid const &grid) const {
+                    // the storages of temporaries that share the storage of another one are set afterwards
+                    if (Liveness::owner(Index::value) != Index::value)
+                        return {};
                     return tmp_storage::make_tmp_data_store<MaxExtent>(
-                        Backend{}, typename ArgStoragePair::arg_t{}, grid);
+                        Backend{}, typename arg_storage_pair_t::arg_t{}, grid);
                 }
             };
 
@@ -78,11 +219,60 @@ namespace gridtools {
             using apply = generator<T>;
         };
 
-        template <class MaxExtent, class Backend, class Res, class Grid>
+        template <class Liveness, class Res>
+        struct share_tmp_storage_f {
+            Res &m_res;
+
+            template <class Index>
+            void operator()(Index) const {
+                constexpr int_t owner = Liveness::owner(Index::value);
+                if (owner != Index::value)
+                    tuple_util::get<Index::value>(m_res).m_value = tuple_util::get<owner>(m_res).m_value;
+            }
+        };
+
+        template <class ArgStoragePair>
+        using get_arg_t = typename ArgStoragePair::arg_t;
+
+        /**
+         * Creates the storages of the temporaries `Res` (a tuple of arg_storage_pair) used by the MSSes `Msses`,
+         * temporaries that are live in disjoint ranges of MSSes share their storage.
+         */
+        template <class MaxExtent, class Backend, class Res, class Msses, class Grid>
         Res make_tmp_arg_storage_pairs(Grid const &grid) {
+            using liveness_t = tmp_liveness<Msses, meta::transform<get_arg_t, Res>>;
+            using indices_t = meta::make_indices<meta::length<Res>>;
             using generators =
-                meta::transform<get_tmp_arg_storage_pair_generator<MaxExtent, Backend>::template apply, Res>;
-            return tuple_util::generate<generators, Res>(grid);
+                meta::transform<get_tmp_arg_storage_pair_generator<MaxExtent, Backend, Res, liveness_t>::template apply,
+                    indices_t>;
+            Res res = tuple_util::generate<generators, Res>(grid);
+            host::for_each<indices_t>(share_tmp_storage_f<liveness_t, Res>{res});
+            return res;
+        }
+
+        /**
+         * Registers the storages of the temporaries `Tmps` (a tuple of arg_storage_pair) with the memory registry,
+         * together with the bytes they would need for the points of the grid alone.
+         */
+        template <class Grid, class Tmps>
+        computation_memory_registration register_tmp_memory(Grid const &grid, Tmps const &tmps) {
+            const std::size_t points = std::size_t(grid.i_high_bound() - grid.i_low_bound() + 1) *
+                                       (grid.j_high_bound() - grid.j_low_bound() + 1) * grid.k_total_length();
+            std::size_t bytes = 0;
+            std::size_t domain_bytes = 0;
+            std::set<void const *> storages;
+            tuple_util::for_each(
+                [&](auto const &tmp) {
+                    auto const &data_store = tmp.m_value;
+                    using data_t = typename std::decay_t<decltype(data_store)>::data_t;
+                    // temporaries with disjoint live ranges share their storage
+                    if (data_store.valid() && storages.insert(data_store.get_storage_ptr().get()).second) {
+                        bytes += data_store.info().padded_total_length() * sizeof(data_t);
+                        domain_bytes += points * sizeof(data_t);
+                    }
+                },
+                tmps);
+            return {bytes, domain_bytes};
         }
 
         template <class MssComponentsList,
@@ -14,6 +14,9 @@
 
 #include "../common/defs.hpp"
 #include "../common/split_args.hpp"
+#include "../meta/first.hpp"
+#include "../meta/length.hpp"
+#include "../meta/push_back.hpp"
 #include "../meta/transform.hpp"
 #include "../meta/type_traits.hpp"
 #include "computation.hpp"
@@ -21,6 +24,7 @@
 #include "expandable_parameters/intermediate_expand.hpp"
 #include "grid.hpp"
 #include "intermediate.hpp"
+#include "scheduler.hpp"
 
 namespace gridtools {
     namespace _impl {
@@ -28,6 +32,16 @@ namespace gridtools {
         template <class List>
         using decay_elements = meta::transform<std::decay_t, List>;
 
+        template <class Scheduler>
+        Scheduler get_scheduler(std::tuple<>) {
+            return {};
+        }
+
+        template <class Scheduler, class Arg>
+        Scheduler get_scheduler(std::tuple<Arg> &&schedulers) {
+            return std::get<0>(wstd::move(schedulers));
+        }
+
         template <bool IsStateful, class Backend>
         struct make_intermediate_f {
             template <class Grid,
@@ -35,12 +49,23 @@ namespace gridtools {
                 class ArgsPair = decltype(
                     split_args<is_arg_storage_pair>(wstd::forward<Args>(std::declval<Args>())...)),
                 class ArgStoragePairs = decay_elements<typename ArgsPair::first_type>,
-                class Msses = decay_elements<typename ArgsPair::second_type>>
-            intermediate<IsStateful, Backend, Grid, ArgStoragePairs, Msses> operator()(
+                class SchedulersPair = decltype(
+                    split_args_tuple<is_scheduler>(std::declval<typename ArgsPair::second_type>())),
+                class Schedulers = decay_elements<typename SchedulersPair::first_type>,
+                class Msses = decay_elements<typename SchedulersPair::second_type>,
+                class Scheduler = meta::first<meta::push_back<Schedulers, default_scheduler>>>
+            intermediate<IsStateful, Backend, Grid, ArgStoragePairs, Msses, Scheduler> operator()(
                 Grid const &grid, Args &&... args) const {
-                // split arg_storage_pair and mss descriptor arguments and forward it to intermediate constructor
+                GT_STATIC_ASSERT(
+                    meta::length<Schedulers>::value <= 1, "at most one scheduler can be passed to make_computation");
+                // split arg_storage_pair, scheduler and mss descriptor arguments and forward it to intermediate
+                // constructor
                 auto &&args_pair = split_args<is_arg_storage_pair>(wstd::forward<Args>(args)...);
-                return {grid, wstd::move(args_pair.first)};
+                auto &&schedulers_pair = split_args_tuple<is_scheduler>(wstd::move(args_pair.second));
+                return {grid,
+                    wstd::move(args_pair.first),
+                    true,
+                    get_scheduler<Scheduler>(wstd::move(schedulers_pair.first))};
             }
         };
 
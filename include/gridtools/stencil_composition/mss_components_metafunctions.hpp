@@ -33,15 +33,16 @@ namespace gridtools {
         } // namespace lazy
         GT_META_DELEGATE_TO_LAZY(mss_split_esfs, class Mss, Mss);
 
-        template <bool Fuse, class Msses>
-        struct split_mss_into_independent_esfs {
-            using mms_lists_t = meta::transform<mss_split_esfs, Msses>;
-            using type = meta::flatten<mms_lists_t>;
+        template <class Fuse>
+        struct split_mss_f {
+            template <class Mss>
+            using apply = meta::if_<typename Fuse::template apply<Mss>, std::tuple<Mss>, mss_split_esfs<Mss>>;
         };
 
-        template <class Msses>
-        struct split_mss_into_independent_esfs<true, Msses> {
-            using type = Msses;
+        template <class Fuse, class Msses>
+        struct split_mss_into_independent_esfs {
+            using mms_lists_t = meta::transform<split_mss_f<Fuse>::template apply, Msses>;
+            using type = meta::flatten<mms_lists_t>;
         };
 
         template <class ExtentMap, class Axis>
@@ -54,8 +55,10 @@ namespace gridtools {
 
     /**
      * @brief metafunction that builds the array of mss components
+     * @tparam Fuse meta function class telling if the ESFs of an MSS are fused, otherwise every ESF is executed in an
+     * MSS on its own
      */
-    template <bool Fuse,
+    template <class Fuse,
         class Msses,
         class ExtentMap,
         class Axis,
@@ -0,0 +1,31 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <type_traits>
+
+namespace gridtools {
+    /**
+     *  @brief The scheduler that is used if none is passed to make_computation.
+     *
+     *  The backend distributes the blocks of the computation domain as it does by default.
+     */
+    struct default_scheduler {};
+
+    /**
+     *  @brief Trait to identify the objects that can be passed to make_computation to select how the blocks of the
+     *  computation domain are distributed among the threads. Backend specific schedulers specialize it.
+     */
+    template <class T>
+    struct is_scheduler : std::false_type {};
+
+    template <>
+    struct is_scheduler<default_scheduler> : std::true_type {};
+} // namespace gridtools
@@ -0,0 +1,511 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <typeindex>
+#include <typeinfo>
+#include <vector>
+
+#if defined(GT_ENABLE_STAGE_METERS) && defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "../common/defs.hpp"
+#include "../common/demangle.hpp"
+#include "../common/generic_metafunctions/for_each.hpp"
+#include "../common/host_device.hpp"
+#include "../meta.hpp"
+#include "accessor_intent.hpp"
+#include "arg.hpp"
+#include "bind_functor_with_interval.hpp"
+#ifndef GT_ICOSAHEDRAL_GRIDS
+#include "structured_grids/stage.hpp"
+#endif
+
+/**
+ * @file
+ * Per-stage instrumentation of the mc and naive backends.
+ *
+ * If GT_ENABLE_STAGE_METERS is defined, the backends record for every execution of a stage the elapsed time, the
+ * number of evaluated grid points, an estimate of the bytes moved from and to memory and, on Linux, the hardware
+ * counters of the executing thread. The records are accumulated per stage in `stage_meters::instance()`. Otherwise
+ * the instrumentation is compiled out.
+ */
+namespace gridtools {
+    /**
+     * @brief Accumulated measurements of a stage.
+     *
+     * The executions of a stage run concurrently on all threads, hence `time` and the counters are summed over the
+     * threads. Counters are -1 if they are not available.
+     */
+    struct stage_record {
+        std::string name;           /** Functor(s) of the stage. */
+        std::size_t executions = 0; /** Number of recorded executions (per block and thread). */
+        double time = 0;            /** Time spent in the stage, summed over the threads [s]. */
+        std::size_t points = 0;     /** Number of evaluated grid points. */
+        std::size_t bytes = 0;      /** Estimated memory traffic [B]. */
+        long long cycles = -1;      /** CPU cycles. */
+        long long instructions = -1; /** Retired instructions. */
+        long long llc_misses = -1;  /** Last level cache misses. */
+        long long flops = -1;       /** Value of the raw event given by GT_STAGE_METERS_FLOPS_EVENT. */
+
+        /** @brief Bytes per second of thread time. */
+        double bandwidth() const { return time > 0 ? bytes / time : 0; }
+    };
+
+    namespace _impl_stage_meters {
+        template <class Functor>
+        struct functor_type {
+            using type = Functor;
+        };
+
+        template <class Functor, class Interval>
+        struct functor_type<_impl::bound_functor<Functor, Interval>> {
+            using type = Functor;
+        };
+
+        template <int_t I, class Layout, std::enable_if_t<(I < Layout::masked_length), int> = 0>
+        constexpr bool is_masked() {
+            return Layout::template at<I>() < 0;
+        }
+
+        template <int_t I, class Layout, std::enable_if_t<(I >= Layout::masked_length), int> = 0>
+        constexpr bool is_masked() {
+            return true;
+        }
+
+        /**
+         * @brief Bytes read and written through an accessor when a stage is evaluated on a region of ni x nj x nk
+         * points: the region extended by the extent of the accessor, read once, and written once more for inout
+         * accessors. Dimensions that are masked in the storage do not contribute, global parameters are ignored.
+         */
+        template <class Accessor, class Arg>
+        struct accessor_bytes_f {
+            std::size_t operator()(int_t ni, int_t nj, int_t nk) const {
+                using data_store_t = typename Arg::data_store_t;
+                using layout_t = typename data_store_t::storage_info_t::layout_t;
+                using extent_t = typename Accessor::extent_t;
+                if (layout_t::unmasked_length == 0)
+                    return 0;
+                std::size_t res = sizeof(typename data_store_t::data_t);
+                if (!is_masked<0, layout_t>())
+                    res *= ni + extent_t::iplus::value - extent_t::iminus::value;
+                if (!is_masked<1, layout_t>())
+                    res *= nj + extent_t::jplus::value - extent_t::jminus::value;
+                if (!is_masked<2, layout_t>())
+                    res *= nk + extent_t::kplus::value - extent_t::kminus::value;
+                return Accessor::intent_v == intent::inout ? 2 * res : res;
+            }
+        };
+
+        /**
+         * @brief Name and memory traffic of a stage, unknown for stages other than the ones of structured grids.
+         */
+        template <class Stage>
+        struct stage_traits {
+            static std::string name() { return demangle(typeid(Stage).name()); }
+            static std::size_t bytes(int_t, int_t, int_t) { return 0; }
+        };
+
+#ifndef GT_ICOSAHEDRAL_GRIDS
+        template <class Functor, class Extent, class Args>
+        struct stage_traits<regular_stage<Functor, Extent, Args>> {
+            using functor_t = typename functor_type<Functor>::type;
+
+            static std::string name() { return demangle(typeid(functor_t).name()); }
+
+            static std::size_t bytes(int_t ni, int_t nj, int_t nk) {
+                using accessors_t = meta::transform<accessor_bytes_f, typename functor_t::param_list, Args>;
+                std::size_t res = 0;
+                for_each<accessors_t>([&](auto f) { res += f(ni, nj, nk); });
+                return res;
+            }
+        };
+
+        template <class... Stages>
+        struct stage_traits<compound_stage<Stages...>> {
+            static std::string name() {
+                std::string res;
+                for (auto &&name : {stage_traits<Stages>::name()...})
+                    res += (res.empty() ? "" : " + ") + name;
+                return res;
+            }
+
+            static std::size_t bytes(int_t ni, int_t nj, int_t nk) {
+                std::size_t res = 0;
+                for (auto bytes : {stage_traits<Stages>::bytes(ni, nj, nk)...})
+                    res += bytes;
+                return res;
+            }
+        };
+#endif
+
+        struct counters {
+            long long cycles = -1;
+            long long instructions = -1;
+            long long llc_misses = -1;
+            long long flops = -1;
+        };
+
+#if defined(GT_ENABLE_STAGE_METERS) && defined(__linux__)
+        /**
+         * @brief Hardware counters of the calling thread, read as a perf_event group.
+         */
+        class perf_group {
+            static const int max_events = 4;
+
+            int m_leader = -1;
+            int m_fds[max_events];
+            int m_slots[max_events]; // index of the event in the group, -1 if it could not be opened
+
+            int open(std::uint32_t type, std::uint64_t config) {
+                perf_event_attr attr = {};
+                attr.size = sizeof(attr);
+                attr.type = type;
+                attr.config = config;
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+                attr.read_format = PERF_FORMAT_GROUP;
+                attr.disabled = m_leader == -1;
+                return (int)syscall(__NR_perf_event_open, &attr, 0, -1, m_leader, 0);
+            }
+
+          public:
+            perf_group() {
+                std::uint64_t flops_event = 0;
+                if (char const *env = std::getenv("GT_STAGE_METERS_FLOPS_EVENT"))
+                    flops_event = std::strtoull(env, nullptr, 0);
+                const std::uint32_t types[] = {
+                    PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_RAW};
+                const std::uint64_t configs[] = {
+                    PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, flops_event};
+                int slot = 0;
+                for (int e = 0; e < max_events; ++e) {
+                    m_fds[e] = e == 3 && !flops_event ? -1 : open(types[e], configs[e]);
+                    m_slots[e] = m_fds[e] == -1 ? -1 : slot++;
+                    if (m_leader == -1)
+                        m_leader = m_fds[e];
+                }
+                if (m_leader != -1)
+                    ioctl(m_leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+            }
+
+            ~perf_group() {
+                for (int fd : m_fds)
+                    if (fd != -1)
+                        close(fd);
+            }
+
+            counters read_counters() const {
+                counters res;
+                std::uint64_t values[max_events + 1];
+                if (m_leader == -1 || ::read(m_leader, values, sizeof(values)) <= 0)
+                    return res;
+                long long *dst[] = {&res.cycles, &res.instructions, &res.llc_misses, &res.flops};
+                for (int e = 0; e < max_events; ++e)
+                    if (m_slots[e] != -1)
+                        *dst[e] = values[1 + m_slots[e]];
+                return res;
+            }
+        };
+
+        inline counters read_counters() {
+            thread_local perf_group group;
+            return group.read_counters();
+        }
+#else
+        inline counters read_counters() { return {}; }
+#endif
+
+        inline long long difference(long long start, long long stop) {
+            return start < 0 || stop < 0 ? -1 : stop - start;
+        }
+
+        // the counters since `start`
+        inline counters elapsed_counters(counters const &start) {
+            counters res = read_counters();
+            res.cycles = difference(start.cycles, res.cycles);
+            res.instructions = difference(start.instructions, res.instructions);
+            res.llc_misses = difference(start.llc_misses, res.llc_misses);
+            res.flops = difference(start.flops, res.flops);
+            return res;
+        }
+
+        inline long long scale(long long value, double factor) {
+            return value < 0 ? -1 : (long long)(value * factor + .5);
+        }
+
+        inline void accumulate(long long &dst, long long value) {
+            if (value >= 0)
+                dst = (dst < 0 ? 0 : dst) + value;
+        }
+
+        using record_map = std::map<std::type_index, stage_record>;
+
+        inline void merge(record_map &dst, record_map const &src) {
+            for (auto const &item : src) {
+                auto it = dst.emplace(item.first, stage_record()).first;
+                stage_record &record = it->second;
+                stage_record const &other = item.second;
+                record.name = other.name;
+                record.executions += other.executions;
+                record.time += other.time;
+                record.points += other.points;
+                record.bytes += other.bytes;
+                accumulate(record.cycles, other.cycles);
+                accumulate(record.instructions, other.instructions);
+                accumulate(record.llc_misses, other.llc_misses);
+                accumulate(record.flops, other.flops);
+            }
+        }
+    } // namespace _impl_stage_meters
+
+    /**
+     * @brief Registry of the stage measurements of all computations.
+     *
+     * Every thread accumulates its measurements in its own records, which are merged when they are queried, such that
+     * the measurements of concurrently executing threads do not contend.
+     */
+    class stage_meters {
+        struct thread_records {
+            std::mutex mutex;
+            _impl_stage_meters::record_map records;
+        };
+
+        mutable std::mutex m_mutex;
+        std::vector<thread_records *> m_threads;
+        _impl_stage_meters::record_map m_retired; // records of the threads that have terminated
+
+        stage_meters() = default;
+
+        thread_records &local() {
+            struct registration {
+                stage_meters &owner;
+                thread_records data;
+
+                registration(stage_meters &owner) : owner(owner) {
+                    std::lock_guard<std::mutex> lock(owner.m_mutex);
+                    owner.m_threads.push_back(&data);
+                }
+                ~registration() {
+                    std::lock_guard<std::mutex> lock(owner.m_mutex);
+                    _impl_stage_meters::merge(owner.m_retired, data.records);
+                    owner.m_threads.erase(std::find(owner.m_threads.begin(), owner.m_threads.end(), &data));
+                }
+            };
+            thread_local registration res(*this);
+            return res.data;
+        }
+
+      public:
+        static stage_meters &instance() {
+            static stage_meters res;
+            return res;
+        }
+
+        /**
+         * @brief Adds an execution of `Stage` by the calling thread to its record.
+         */
+        template <class Stage>
+        void add(double time, std::size_t points, std::size_t bytes, _impl_stage_meters::counters const &counters) {
+            using namespace _impl_stage_meters;
+            thread_records &local = this->local();
+            std::lock_guard<std::mutex> lock(local.mutex);
+            auto it = local.records.find(typeid(Stage));
+            if (it == local.records.end()) {
+                it = local.records.emplace(typeid(Stage), stage_record()).first;
+                it->second.name = stage_traits<Stage>::name();
+            }
+            stage_record &record = it->second;
+            ++record.executions;
+            record.time += time;
+            record.points += points;
+            record.bytes += bytes;
+            accumulate(record.cycles, counters.cycles);
+            accumulate(record.instructions, counters.instructions);
+            accumulate(record.llc_misses, counters.llc_misses);
+            accumulate(record.flops, counters.flops);
+        }
+
+        /**
+         * @brief The records of all executed stages, the most time consuming first.
+         */
+        std::vector<stage_record> records() const {
+            _impl_stage_meters::record_map all;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                _impl_stage_meters::merge(all, m_retired);
+                for (thread_records *thread : m_threads) {
+                    std::lock_guard<std::mutex> thread_lock(thread->mutex);
+                    _impl_stage_meters::merge(all, thread->records);
+                }
+            }
+            std::vector<stage_record> res;
+            for (auto const &item : all)
+                res.push_back(item.second);
+            std::stable_sort(res.begin(), res.end(), [](stage_record const &lhs, stage_record const &rhs) {
+                return lhs.time > rhs.time;
+            });
+            return res;
+        }
+
+        void reset() {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_retired.clear();
+            for (thread_records *thread : m_threads) {
+                std::lock_guard<std::mutex> thread_lock(thread->mutex);
+                thread->records.clear();
+            }
+        }
+
+        /**
+         * @brief The records as a JSON array of objects, unavailable counters are null.
+         */
+        std::string to_json() const {
+            auto counter = [](long long value) { return value < 0 ? std::string("null") : std::to_string(value); };
+            std::ostringstream out;
+            out << "[";
+            bool first = true;
+            for (auto const &record : records()) {
+                out << (first ? "" : ",") << "\n  {\"name\": \"";
+                for (char c : record.name)
+                    out << (c == '"' || c == '\\' ? "\\" : "") << c;
+                out << "\", \"executions\": " << record.executions << ", \"time\": " << record.time
+                    << ", \"points\": " << record.points << ", \"bytes\": " << record.bytes
+                    << ", \"bandwidth\": " << record.bandwidth() << ", \"cycles\": " << counter(record.cycles)
+                    << ", \"instructions\": " << counter(record.instructions)
+                    << ", \"llc_misses\": " << counter(record.llc_misses) << ", \"flops\": " << counter(record.flops)
+                    << "}";
+                first = false;
+            }
+            out << (first ? "]" : "\n]");
+            return out.str();
+        }
+    };
+
+    /**
+     * @brief Measures an execution of a stage by the calling thread, from construction to `stop`.
+     */
+    template <class Stage>
+    class stage_meter {
+#ifdef GT_ENABLE_STAGE_METERS
+        std::chrono::steady_clock::time_point m_start;
+        _impl_stage_meters::counters m_counters;
+
+      public:
+        stage_meter() : m_counters(_impl_stage_meters::read_counters()) { m_start = std::chrono::steady_clock::now(); }
+
+        /**
+         * @brief Records the execution, the stage was evaluated on `points` points moving `bytes` bytes.
+         */
+        void stop(std::size_t points, std::size_t bytes) const {
+            using namespace _impl_stage_meters;
+            const double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+            stage_meters::instance().add<Stage>(time, points, bytes, elapsed_counters(m_counters));
+        }
+
+        /**
+         * @brief Records the execution on a region of ni x nj x nk points.
+         */
+        void stop_region(int_t ni, int_t nj, int_t nk) const {
+            stop((std::size_t)ni * nj * nk, _impl_stage_meters::stage_traits<Stage>::bytes(ni, nj, nk));
+        }
+
+        /**
+         * @brief Records the execution of `points` of the points of a region of ni x nj x nk points, that is shared
+         * by several threads, and the proportional share of its memory traffic.
+         */
+        void stop_share(int_t ni, int_t nj, int_t nk, std::size_t points) const {
+            const std::size_t total = (std::size_t)ni * nj * nk;
+            stop(points, total ? _impl_stage_meters::stage_traits<Stage>::bytes(ni, nj, nk) * points / total : 0);
+        }
+#else
+      public:
+        GT_FORCE_INLINE void stop(std::size_t, std::size_t) const {}
+        GT_FORCE_INLINE void stop_region(int_t, int_t, int_t) const {}
+        GT_FORCE_INLINE void stop_share(int_t, int_t, int_t, std::size_t) const {}
+#endif
+    };
+
+    /**
+     * @brief Measures interleaved executions of the stages `Stages` by the calling thread, e.g. the stages of a
+     * multistage with k-caches that are run level by level on every row.
+     *
+     * Measuring every single execution would cost about as much as the execution itself. Hence, the whole run is
+     * measured once, and its time and counters are split among the stages in proportion to their points.
+     */
+    template <class Stages>
+    class interleaved_stage_meter {
+#ifdef GT_ENABLE_STAGE_METERS
+        static constexpr std::size_t size = meta::length<Stages>::value;
+
+        std::chrono::steady_clock::time_point m_start;
+        _impl_stage_meters::counters m_counters;
+        std::size_t m_points[size] = {};
+        std::size_t m_bytes[size] = {};
+
+      public:
+        interleaved_stage_meter() : m_counters(_impl_stage_meters::read_counters()) {
+            m_start = std::chrono::steady_clock::now();
+        }
+
+        /**
+         * @brief Adds the executions of `Stage` on a region of ni x nj x nk points.
+         */
+        template <class Stage>
+        void add_region(int_t ni, int_t nj, int_t nk) {
+            constexpr std::size_t index = meta::st_position<Stages, Stage>::value;
+            m_points[index] += (std::size_t)ni * nj * nk;
+            m_bytes[index] += _impl_stage_meters::stage_traits<Stage>::bytes(ni, nj, nk);
+        }
+
+        /**
+         * @brief Records the executions of all stages.
+         */
+        void stop() const {
+            using namespace _impl_stage_meters;
+            const double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+            const counters total = elapsed_counters(m_counters);
+            std::size_t points = 0;
+            for (std::size_t index = 0; index != size; ++index)
+                points += m_points[index];
+            if (!points)
+                return;
+            for_each<Stages>([&](auto stage) {
+                using stage_t = decltype(stage);
+                constexpr std::size_t index = meta::st_position<Stages, stage_t>::value;
+                const double share = (double)m_points[index] / points;
+                counters part;
+                part.cycles = scale(total.cycles, share);
+                part.instructions = scale(total.instructions, share);
+                part.llc_misses = scale(total.llc_misses, share);
+                part.flops = scale(total.flops, share);
+                stage_meters::instance().add<stage_t>(time * share, m_points[index], m_bytes[index], part);
+            });
+        }
+#else
+      public:
+        template <class Stage>
+        GT_FORCE_INLINE void add_region(int_t, int_t, int_t) {}
+        GT_FORCE_INLINE void stop() const {}
+#endif
+    };
+} // namespace gridtools
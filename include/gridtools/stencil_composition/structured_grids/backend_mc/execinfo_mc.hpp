@@ -46,25 +46,52 @@ namespace gridtools {
         using block_kserial_t = execinfo_block_kserial_mc;
         using block_kparallel_t = execinfo_block_kparallel_mc;
 
+        /**
+         * @brief Splits the domain into one block per thread.
+         */
+        template <class Grid>
+        GT_FUNCTION execinfo_mc(const Grid &grid) : execinfo_mc(grid, omp_get_max_threads()) {}
+
+        /**
+         * @brief Splits the domain into (at most) the given number of blocks.
+         *
+         * Requesting more blocks than threads over-decomposes the domain, the resulting blocks are never larger than
+         * the ones of the default decomposition.
+         */
         template <class Grid>
-        GT_FUNCTION execinfo_mc(const Grid &grid)
+        GT_FUNCTION execinfo_mc(const Grid &grid, int_t blocks)
             : m_i_grid_size(grid.i_high_bound() - grid.i_low_bound() + 1),
               m_j_grid_size(grid.j_high_bound() - grid.j_low_bound() + 1), m_i_low_bound(grid.i_low_bound()),
               m_j_low_bound(grid.j_low_bound()) {
-            const int_t threads = omp_get_max_threads();
+            assert(blocks > 0);
 
-            // if domain is large enough (relative to the number of threads),
+            // if domain is large enough (relative to the number of blocks),
             // we split only along j-axis (for prefetching reasons)
             // for smaller domains we also split along i-axis
-            m_j_block_size = (m_j_grid_size + threads - 1) / threads;
+            m_j_block_size = (m_j_grid_size + blocks - 1) / blocks;
             m_j_blocks = (m_j_grid_size + m_j_block_size - 1) / m_j_block_size;
-            const int_t max_i_blocks = threads / m_j_blocks;
+            const int_t max_i_blocks = blocks / m_j_blocks;
             m_i_block_size = (m_i_grid_size + max_i_blocks - 1) / max_i_blocks;
             m_i_blocks = (m_i_grid_size + m_i_block_size - 1) / m_i_block_size;
 
             assert(m_i_block_size > 0 && m_j_block_size > 0);
         }
 
+        /**
+         * @brief Splits the domain into blocks of the given size.
+         *
+         * The block sizes must not exceed the ones of the default decomposition, temporaries are allocated for those.
+         */
+        template <class Grid>
+        GT_FUNCTION execinfo_mc(const Grid &grid, int_t i_block_size, int_t j_block_size)
+            : m_i_grid_size(grid.i_high_bound() - grid.i_low_bound() + 1),
+              m_j_grid_size(grid.j_high_bound() - grid.j_low_bound() + 1), m_i_low_bound(grid.i_low_bound()),
+              m_j_low_bound(grid.j_low_bound()), m_i_block_size(i_block_size), m_j_block_size(j_block_size),
+              m_i_blocks((m_i_grid_size + i_block_size - 1) / i_block_size),
+              m_j_blocks((m_j_grid_size + j_block_size - 1) / j_block_size) {
+            assert(m_i_block_size > 0 && m_j_block_size > 0);
+        }
+
         /**
          * @brief Computes the effective (clamped) block size and position for k-serial stencils.
          *
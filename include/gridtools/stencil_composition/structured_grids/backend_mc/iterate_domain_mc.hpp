@@ -14,9 +14,11 @@
 #include "../../../common/generic_metafunctions/for_each.hpp"
 #include "../../../common/hymap.hpp"
 #include "../../../meta.hpp"
+#include "../../backend_mc/thread_team_mc.hpp"
 #include "../../iterate_domain_aux.hpp"
 #include "../../iterate_domain_fwd.hpp"
 #include "../../local_domain.hpp"
+#include "../../sid/blocked_dim.hpp"
 #include "../../sid/concept.hpp"
 #include "../../sid/multi_shift.hpp"
 #include "../dim.hpp"
@@ -25,16 +27,53 @@ namespace gridtools {
 
     namespace iterate_domain_mc_impl_ {
         /**
-         * @brief Per-thread global value of omp_get_thread_num() / omp_get_max_threads().
+         * @brief Per-thread global value of thread_index_mc() / omp_get_max_threads().
          */
         inline float thread_factor() {
 #if !defined(__APPLE_CC__) || __APPLE_CC__ > 8000
             thread_local static
 #endif
-                const float value = (float)omp_get_thread_num() / omp_get_max_threads();
+                const float value = (float)thread_index_mc() / omp_get_max_threads();
             return value;
         }
 
+        /**
+         * @brief Checks if the data of the given arg is stored in i/j-tiles (see tiled_storage_info), i.e. if its
+         * strides include the blocked i-dimension.
+         */
+        template <class LocalDomain>
+        struct is_tiled_arg_f {
+            template <class Arg>
+            using apply = has_key<sid::strides_type<storage_from_arg<LocalDomain, Arg>>, sid::blocked_dim<dim::i>>;
+        };
+
+        template <class Dim, class Accessor, std::enable_if_t<has_key<Accessor, Dim>::value, int> = 0>
+        GT_FORCE_INLINE int_t accessor_offset(Accessor const &accessor) {
+            return host_device::at_key<Dim>(accessor);
+        }
+
+        template <class Dim, class Accessor, std::enable_if_t<!has_key<Accessor, Dim>::value, int> = 0>
+        GT_FORCE_INLINE int_t accessor_offset(Accessor const &) {
+            return 0;
+        }
+
+        /**
+         * @brief Offset of the point (i, j, k) of a tiled storage from its origin. The coordinates are decomposed into
+         * the tile and the position inside the tile, as the offset is not linear in i and j.
+         */
+        template <class StridesKind, class PtrDiff, class Strides>
+        GT_FORCE_INLINE void shift_tiled(PtrDiff &ptr_offset, Strides const &strides, int_t i, int_t j, int_t k) {
+            constexpr int_t tile_i = StridesKind::tile_t::i;
+            constexpr int_t tile_j = StridesKind::tile_t::j;
+            i += StridesKind::template tile_offset<0>();
+            j += StridesKind::template tile_offset<1>();
+            sid::shift(ptr_offset, sid::get_stride<sid::blocked_dim<dim::i>>(strides), i / tile_i);
+            sid::shift(ptr_offset, sid::get_stride<dim::i>(strides), i % tile_i);
+            sid::shift(ptr_offset, sid::get_stride<sid::blocked_dim<dim::j>>(strides), j / tile_j);
+            sid::shift(ptr_offset, sid::get_stride<dim::j>(strides), j % tile_j);
+            sid::shift(ptr_offset, sid::get_stride<dim::k>(strides), k);
+        }
+
         template <class LocalDomain>
         struct set_base_offset_f {
             LocalDomain const &m_local_domain;
@@ -48,7 +87,7 @@ namespace gridtools {
                 using strides_kind_t = sid::strides_kind<sid_t>;
                 auto length = at_key<strides_kind_t>(m_local_domain.m_total_length_map);
                 sid::ptr_diff_type<sid_t> offset = std::lround(length * thread_factor());
-                assert(offset == ((long long)length * omp_get_thread_num()) / omp_get_max_threads());
+                assert(offset == ((long long)length * thread_index_mc()) / omp_get_max_threads());
                 auto const &strides = at_key<strides_kind_t>(m_local_domain.m_strides_map);
                 GT_STATIC_ASSERT(is_storage_info<strides_kind_t>::value, GT_INTERNAL_ERROR);
                 sid::shift(offset, sid::get_stride<dim::i>(strides), strides_kind_t::halo_t::template at<0>());
@@ -56,7 +95,15 @@ namespace gridtools {
                 at_key<Arg>(m_dst) += offset;
             }
 
-            template <class Arg, std::enable_if_t<!is_tmp_arg<Arg>::value, int> = 0>
+            // tiled storages are addressed from their origin, see shift_tiled
+            template <class Arg,
+                std::enable_if_t<!is_tmp_arg<Arg>::value && is_tiled_arg_f<LocalDomain>::template apply<Arg>::value,
+                    int> = 0>
+            GT_FORCE_INLINE void operator()() const {}
+
+            template <class Arg,
+                std::enable_if_t<!is_tmp_arg<Arg>::value && !is_tiled_arg_f<LocalDomain>::template apply<Arg>::value,
+                    int> = 0>
             GT_FORCE_INLINE void operator()() const {
                 using sid_t = storage_from_arg<LocalDomain, Arg>;
                 using strides_kind_t = sid::strides_kind<sid_t>;
@@ -66,17 +113,36 @@ namespace gridtools {
                 sid::shift(ptr, sid::get_stride<dim::j>(strides), m_j_block_base);
             }
         };
+
+        template <class KCaches>
+        struct k_cached_args {
+            using type = typename KCaches::args_t;
+        };
+
+        template <>
+        struct k_cached_args<void> {
+            using type = meta::list<>;
+        };
     } // namespace iterate_domain_mc_impl_
 
     /**
      * @brief Iterate domain class for the MC backend.
+     *
+     * @tparam KCaches Ring buffers of the k-caches (see k_caches_mc), `void` if no k-caches are used.
      */
-    template <class LocalDomain, class IJCachedArgs>
+    template <class LocalDomain, class IJCachedArgs, class KCaches = void>
     class iterate_domain_mc {
         GT_STATIC_ASSERT(is_local_domain<LocalDomain>::value, GT_INTERNAL_ERROR);
 
+        template <class Arg>
+        using is_tiled_arg = typename iterate_domain_mc_impl_::is_tiled_arg_f<LocalDomain>::template apply<Arg>;
+
+        using k_cached_args_t = typename iterate_domain_mc_impl_::k_cached_args<KCaches>::type;
+
+        LocalDomain const &m_local_domain;
         typename LocalDomain::strides_map_t const &m_strides_map;
         typename LocalDomain::ptr_map_t m_ptr_map;
+        KCaches *m_k_caches;   /** Ring buffers of the k-caches. */
         int_t m_i_block_index; /** Local i-index inside block. */
         int_t m_j_block_index; /** Local j-index inside block. */
         int_t m_k_block_index; /** Local/global k-index (no blocking along k-axis). */
@@ -84,10 +150,21 @@ namespace gridtools {
         int_t m_j_block_base;  /** Global block start index along j-axis. */
 
       public:
+        static constexpr bool has_k_caches = !meta::is_empty<k_cached_args_t>::value;
+        static constexpr bool has_tiled_args =
+            meta::any_of<iterate_domain_mc_impl_::is_tiled_arg_f<LocalDomain>::template apply,
+                typename LocalDomain::esf_args_t>::value;
+
         GT_FORCE_INLINE
-        iterate_domain_mc(LocalDomain const &local_domain, int_t i_block_base = 0, int_t j_block_base = 0)
-            : m_strides_map(local_domain.m_strides_map), m_ptr_map(local_domain.make_ptr_map()), m_i_block_index(0),
-              m_j_block_index(0), m_k_block_index(0), m_i_block_base(i_block_base), m_j_block_base(j_block_base) {
+        iterate_domain_mc(LocalDomain const &local_domain,
+            int_t i_block_base = 0,
+            int_t j_block_base = 0,
+            KCaches *k_caches = nullptr)
+            : m_local_domain(local_domain), m_strides_map(local_domain.m_strides_map),
+              m_ptr_map(local_domain.make_ptr_map()), m_k_caches(k_caches),
+              m_i_block_index(0), m_j_block_index(0), m_k_block_index(0), m_i_block_base(i_block_base),
+              m_j_block_base(j_block_base) {
+            assert(!has_k_caches || m_k_caches);
             gridtools::for_each_type<typename LocalDomain::esf_args_t>(
                 iterate_domain_mc_impl_::set_base_offset_f<LocalDomain>{
                     local_domain, i_block_base, j_block_base, m_ptr_map});
@@ -103,7 +180,11 @@ namespace gridtools {
         /**
          * @brief Returns the value pointed by an accessor.
          */
-        template <class Arg, class Accessor, std::enable_if_t<!meta::st_contains<IJCachedArgs, Arg>::value, int> = 0>
+        template <class Arg,
+            class Accessor,
+            std::enable_if_t<!meta::st_contains<IJCachedArgs, Arg>::value &&
+                                 !meta::st_contains<k_cached_args_t, Arg>::value && !is_tiled_arg<Arg>::value,
+                int> = 0>
         GT_FORCE_INLINE decltype(auto) deref(Accessor const &accessor) const {
             using sid_t = storage_from_arg<LocalDomain, Arg>;
             using strides_kind_t = sid::strides_kind<sid_t>;
@@ -116,6 +197,23 @@ namespace gridtools {
             return *(at_key<Arg>(m_ptr_map) + ptr_offset);
         }
 
+        template <class Arg,
+            class Accessor,
+            std::enable_if_t<!meta::st_contains<IJCachedArgs, Arg>::value &&
+                                 !meta::st_contains<k_cached_args_t, Arg>::value && is_tiled_arg<Arg>::value,
+                int> = 0>
+        GT_FORCE_INLINE decltype(auto) deref(Accessor const &accessor) const {
+            using sid_t = storage_from_arg<LocalDomain, Arg>;
+            using strides_kind_t = sid::strides_kind<sid_t>;
+            sid::ptr_diff_type<sid_t> ptr_offset{};
+            iterate_domain_mc_impl_::shift_tiled<strides_kind_t>(ptr_offset,
+                at_key<strides_kind_t>(m_strides_map),
+                i() + iterate_domain_mc_impl_::accessor_offset<dim::i>(accessor),
+                j() + iterate_domain_mc_impl_::accessor_offset<dim::j>(accessor),
+                k() + iterate_domain_mc_impl_::accessor_offset<dim::k>(accessor));
+            return *(at_key<Arg>(m_ptr_map) + ptr_offset);
+        }
+
         template <class Arg, class Accessor, std::enable_if_t<meta::st_contains<IJCachedArgs, Arg>::value, int> = 0>
         GT_FORCE_INLINE decltype(auto) deref(Accessor const &accessor) const {
             using sid_t = storage_from_arg<LocalDomain, Arg>;
@@ -128,6 +226,63 @@ namespace gridtools {
             return *(at_key<Arg>(m_ptr_map) + ptr_offset);
         }
 
+        template <class Arg,
+            class Accessor,
+            std::enable_if_t<!meta::st_contains<IJCachedArgs, Arg>::value &&
+                                 meta::st_contains<k_cached_args_t, Arg>::value,
+                int> = 0>
+        GT_FORCE_INLINE decltype(auto) deref(Accessor const &accessor) const {
+            return m_k_caches->template at<Arg>(m_i_block_index, accessor);
+        }
+
+        /**
+         * @brief Returns the stride along the i-axis of the data of the given arg.
+         */
+        template <class Arg>
+        GT_FORCE_INLINE auto i_stride() const {
+            using strides_kind_t = sid::strides_kind<storage_from_arg<LocalDomain, Arg>>;
+            return sid::get_stride<dim::i>(at_key<strides_kind_t>(m_strides_map));
+        }
+
+        /**
+         * @brief Returns a pointer to the element of the current j-row at local i-index `i` and global k-index `k`,
+         * used for filling and flushing the k-caches.
+         */
+        template <class Arg, std::enable_if_t<!is_tiled_arg<Arg>::value, int> = 0>
+        GT_FORCE_INLINE auto deref_for_k_cache(int_t i, int_t k) const {
+            using sid_t = storage_from_arg<LocalDomain, Arg>;
+            using strides_kind_t = sid::strides_kind<sid_t>;
+            auto const &strides = at_key<strides_kind_t>(m_strides_map);
+            sid::ptr_diff_type<sid_t> ptr_offset{};
+            sid::shift(ptr_offset, sid::get_stride<dim::i>(strides), i);
+            sid::shift(ptr_offset, sid::get_stride<dim::j>(strides), m_j_block_index);
+            sid::shift(ptr_offset, sid::get_stride<dim::k>(strides), k);
+            return at_key<Arg>(m_ptr_map) + ptr_offset;
+        }
+
+        template <class Arg, std::enable_if_t<is_tiled_arg<Arg>::value, int> = 0>
+        GT_FORCE_INLINE auto deref_for_k_cache(int_t i, int_t k) const {
+            using sid_t = storage_from_arg<LocalDomain, Arg>;
+            using strides_kind_t = sid::strides_kind<sid_t>;
+            sid::ptr_diff_type<sid_t> ptr_offset{};
+            iterate_domain_mc_impl_::shift_tiled<strides_kind_t>(
+                ptr_offset, at_key<strides_kind_t>(m_strides_map), m_i_block_base + i, j(), k);
+            return at_key<Arg>(m_ptr_map) + ptr_offset;
+        }
+
+        /**
+         * @brief Checks if the elements of the current j-row in [i_first, i_last) at global k-index `k` are inside the
+         * allocated storage.
+         */
+        template <class Arg>
+        GT_FORCE_INLINE bool is_k_cache_row_in_storage(int_t i_first, int_t i_last, int_t k) const {
+            using strides_kind_t = sid::strides_kind<storage_from_arg<LocalDomain, Arg>>;
+            auto const &origin = at_key<Arg>(m_local_domain.m_ptr_holder_map)();
+            auto total_length = at_key<strides_kind_t>(m_local_domain.m_total_length_map);
+            return deref_for_k_cache<Arg>(i_first, k) - origin >= 0 &&
+                   deref_for_k_cache<Arg>(i_last - 1, k) - origin < total_length;
+        }
+
         /** @brief Global i-index. */
         GT_FORCE_INLINE
         int_t i() const { return m_i_block_base + m_i_block_index; }
@@ -141,6 +296,6 @@ namespace gridtools {
         int_t k() const { return m_k_block_index; }
     };
 
-    template <class LocalDomain, class IJCachedArgs>
-    struct is_iterate_domain<iterate_domain_mc<LocalDomain, IJCachedArgs>> : std::true_type {};
+    template <class LocalDomain, class IJCachedArgs, class KCaches>
+    struct is_iterate_domain<iterate_domain_mc<LocalDomain, IJCachedArgs, KCaches>> : std::true_type {};
 } // namespace gridtools
@@ -0,0 +1,329 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+#include "../../../common/defs.hpp"
+#include "../../../common/generic_metafunctions/for_each.hpp"
+#include "../../../common/host_device.hpp"
+#include "../../../common/hymap.hpp"
+#include "../../../meta.hpp"
+#include "../../caches/cache_metafunctions.hpp"
+#include "../../caches/extract_extent_caches.hpp"
+#include "../../execution_types.hpp"
+#include "../dim.hpp"
+
+/**@file
+ * @brief k-cache ring buffers for the mc backend
+ *
+ * On the mc backend, k-serial MSSs with k-caches are executed row by row: every thread processes the j-rows of its
+ * block one after another and sweeps the whole k-axis for each row, with the i-loop innermost. A k-cache thus needs
+ * one buffer row per cached k-level, each row holding the values of all i-positions of the current j-row (including
+ * the i-extent of the MSS). Sliding the cache only rotates the row pointers, no data is moved.
+ *
+ * MSSs in which a stage reads the output of another stage with a j-offset can not be executed row by row, the
+ * k-caches are ignored for them (see mss_loop_mc.hpp).
+ */
+namespace gridtools {
+    namespace _impl_k_caches_mc {
+        using byte_alignment = std::integral_constant<std::size_t, 64>;
+
+        /**
+         * @brief Per-thread scratch memory for the ring buffers, grown on demand and reused by all blocks and
+         * MSSs executed by the same thread.
+         */
+        inline void *thread_scratch(std::size_t size) {
+            struct scratch {
+                void *ptr = nullptr;
+                std::size_t size = 0;
+                ~scratch() { free(ptr); }
+            };
+            thread_local static scratch s_scratch;
+            if (s_scratch.size < size) {
+                free(s_scratch.ptr);
+                s_scratch.ptr = nullptr;
+                s_scratch.size = 0;
+                if (posix_memalign(&s_scratch.ptr, byte_alignment::value, size))
+                    throw std::bad_alloc();
+                s_scratch.size = size;
+            }
+            return s_scratch.ptr;
+        }
+
+        /**
+         * @brief Pads a row length to a multiple of the cache line size, so that all rows are SIMD aligned.
+         */
+        template <class T>
+        std::size_t pad(std::size_t size) {
+            constexpr std::size_t n = byte_alignment::value / sizeof(T) > 0 ? byte_alignment::value / sizeof(T) : 1;
+            return (size + n - 1) / n * n;
+        }
+    } // namespace _impl_k_caches_mc
+
+    /**
+     * @brief Ring buffer of a single k-cache, one row per k-level in [Minus, Plus].
+     */
+    template <class Arg, class T, int_t Minus, int_t Plus>
+    class k_cache_storage_mc {
+        GT_STATIC_ASSERT(Minus <= 0, GT_INTERNAL_ERROR);
+        GT_STATIC_ASSERT(Plus >= 0, GT_INTERNAL_ERROR);
+
+        static constexpr int_t depth = Plus - Minus + 1;
+
+        T *m_rows[depth];
+
+        template <class Policy, sync_type SyncType>
+        using sync_point = std::integral_constant<int_t,
+            (execute::is_forward<Policy>::value && SyncType == sync_type::fill) ||
+                    (execute::is_backward<Policy>::value && SyncType == sync_type::flush)
+                ? Plus
+                : Minus>;
+
+        template <sync_type SyncType, class ItDomain>
+        GT_FORCE_INLINE std::enable_if_t<SyncType == sync_type::fill> sync_at(
+            ItDomain const &it_domain, int_t i_first, int_t i_last, int_t k) {
+            if (!it_domain.template is_k_cache_row_in_storage<Arg>(i_first, i_last, k))
+                return;
+            T *GT_RESTRICT row = m_rows[k - it_domain.k() - Minus];
+#ifdef NDEBUG
+#pragma omp simd
+#endif
+            for (int_t i = i_first; i < i_last; ++i)
+                row[i] = *it_domain.template deref_for_k_cache<Arg>(i, k);
+        }
+
+        template <sync_type SyncType, class ItDomain>
+        GT_FORCE_INLINE std::enable_if_t<SyncType == sync_type::flush> sync_at(
+            ItDomain const &it_domain, int_t i_first, int_t i_last, int_t k) {
+            if (!it_domain.template is_k_cache_row_in_storage<Arg>(i_first, i_last, k))
+                return;
+            T const *GT_RESTRICT row = m_rows[k - it_domain.k() - Minus];
+#ifdef NDEBUG
+#pragma omp simd
+#endif
+            for (int_t i = i_first; i < i_last; ++i)
+                *it_domain.template deref_for_k_cache<Arg>(i, k) = row[i];
+        }
+
+      public:
+        /** @brief Number of elements required for the ring buffer if each row has the given (padded) length. */
+        static std::size_t size(std::size_t row_size) { return depth * row_size; }
+
+        /**
+         * @brief Binds the ring buffer to memory.
+         *
+         * @param ptr Memory of at least `size(row_size)` elements.
+         * @param row_size Length of each row.
+         * @param i_zero Position of i-index zero inside the row.
+         */
+        void init(T *ptr, std::size_t row_size, int_t i_zero) {
+            for (int_t d = 0; d < depth; ++d)
+                m_rows[d] = ptr + d * row_size + i_zero;
+        }
+
+        /**
+         * @brief Retrieves the value in the cache at i-position `i` given an accessor.
+         */
+        template <class Accessor>
+        GT_FORCE_INLINE T &at(int_t i, Accessor const &acc) const {
+            using zero_t = integral_constant<int_t, 0>;
+            int_t offset = host_device::at_key_with_default<dim::k, zero_t>(acc);
+            assert(offset >= Minus);
+            assert(offset <= Plus);
+            assert((host_device::at_key_with_default<dim::i, zero_t>(acc) == 0));
+            assert((host_device::at_key_with_default<dim::j, zero_t>(acc) == 0));
+            return m_rows[offset - Minus][i];
+        }
+
+        /**
+         * @brief Slides the ring buffer by rotating the row pointers.
+         */
+        template <class Policy>
+        GT_FORCE_INLINE std::enable_if_t<execute::is_forward<Policy>::value> slide() {
+            T *first = m_rows[0];
+            for (int_t d = 0; d < depth - 1; ++d)
+                m_rows[d] = m_rows[d + 1];
+            m_rows[depth - 1] = first;
+        }
+
+        template <class Policy>
+        GT_FORCE_INLINE std::enable_if_t<execute::is_backward<Policy>::value> slide() {
+            T *last = m_rows[depth - 1];
+            for (int_t d = depth - 1; d > 0; --d)
+                m_rows[d] = m_rows[d - 1];
+            m_rows[0] = last;
+        }
+
+        /**
+         * @brief Fills/flushes the level that enters/leaves the ring buffer, or all levels if `sync_all` is set.
+         * Only levels inside [k_min, k_max] and inside the storage are synchronized with main memory.
+         */
+        template <class Policy,
+            sync_type SyncType,
+            class ItDomain,
+            int_t SyncPoint = sync_point<Policy, SyncType>::value>
+        GT_FORCE_INLINE void sync(
+            ItDomain const &it_domain, int_t i_first, int_t i_last, int_t k_min, int_t k_max, bool sync_all) {
+            const int_t k = it_domain.k();
+            if (sync_all) {
+                for (int_t kk = std::max(k + Minus, k_min); kk <= std::min(k + Plus, k_max); ++kk)
+                    sync_at<SyncType>(it_domain, i_first, i_last, kk);
+            } else if (k + SyncPoint >= k_min && k + SyncPoint <= k_max) {
+                sync_at<SyncType>(it_domain, i_first, i_last, k + SyncPoint);
+            }
+        }
+    };
+
+    template <class Arg, class Extent>
+    struct make_k_cache_storage_mc {
+        GT_STATIC_ASSERT(
+            Extent::iminus::value == 0, "KCaches can not be use with a non zero extent in the horizontal dimensions");
+        GT_STATIC_ASSERT(
+            Extent::iplus::value == 0, "KCaches can not be use with a non zero extent in the horizontal dimensions");
+        GT_STATIC_ASSERT(
+            Extent::jminus::value == 0, "KCaches can not be use with a non zero extent in the horizontal dimensions");
+        GT_STATIC_ASSERT(
+            Extent::jplus::value == 0, "KCaches can not be use with a non zero extent in the horizontal dimensions");
+
+        GT_STATIC_ASSERT(Extent::kminus::value <= 0, GT_INTERNAL_ERROR);
+        GT_STATIC_ASSERT(Extent::kplus::value >= 0, GT_INTERNAL_ERROR);
+
+        using type =
+            k_cache_storage_mc<Arg, typename Arg::data_store_t::data_t, Extent::kminus::value, Extent::kplus::value>;
+    };
+
+    /**
+     * @brief All k-caches of an MSS on the mc backend.
+     *
+     * @tparam Caches The cache sequence of the MSS.
+     * @tparam Esfs The ESF sequence of the MSS, used to compute the k-extents of the caches.
+     */
+    template <class Caches, class Esfs>
+    class k_caches_mc {
+        GT_STATIC_ASSERT((meta::all_of<is_cache, Caches>::value), GT_INTERNAL_ERROR);
+        GT_STATIC_ASSERT((meta::all_of<is_esf_descriptor, Esfs>::value), GT_INTERNAL_ERROR);
+
+      public:
+        using args_t = k_cache_args<Caches>;
+
+      private:
+        template <class Cache, class Arg = typename Cache::arg_t>
+        using make_storage = typename make_k_cache_storage_mc<Arg, extract_k_extent_for_cache<Arg, Esfs>>::type;
+
+        using filling_args_t = meta::transform<cache_parameter, meta::filter<is_filling_cache, k_caches<Caches>>>;
+        using flushing_args_t = meta::transform<cache_parameter, meta::filter<is_flushing_cache, k_caches<Caches>>>;
+        using storages_t = hymap::from_keys_values<args_t, meta::transform<make_storage, k_caches<Caches>>>;
+
+        storages_t m_storages;
+        int_t m_i_first, m_i_last;
+
+        struct init_f {
+            char *&m_ptr;
+            std::size_t m_row_size;
+            int_t m_i_zero;
+
+            template <class Arg, class Storage>
+            void operator()(Storage &storage) const {
+                using data_t = typename Arg::data_store_t::data_t;
+                std::size_t row_size = _impl_k_caches_mc::pad<data_t>(m_row_size);
+                storage.init(reinterpret_cast<data_t *>(m_ptr), row_size, m_i_zero);
+                m_ptr += _impl_k_caches_mc::pad<char>(Storage::size(row_size) * sizeof(data_t));
+            }
+        };
+
+        struct size_f {
+            std::size_t &m_size;
+            std::size_t m_row_size;
+
+            template <class Arg, class Storage>
+            void operator()(Storage const &) const {
+                using data_t = typename Arg::data_store_t::data_t;
+                m_size += _impl_k_caches_mc::pad<char>(
+                    Storage::size(_impl_k_caches_mc::pad<data_t>(m_row_size)) * sizeof(data_t));
+            }
+        };
+
+        template <class Policy>
+        struct slide_f {
+            template <class Arg, class Storage>
+            GT_FORCE_INLINE void operator()(Storage &storage) const {
+                storage.template slide<Policy>();
+            }
+        };
+
+        template <class Policy, sync_type SyncType, class ItDomain>
+        struct sync_f {
+            storages_t &m_storages;
+            ItDomain const &m_it_domain;
+            int_t m_i_first, m_i_last, m_k_min, m_k_max;
+            bool m_sync_all;
+
+            template <class Arg>
+            GT_FORCE_INLINE void operator()() const {
+                at_key<Arg>(m_storages).template sync<Policy, SyncType>(
+                    m_it_domain, m_i_first, m_i_last, m_k_min, m_k_max, m_sync_all);
+            }
+        };
+
+      public:
+        /**
+         * @brief Allocates the ring buffers for rows covering the i-range [i_first, i_last) from the per-thread
+         * scratch memory.
+         */
+        k_caches_mc(int_t i_first, int_t i_last) : m_i_first(i_first), m_i_last(i_last) {
+            const std::size_t row_size = i_last - i_first;
+            std::size_t size = 0;
+            hymap::for_each(size_f{size, row_size}, m_storages);
+            char *ptr = static_cast<char *>(_impl_k_caches_mc::thread_scratch(size));
+            hymap::for_each(init_f{ptr, row_size, -i_first}, m_storages);
+        }
+
+        k_caches_mc(k_caches_mc const &) = delete;
+        k_caches_mc &operator=(k_caches_mc const &) = delete;
+
+        template <class Arg, class Accessor>
+        GT_FORCE_INLINE typename Arg::data_store_t::data_t &at(int_t i, Accessor const &acc) const {
+            return at_key<Arg>(m_storages).at(i, acc);
+        }
+
+        /** @brief Slides all k-caches. */
+        template <class Policy>
+        GT_FORCE_INLINE void slide() {
+            hymap::for_each(slide_f<Policy>{}, m_storages);
+        }
+
+        /**
+         * @brief Fills the next k-level of all filling caches from main memory for the current j-row.
+         *
+         * @param k_min, k_max Range of levels that might be read, usually the k-range of the grid.
+         * @param first_level Indicates the first iteration of the k-loop, all levels are filled in that case.
+         */
+        template <class Policy, class ItDomain>
+        GT_FORCE_INLINE void fill(ItDomain const &it_domain, int_t k_min, int_t k_max, bool first_level) {
+            host::for_each_type<filling_args_t>(sync_f<Policy, sync_type::fill, ItDomain>{
+                m_storages, it_domain, m_i_first, m_i_last, k_min, k_max, first_level});
+        }
+
+        /**
+         * @brief Flushes the last k-level of all flushing caches to main memory for the current j-row.
+         *
+         * @param k_min, k_max Range of levels that are computed, usually the k-range of the loop intervals.
+         * @param last_level Indicates the last iteration of the k-loop, all levels are flushed in that case.
+         */
+        template <class Policy, class ItDomain>
+        GT_FORCE_INLINE void flush(ItDomain const &it_domain, int_t k_min, int_t k_max, bool last_level) {
+            host::for_each_type<flushing_args_t>(sync_f<Policy, sync_type::flush, ItDomain>{
+                m_storages, it_domain, m_i_first, m_i_last, k_min, k_max, last_level});
+        }
+    };
+} // namespace gridtools
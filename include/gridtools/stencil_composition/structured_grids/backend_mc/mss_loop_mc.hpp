@@ -9,14 +9,21 @@
  */
 #pragma once
 
+#include <algorithm>
+#include <cstdlib>
+
 #include "../../../common/generic_metafunctions/for_each.hpp"
 #include "../../../meta.hpp"
 #include "../../caches/cache_metafunctions.hpp"
+#include "../../esf_metafunctions.hpp"
 #include "../../iteration_policy.hpp"
 #include "../../loop_interval.hpp"
 #include "../../run_functor_arguments.hpp"
+#include "../../stage_meters.hpp"
 #include "execinfo_mc.hpp"
 #include "iterate_domain_mc.hpp"
+#include "k_caches_mc.hpp"
+#include "simd_iterate_domain_mc.hpp"
 
 /**@file
  * @brief mss loop implementations for the mc backend
@@ -52,21 +59,16 @@ namespace gridtools {
                 const int_t k_first = m_grid.template value_at<From>();
                 const int_t k_last = m_grid.template value_at<To>();
 
+                stage_meter<Stage> meter;
                 for (int_t j = j_first; j < j_last; ++j) {
                     m_it_domain.set_j_block_index(j);
                     for (int_t k = k_first; iteration_policy_t::condition(k, k_last);
                          iteration_policy_t::increment(k)) {
                         m_it_domain.set_k_block_index(k);
-#ifdef NDEBUG
-#pragma ivdep
-#pragma omp simd
-#endif
-                        for (int_t i = i_first; i < i_last; ++i) {
-                            m_it_domain.set_i_block_index(i);
-                            Stage::exec(m_it_domain);
-                        }
+                        exec_i_range<Stage>(m_it_domain, i_first, i_last);
                     }
                 }
+                meter.stop_region(i_last - i_first, j_last - j_first, std::abs(k_last - k_first) + 1);
             }
         };
 
@@ -97,17 +99,12 @@ namespace gridtools {
                 const int_t j_first = extent_t::jminus::value;
                 const int_t j_last = m_execution_info.j_block_size + extent_t::jplus::value;
 
+                stage_meter<Stage> meter;
                 for (int_t j = j_first; j < j_last; ++j) {
                     m_it_domain.set_j_block_index(j);
-#ifdef NDEBUG
-#pragma ivdep
-#pragma omp simd
-#endif
-                    for (int_t i = i_first; i < i_last; ++i) {
-                        m_it_domain.set_i_block_index(i);
-                        Stage::exec(m_it_domain);
-                    }
+                    exec_i_range<Stage>(m_it_domain, i_first, i_last);
                 }
+                meter.stop_region(i_last - i_first, j_last - j_first, 1);
             }
         };
 
@@ -163,6 +160,146 @@ namespace gridtools {
             }
         };
 
+
+        /**
+         * @brief Class for inner (block-level) looping on a single j-row.
+         * Specialization for stencils with serial execution along k-axis and k-caches.
+         */
+        template <typename ItDomain>
+        struct inner_functor_mc_kcached {
+            ItDomain &m_it_domain;
+            const execinfo_block_kserial_mc &m_execution_info;
+            int_t m_j;
+
+            /**
+             * @brief Executes the corresponding Stage on the current j-row and k-level, if the row is inside the
+             * extent of the stage.
+             */
+            template <class Stage>
+            GT_FORCE_INLINE void operator()(Stage) const {
+                using extent_t = typename Stage::extent_t;
+
+                if (m_j < extent_t::jminus::value || m_j >= m_execution_info.j_block_size + extent_t::jplus::value)
+                    return;
+
+                const int_t i_first = extent_t::iminus::value;
+                const int_t i_last = m_execution_info.i_block_size + extent_t::iplus::value;
+
+                exec_i_range<Stage>(m_it_domain, i_first, i_last);
+            }
+        };
+
+        template <class LoopInterval>
+        using loop_interval_stages = meta::flatten<meta::third<LoopInterval>>;
+
+        /**
+         * @brief The distinct stages of the given loop intervals.
+         */
+        template <class LoopIntervals>
+        using loop_intervals_stages = meta::dedup<meta::flatten<meta::transform<loop_interval_stages, LoopIntervals>>>;
+
+        /**
+         * @brief Adds the regions the stages of a loop interval are executed on in a block to a stage meter.
+         */
+        template <typename Meter, typename Grid>
+        struct add_stage_regions_f {
+            Meter &m_meter;
+            Grid const &m_grid;
+            execinfo_block_kserial_mc const &m_execution_info;
+
+            template <class From, class To, class StageGroups>
+            void operator()(loop_interval<From, To, StageGroups>) const {
+                const int_t k_first = m_grid.template value_at<From>();
+                const int_t k_last = m_grid.template value_at<To>();
+                const int_t nk = std::abs(k_last - k_first) + 1;
+                host::for_each<meta::flatten<StageGroups>>([&](auto stage) {
+                    using extent_t = typename decltype(stage)::extent_t;
+                    m_meter.template add_region<decltype(stage)>(
+                        m_execution_info.i_block_size + extent_t::iplus::value - extent_t::iminus::value,
+                        m_execution_info.j_block_size + extent_t::jplus::value - extent_t::jminus::value,
+                        nk);
+                });
+            }
+        };
+
+        /**
+         * @brief Class for per-row looping on a single interval.
+         * Specialization for stencils with serial execution along k-axis and k-caches: the k-loop is run over all
+         * stages of the interval, so that the cached values stay in the ring buffers between the stages.
+         */
+        template <typename ExecutionType, typename ItDomain, typename KCaches, typename Grid, typename LoopIntervals>
+        struct interval_functor_mc_kcached {
+            ItDomain &m_it_domain;
+            KCaches &m_k_caches;
+            Grid const &m_grid;
+            execinfo_block_kserial_mc const &m_execution_info;
+            int_t m_j;
+
+            template <class From, class To, class StageGroups>
+            GT_FORCE_INLINE void operator()(loop_interval<From, To, StageGroups>) const {
+                using iteration_policy_t = iteration_policy<From, To, ExecutionType>;
+                using loop_interval_t = loop_interval<From, To, StageGroups>;
+                using first_t = meta::first<LoopIntervals>;
+                using last_t = meta::last<LoopIntervals>;
+                constexpr bool is_first = std::is_same<loop_interval_t, first_t>::value;
+                constexpr bool is_last = std::is_same<loop_interval_t, last_t>::value;
+
+                const int_t k_first = m_grid.template value_at<From>();
+                const int_t k_last = m_grid.template value_at<To>();
+
+                // values might be read from all levels of the grid, but only the levels of the loop intervals are
+                // computed and written back
+                const int_t k_fill_min = m_grid.k_min();
+                const int_t k_fill_max = m_grid.k_max();
+                const int_t k_loop_first = m_grid.template value_at<meta::first<first_t>>();
+                const int_t k_loop_last = m_grid.template value_at<meta::second<last_t>>();
+                const int_t k_flush_min = std::min(k_loop_first, k_loop_last);
+                const int_t k_flush_max = std::max(k_loop_first, k_loop_last);
+
+                for (int_t k = k_first; iteration_policy_t::condition(k, k_last); iteration_policy_t::increment(k)) {
+                    m_it_domain.set_k_block_index(k);
+                    m_k_caches.template fill<ExecutionType>(
+                        m_it_domain, k_fill_min, k_fill_max, is_first && k == k_first);
+                    gridtools::for_each<meta::flatten<StageGroups>>(
+                        inner_functor_mc_kcached<ItDomain>{m_it_domain, m_execution_info, m_j});
+                    m_k_caches.template flush<ExecutionType>(
+                        m_it_domain, k_flush_min, k_flush_max, is_last && k == k_last);
+                    m_k_caches.template slide<ExecutionType>();
+                }
+            }
+        };
+
+        template <class Esfs>
+        struct is_j_dependency_f {
+            template <class Arg, class Param, class Extent = typename Param::extent_t>
+            using apply = bool_constant<meta::st_contains<compute_readwrite_args<Esfs>, Arg>::value &&
+                                        (Extent::jminus::value != 0 || Extent::jplus::value != 0)>;
+        };
+
+        template <class Esfs>
+        struct has_j_dependency_f {
+            template <class Esf>
+            using apply = meta::any<meta::transform<is_j_dependency_f<Esfs>::template apply,
+                typename Esf::args_t,
+                typename Esf::esf_function_t::param_list>>;
+        };
+
+        /**
+         * @brief Meta function to check if a stage of an MSS reads a field written in the same MSS with a j-offset.
+         */
+        template <class Esfs>
+        using has_j_dependencies = meta::any_of<has_j_dependency_f<Esfs>::template apply, Esfs>;
+
+        /**
+         * @brief Meta function to check if an MSS is executed with k-caches on a block.
+         *
+         * The k-caches are processed row by row, which is only valid if no stage reads a value computed by another
+         * stage in a different j-row; otherwise the k-caches are ignored and the block is executed stage by stage.
+         */
+        template <class RunFunctorArgs, class LocalDomain, class ExecutionInfo>
+        using has_k_caches = bool_constant<std::is_same<ExecutionInfo, execinfo_block_kserial_mc>::value &&
+                                           !meta::is_empty<k_caches<typename LocalDomain::cache_sequence_t>>::value &&
+                                           !has_j_dependencies<typename RunFunctorArgs::esf_sequence_t>::value>;
     } // namespace _impl_mss_loop_mc
 
     /**
@@ -170,7 +307,11 @@ namespace gridtools {
      * and sequentially executes all the functors in the mss
      * @tparam RunFunctorArgs run functor arguments
      */
-    template <class RunFunctorArgs, class LocalDomain, class Grid, class ExecutionInfo>
+    template <class RunFunctorArgs,
+        class LocalDomain,
+        class Grid,
+        class ExecutionInfo,
+        std::enable_if_t<!_impl_mss_loop_mc::has_k_caches<RunFunctorArgs, LocalDomain, ExecutionInfo>::value, int> = 0>
     GT_FORCE_INLINE static void mss_loop(
         backend::mc const &, LocalDomain const &local_domain, Grid const &grid, const ExecutionInfo &execution_info) {
         GT_STATIC_ASSERT(is_run_functor_arguments<RunFunctorArgs>::value, GT_INTERNAL_ERROR);
@@ -188,4 +329,48 @@ namespace gridtools {
                 interval_functor_mc<typename RunFunctorArgs::execution_type_t, iterate_domain_t, Grid, ExecutionInfo>{
                     it_domain, grid, execution_info});
     }
+
+    /**
+     * @brief main execution of a mss with k-caches. The block is processed row by row, each row is swept along the
+     * k-axis with all stages of the mss, using per-thread ring buffers for the cached fields.
+     * @tparam RunFunctorArgs run functor arguments
+     */
+    template <class RunFunctorArgs,
+        class LocalDomain,
+        class Grid,
+        class ExecutionInfo,
+        std::enable_if_t<_impl_mss_loop_mc::has_k_caches<RunFunctorArgs, LocalDomain, ExecutionInfo>::value, int> = 0>
+    GT_FORCE_INLINE static void mss_loop(
+        backend::mc const &, LocalDomain const &local_domain, Grid const &grid, const ExecutionInfo &execution_info) {
+        GT_STATIC_ASSERT(is_run_functor_arguments<RunFunctorArgs>::value, GT_INTERNAL_ERROR);
+        GT_STATIC_ASSERT(is_local_domain<LocalDomain>::value, GT_INTERNAL_ERROR);
+        GT_STATIC_ASSERT(is_grid<Grid>::value, GT_INTERNAL_ERROR);
+
+        using max_extent_t = typename RunFunctorArgs::max_extent_t;
+        using loop_intervals_t = typename RunFunctorArgs::loop_intervals_t;
+        using k_caches_t = k_caches_mc<typename LocalDomain::cache_sequence_t, typename RunFunctorArgs::esf_sequence_t>;
+        using iterate_domain_t = iterate_domain_mc<LocalDomain, meta::list<>, k_caches_t>;
+
+        k_caches_t k_caches(max_extent_t::iminus::value, execution_info.i_block_size + max_extent_t::iplus::value);
+        iterate_domain_t it_domain(local_domain, execution_info.i_first, execution_info.j_first, &k_caches);
+
+        // the stages are interleaved row by row, they are measured once for the whole block
+        interleaved_stage_meter<_impl_mss_loop_mc::loop_intervals_stages<loop_intervals_t>> meter;
+
+        const int_t j_first = max_extent_t::jminus::value;
+        const int_t j_last = execution_info.j_block_size + max_extent_t::jplus::value;
+        for (int_t j = j_first; j < j_last; ++j) {
+            it_domain.set_j_block_index(j);
+            host::for_each<loop_intervals_t>(
+                _impl_mss_loop_mc::interval_functor_mc_kcached<typename RunFunctorArgs::execution_type_t,
+                    iterate_domain_t,
+                    k_caches_t,
+                    Grid,
+                    loop_intervals_t>{it_domain, k_caches, grid, execution_info, j});
+        }
+
+        host::for_each<loop_intervals_t>(
+            _impl_mss_loop_mc::add_stage_regions_f<decltype(meter), Grid>{meter, grid, execution_info});
+        meter.stop();
+    }
 } // namespace gridtools
@@ -0,0 +1,213 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <cassert>
+#include <type_traits>
+
+#include "../../../common/defs.hpp"
+#include "../../../common/host_device.hpp"
+#include "../../../common/reduced_precision.hpp"
+#include "../../../common/simd_pack.hpp"
+#include "../../../meta.hpp"
+#include "../../../meta/type_traits.hpp"
+#include "../../accessor_intent.hpp"
+#include "../../bind_functor_with_interval.hpp"
+#include "../../iterate_domain_fwd.hpp"
+#include "../stage.hpp"
+
+#ifndef GT_MC_SIMD_LANES
+#define GT_MC_SIMD_LANES 8
+#endif
+
+/**
+ * @file
+ * Evaluation of stages on SIMD packs for the mc backend.
+ *
+ * Functors that declare `using simd = std::true_type;` are evaluated on packs of GT_MC_SIMD_LANES consecutive
+ * i-positions: accessors return `simd_pack`s (or `simd_ref`s for inout accessors) instead of scalars. Such functors
+ * must therefore be written generically: use `auto` for intermediate values, `select(condition, a, b)` instead of
+ * conditionals and the functions of `gridtools::math`. The remainder of a block is evaluated on a partial pack,
+ * only its active lanes are loaded and stored.
+ */
+namespace gridtools {
+    /**
+     * @brief Reference to the N values of a field at consecutive i-positions, holding the loaded values. Values of
+     * reduced precision types are widened when they are loaded and rounded when they are stored.
+     */
+    template <class T, int_t N>
+    class simd_ref : public simd_pack<widened_t<std::remove_const_t<T>>, N> {
+        using pack_t = simd_pack<widened_t<std::remove_const_t<T>>, N>;
+
+        T *m_ptr;
+        int_t m_stride;
+        int_t m_active;
+
+      public:
+        GT_FORCE_INLINE simd_ref(T *ptr, int_t stride, int_t active)
+            : pack_t(pack_t::load(ptr, stride, active)), m_ptr(ptr), m_stride(stride), m_active(active) {}
+
+        simd_ref(simd_ref const &) = default;
+
+        GT_FORCE_INLINE simd_ref &operator=(pack_t const &value) {
+            static_cast<pack_t &>(*this) = value;
+            value.store(m_ptr, m_stride, m_active);
+            return *this;
+        }
+
+        GT_FORCE_INLINE simd_ref &operator=(simd_ref const &other) {
+            return *this = static_cast<pack_t const &>(other);
+        }
+
+        template <class U, std::enable_if_t<!std::is_same<U, widened_t<std::remove_const_t<T>>>::value, int> = 0>
+        GT_FORCE_INLINE simd_ref &operator=(simd_pack<U, N> const &value) {
+            return *this = pack_t(value);
+        }
+
+        GT_FORCE_INLINE simd_ref &operator+=(pack_t const &value) { return *this = *this + value; }
+        GT_FORCE_INLINE simd_ref &operator-=(pack_t const &value) { return *this = *this - value; }
+        GT_FORCE_INLINE simd_ref &operator*=(pack_t const &value) { return *this = *this * value; }
+        GT_FORCE_INLINE simd_ref &operator/=(pack_t const &value) { return *this = *this / value; }
+    };
+
+    namespace math {
+        // without these, the generic overloads for equal argument types would be selected
+        template <class T, int_t N>
+        GT_FORCE_INLINE simd_pack<widened_t<std::remove_const_t<T>>, N> max(
+            simd_ref<T, N> const &lhs, simd_ref<T, N> const &rhs) {
+            return select(lhs > rhs, lhs, rhs);
+        }
+
+        template <class T, int_t N>
+        GT_FORCE_INLINE simd_pack<widened_t<std::remove_const_t<T>>, N> min(
+            simd_ref<T, N> const &lhs, simd_ref<T, N> const &rhs) {
+            return select(lhs < rhs, lhs, rhs);
+        }
+    } // namespace math
+
+    template <class T, int_t N>
+    struct apply_intent_type<intent::in, simd_ref<T, N> &&> {
+        using type = simd_pack<widened_t<std::remove_const_t<T>>, N>;
+    };
+
+    template <class T, int_t N>
+    struct apply_intent_type<intent::inout, simd_ref<T, N> &&> {
+        using type = simd_ref<T, N>;
+    };
+
+    /**
+     * @brief Checks if a functor declares `using simd = std::true_type;`.
+     */
+    template <class Functor, class = void>
+    struct is_simd_functor : std::false_type {};
+
+    template <class Functor>
+    struct is_simd_functor<Functor, void_t<typename Functor::simd>> : bool_constant<Functor::simd::value> {};
+
+    template <class Functor, class Interval>
+    struct is_simd_functor<_impl::bound_functor<Functor, Interval>> : is_simd_functor<Functor> {};
+
+    /**
+     * @brief Checks if a stage should be evaluated on SIMD packs, i.e. if all its functors declare `simd`.
+     */
+    template <class Stage>
+    struct is_simd_stage : std::false_type {};
+
+    template <class Functor, class Extent, class Args>
+    struct is_simd_stage<regular_stage<Functor, Extent, Args>> : is_simd_functor<Functor> {};
+
+    template <class... Stages>
+    struct is_simd_stage<compound_stage<Stages...>> : conjunction<is_simd_stage<Stages>...> {};
+
+    /**
+     * @brief Iterate domain that evaluates a stage on the N i-positions following the current one of the wrapped mc
+     * iterate domain, of which only the first `active` ones are loaded and stored.
+     */
+    template <class ItDomain, int_t N>
+    class simd_iterate_domain_mc {
+        ItDomain const &m_it_domain;
+        int_t m_active;
+
+        template <class Arg,
+            class T,
+            std::enable_if_t<std::is_arithmetic<T>::value || is_reduced_precision<std::remove_const_t<T>>::value, int> =
+                0>
+        GT_FORCE_INLINE simd_ref<T, N> make_ref(T &ref) const {
+            return {&ref, m_it_domain.template i_stride<Arg>(), m_active};
+        }
+
+        // values of other types, like user-defined global parameters, are shared by all lanes
+        template <class Arg,
+            class T,
+            std::enable_if_t<!std::is_arithmetic<T>::value && !is_reduced_precision<std::remove_const_t<T>>::value,
+                int> = 0>
+        GT_FORCE_INLINE T &make_ref(T &ref) const {
+            return ref;
+        }
+
+      public:
+        GT_FORCE_INLINE simd_iterate_domain_mc(ItDomain const &it_domain, int_t active)
+            : m_it_domain(it_domain), m_active(active) {
+            assert(active > 0 && active <= N);
+        }
+
+        template <class Arg, class Accessor>
+        GT_FORCE_INLINE auto deref(Accessor const &accessor) const {
+            return make_ref<Arg>(m_it_domain.template deref<Arg>(accessor));
+        }
+
+        GT_FORCE_INLINE simd_pack<int_t, N> i() const { return simd_pack<int_t, N>::iota(m_it_domain.i()); }
+        GT_FORCE_INLINE int_t j() const { return m_it_domain.j(); }
+        GT_FORCE_INLINE int_t k() const { return m_it_domain.k(); }
+    };
+
+    template <class ItDomain, int_t N>
+    struct is_iterate_domain<simd_iterate_domain_mc<ItDomain, N>> : std::true_type {};
+
+    namespace _impl_mss_loop_mc {
+        // packs are loaded from consecutive elements, which is not possible across the tiles of tiled storages
+        template <class Stage, class ItDomain>
+        using use_simd =
+            bool_constant<is_simd_stage<Stage>::value && !ItDomain::has_k_caches && !ItDomain::has_tiled_args>;
+
+        /**
+         * @brief Executes the stage on the i-positions [i_first, i_last) of the current j-row and k-level.
+         */
+        template <class Stage, class ItDomain, std::enable_if_t<!use_simd<Stage, ItDomain>::value, int> = 0>
+        GT_FORCE_INLINE void exec_i_range(ItDomain &it_domain, int_t i_first, int_t i_last) {
+#ifdef NDEBUG
+#pragma ivdep
+#pragma omp simd
+#endif
+            for (int_t i = i_first; i < i_last; ++i) {
+                it_domain.set_i_block_index(i);
+                Stage::exec(it_domain);
+            }
+        }
+
+        /**
+         * @brief Executes the stage on the i-positions [i_first, i_last) of the current j-row and k-level, in packs of
+         * GT_MC_SIMD_LANES positions and a partial pack for the remainder.
+         */
+        template <class Stage, class ItDomain, std::enable_if_t<use_simd<Stage, ItDomain>::value, int> = 0>
+        GT_FORCE_INLINE void exec_i_range(ItDomain &it_domain, int_t i_first, int_t i_last) {
+            constexpr int_t lanes = GT_MC_SIMD_LANES;
+            int_t i = i_first;
+            for (; i + lanes <= i_last; i += lanes) {
+                it_domain.set_i_block_index(i);
+                Stage::exec(simd_iterate_domain_mc<ItDomain, lanes>(it_domain, lanes));
+            }
+            if (i < i_last) {
+                it_domain.set_i_block_index(i);
+                Stage::exec(simd_iterate_domain_mc<ItDomain, lanes>(it_domain, i_last - i));
+            }
+        }
+    } // namespace _impl_mss_loop_mc
+} // namespace gridtools
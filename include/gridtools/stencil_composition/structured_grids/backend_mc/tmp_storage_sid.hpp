@@ -9,12 +9,13 @@
  */
 #pragma once
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 
 #include <omp.h>
 
-#include "../../../common/hugepage_alloc.hpp"
+#include "../../../common/caching_arena.hpp"
 #include "../../../common/hymap.hpp"
 #include "../../dim.hpp"
 #include "../../pos3.hpp"
@@ -101,42 +102,89 @@ namespace gridtools {
             return {integral_constant<int, 1>{}, bs.i, bs.i * bs.j};
         }
 
+        /**
+         * @brief Offset from the start of a per-thread slice to its first element inside compute domain.
+         */
+        template <class T, class Extent>
+        std::size_t unaligned_origin_offset(pos3<std::size_t> const &block_size) {
+            auto st = strides<T, Extent>(block_size);
+            return sid::get_stride<dim::i>(st) * -Extent::iminus::value +
+                   sid::get_stride<dim::j>(st) * -Extent::jminus::value +
+                   sid::get_stride<dim::k>(st) * -Extent::kminus::value;
+        }
+
         /**
          * @brief Offset from allocation start to first element inside compute domain.
          */
         template <class T, class Extent>
         std::size_t origin_offset(pos3<std::size_t> const &block_size) {
-            auto st = strides<T, Extent>(block_size);
-            std::size_t offset = sid::get_stride<dim::i>(st) * -Extent::iminus::value +
-                                 sid::get_stride<dim::j>(st) * -Extent::jminus::value +
-                                 sid::get_stride<dim::k>(st) * -Extent::kminus::value;
             // Add padding at the start of the allocation to align the first element inside the domain
-            return pad<T>(offset);
+            return pad<T>(unaligned_origin_offset<T, Extent>(block_size));
+        }
+
+        /**
+         * @brief Default-initializes the per-thread slices of a temporary buffer by their owning threads, such that the
+         * memory pages are placed close to them. The slices start `shift` elements after the start of the allocation,
+         * the padding at the start is touched by the first thread and the padding at the end by the last thread.
+         */
+        template <class T>
+        void first_touch(T *ptr, std::size_t size, std::size_t thread_stride, std::size_t shift) {
+#pragma omp parallel
+            {
+                const std::size_t thread = omp_get_thread_num();
+                const std::size_t first = thread == 0 ? 0 : std::min(shift + thread * thread_stride, size);
+                const std::size_t last = thread + 1 == (std::size_t)omp_get_num_threads()
+                                             ? size
+                                             : std::min(shift + (thread + 1) * thread_stride, size);
+                for (std::size_t i = first; i < last; ++i)
+                    ptr[i] = T();
+            }
         }
 
     } // namespace _impl_tmp_mc
 
     /**
-     * @brief Simple allocator for temporaries.
+     * @brief Simple allocator for temporaries, allocates through the active caching arena (see caching_arena_scope), if
+     * any.
      */
     class tmp_allocator_mc {
-        using deleter_t = std::integral_constant<decltype(&hugepage_free), &hugepage_free>;
-        std::vector<std::unique_ptr<void, deleter_t>> m_ptrs;
+        std::vector<arena_ptr> m_ptrs;
 
       public:
         template <class T>
         sid::host::simple_ptr_holder<T *> allocate(std::size_t n) {
-            m_ptrs.emplace_back(hugepage_alloc(n * sizeof(T)));
+            m_ptrs.push_back(arena_allocate(n * sizeof(T), hugepage_upstream()));
             return {static_cast<T *>(m_ptrs.back().get())};
         };
+
+        /**
+         * @brief Huge page strategy and coverage of the allocations, in allocation order.
+         */
+        std::vector<hugepage_allocation_info> hugepage_info() const {
+            std::vector<hugepage_allocation_info> res;
+            for (auto const &ptr : m_ptrs)
+                res.push_back(gridtools::hugepage_info(ptr.get()));
+            return res;
+        }
     };
 
+    /**
+     * @brief Temporary buffer with one slice per thread. If GT_MC_FIRST_TOUCH is defined, the slices are first touched
+     * by their owning threads.
+     */
     template <class T, class Extent, class Allocator>
     auto make_tmp_storage_mc(Allocator &allocator, pos3<std::size_t> const &block_size) {
+        auto ptr_holder = allocator.template allocate<T>(_impl_tmp_mc::storage_size<T, Extent>(block_size));
+#ifdef GT_MC_FIRST_TOUCH
+        auto bs = _impl_tmp_mc::full_block_size<T, Extent>(block_size);
+        _impl_tmp_mc::first_touch(ptr_holder(),
+            _impl_tmp_mc::storage_size<T, Extent>(block_size),
+            bs.i * bs.j * bs.k,
+            _impl_tmp_mc::origin_offset<T, Extent>(block_size) -
+                _impl_tmp_mc::unaligned_origin_offset<T, Extent>(block_size));
+#endif
         return sid::synthetic()
-            .set<sid::property::origin>(
-                allocator.template allocate<T>(_impl_tmp_mc::storage_size<T, Extent>(block_size)) +
-                _impl_tmp_mc::origin_offset<T, Extent>(block_size))
+            .set<sid::property::origin>(ptr_holder + _impl_tmp_mc::origin_offset<T, Extent>(block_size))
             .template set<sid::property::strides>(_impl_tmp_mc::strides<T, Extent>(block_size))
             .template set<sid::property::strides_kind, _impl_tmp_mc::strides_kind<T, Extent>>()
             .template set<sid::property::ptr_diff, int_t>();
@@ -64,9 +64,9 @@ namespace gridtools {
                 return expressions::evaluation::value(*this, arg);
             }
 
-            GT_FUNCTION int_t i() const { return m_it_domain.i(); }
-            GT_FUNCTION int_t j() const { return m_it_domain.j(); }
-            GT_FUNCTION int_t k() const { return m_it_domain.k(); }
+            GT_FUNCTION auto i() const { return m_it_domain.i(); }
+            GT_FUNCTION auto j() const { return m_it_domain.j(); }
+            GT_FUNCTION auto k() const { return m_it_domain.k(); }
         };
     } // namespace impl_
 
@@ -0,0 +1,197 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <tuple>
+#include <type_traits>
+
+#include "../common/defs.hpp"
+#include "../common/halo_descriptor.hpp"
+#include "../common/tuple_util.hpp"
+#include "../meta.hpp"
+#include "arg.hpp"
+#include "compute_extents_metafunctions.hpp"
+#include "intermediate_impl.hpp"
+
+/**
+ * @file
+ * Multi-step execution of a computation with temporal blocking, see `intermediate::run_steps`.
+ */
+namespace gridtools {
+    /**
+     * @brief Describes which data stores are swapped after each time step of `intermediate::run_steps`.
+     *
+     * @tparam Pairs `meta::list<In, Out>` of placeholders: the step reads `In` and writes `Out`, afterwards the data
+     * stores bound to them are exchanged.
+     */
+    template <class... Pairs>
+    class swap_spec {
+        int_t m_tile_size = 0;
+
+      public:
+        /**
+         * @brief Sets the number of j-rows per tile of the temporal blocking, 0 chooses it automatically.
+         */
+        swap_spec tile_size(int_t value) const {
+            swap_spec res = *this;
+            res.m_tile_size = value;
+            return res;
+        }
+
+        int_t tile_size() const { return m_tile_size; }
+    };
+
+    namespace _impl {
+        namespace temporal_blocking {
+            template <class... Plhs>
+            struct make_pairs {
+                GT_STATIC_ASSERT(sizeof...(Plhs) == 0, "make_swap_spec takes pairs of placeholders");
+                using type = meta::list<>;
+            };
+
+            template <class In, class Out, class... Plhs>
+            struct make_pairs<In, Out, Plhs...> {
+                using type = meta::push_front<typename make_pairs<Plhs...>::type, meta::list<In, Out>>;
+            };
+
+            /**
+             * @brief The distance in j by which a step depends on the previous one: the j-extent of the `In` and `Out`
+             * placeholders, as computed by `get_extent_map`.
+             */
+            template <class ExtentMap>
+            struct get_skew_f {
+                template <class Pair,
+                    class Extent = enclosing_extent<lookup_extent_map<ExtentMap, meta::first<Pair>>,
+                        lookup_extent_map<ExtentMap, meta::second<Pair>>>,
+                    int_t Minus = -Extent::jminus::value,
+                    int_t Plus = Extent::jplus::value>
+                using apply = std::integral_constant<int_t, (Minus > Plus ? Minus : Plus)>;
+            };
+
+            template <class ExtentMap, class... Pairs>
+            constexpr int_t get_skew() {
+                return std::max({int_t(0), get_skew_f<ExtentMap>::template apply<Pairs>::value...});
+            }
+
+            template <class Arg>
+            struct is_negative_j_read_f {
+                template <class EsfArg, class Param, class Extent = typename Param::extent_t>
+                using apply = bool_constant<std::is_same<EsfArg, Arg>::value && (Extent::jminus::value < 0)>;
+            };
+
+            template <class Arg>
+            struct has_negative_j_read_f {
+                template <class Esf>
+                using apply = meta::any<meta::transform<is_negative_j_read_f<Arg>::template apply,
+                    typename Esf::args_t,
+                    typename Esf::esf_function_t::param_list>>;
+            };
+
+            /**
+             * @brief Meta function to check if a stage reads `Arg` at a negative j-offset. When `Arg` is the `Out`
+             * placeholder of a pair, the row may already hold the value of the current step, written by the preceding
+             * tile.
+             */
+            template <class Esfs, class Arg>
+            using is_read_at_negative_j = meta::any_of<has_negative_j_read_f<Arg>::template apply, Esfs>;
+
+            /**
+             * @brief Calls `f(step, j_first, j_last)` for the tiles of a parallelogram (time-skewed) tiling along j,
+             * in an order that respects the dependencies between the steps.
+             *
+             * At step `s` tile `t` covers `[j_first + t * tile - s * skew, j_first + (t + 1) * tile - s * skew)`
+             * clipped to the domain. With `skew` not smaller than the j-extent of one step, the tile only depends on
+             * data produced by itself and the preceding tiles, and no later write of the preceding tiles overwrites
+             * data it still needs from the ping-pong buffers. Hence, exactly the values of the step-by-step execution
+             * are computed, while each tile keeps its data in cache over all steps.
+             */
+            template <class F>
+            void for_each_tile_step(int_t steps, int_t j_first, int_t j_last, int_t skew, int_t tile, F &&f) {
+                assert(tile > 0);
+                for (int_t base = j_first; base - (steps - 1) * skew <= j_last; base += tile)
+                    for (int_t step = 0; step < steps; ++step) {
+                        int_t first = std::max(base - step * skew, j_first);
+                        int_t last = std::min(base + tile - 1 - step * skew, j_last);
+                        if (first <= last)
+                            f(step, first, last);
+                    }
+            }
+
+            /**
+             * @brief The data stores of a swapped pair of placeholders.
+             */
+            template <class In, class Out>
+            struct buffers {
+                GT_STATIC_ASSERT((std::is_same<typename In::data_store_t, typename Out::data_store_t>::value),
+                    "swapped placeholders should have the same data store type");
+                using data_store_t = typename In::data_store_t;
+
+                data_store_t m_first;
+                data_store_t m_second;
+
+                /**
+                 * @brief Binds the data stores to the local domains as seen by an even or odd step.
+                 */
+                template <class LocalDomains>
+                void bind(bool odd, LocalDomains &local_domains) const {
+                    update_local_domains(std::make_tuple(arg_storage_pair<In, data_store_t>(odd ? m_second : m_first),
+                                             arg_storage_pair<Out, data_store_t>(odd ? m_first : m_second)),
+                        local_domains);
+                }
+            };
+
+            template <class Arg>
+            struct find_data_store_f {
+                typename Arg::data_store_t const *&m_dst;
+
+                void operator()(arg_storage_pair<Arg, typename Arg::data_store_t> const &src) const {
+                    m_dst = &src.m_value;
+                }
+                template <class T>
+                void operator()(T const &) const {}
+            };
+
+            /**
+             * @brief Finds the data store bound to `Arg` in the given tuples of arg_storage_pairs.
+             */
+            template <class Arg, class... ArgStoragePairTuples>
+            typename Arg::data_store_t const &find_data_store(ArgStoragePairTuples const &... srcs) {
+                typename Arg::data_store_t const *res = nullptr;
+                tuple_util::for_each([&](auto const &src) { tuple_util::for_each(find_data_store_f<Arg>{res}, src); },
+                    std::tie(srcs...));
+                assert(res);
+                return *res;
+            }
+
+            template <class Grid>
+            Grid sub_grid(Grid const &grid, int_t j_first, int_t j_last) {
+                return Grid(grid.direction_i(),
+                    halo_descriptor(0, 0, j_first, j_last, grid.direction_j().total_length()),
+                    grid.value_list);
+            }
+
+            /**
+             * @brief The default tile size: enough rows to keep all threads busy and at least a few skews.
+             */
+            inline int_t default_tile_size(int_t skew) { return std::max<int_t>(omp_get_max_threads(), 4 * skew); }
+        } // namespace temporal_blocking
+    }     // namespace _impl
+
+    /**
+     * @brief Creates the swap specification for `intermediate::run_steps` from pairs of placeholders `in, out`.
+     */
+    template <class... Plhs>
+    meta::rename<swap_spec, typename _impl::temporal_blocking::make_pairs<Plhs...>::type> make_swap_spec(Plhs...) {
+        GT_STATIC_ASSERT(conjunction<is_plh<Plhs>...>::value, "make_swap_spec takes placeholders");
+        return {};
+    }
+} // namespace gridtools
@@ -0,0 +1,291 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <type_traits>
+
+#include "../common/array.hpp"
+#include "../common/defs.hpp"
+#include "../common/gt_assert.hpp"
+#include "../meta/type_traits.hpp"
+#include "./common/storage_info.hpp"
+#include "./data_store.hpp"
+#include "./storage_host/host_storage.hpp"
+#include "./storage_mc/first_touch_mc.hpp"
+#include "./storage_mc/mc_storage.hpp"
+
+/**@file
+ * @brief Parallel bulk operations (fill, copy, axpy) on the host memory of data stores.
+ *
+ * The points of the destination are visited row by row along its stride-one dimension, so the inner loops are
+ * contiguous and vectorized, and no coordinates are computed per element. The rows are distributed among the threads
+ * in the same way as the backend of the storage distributes the points when running stencils (see
+ * `for_each_point_block`), such that the operations touch the memory from the same threads as the stencils.
+ */
+namespace gridtools {
+
+    /** \ingroup storage
+     * @{
+     */
+
+    namespace _impl_bulk_operations {
+        template <class StorageInfo>
+        using coords_t = array<int_t, StorageInfo::ndims>;
+
+        template <class StorageInfo>
+        coords_t<StorageInfo> points_end(StorageInfo const &info) {
+            coords_t<StorageInfo> res;
+            for (std::size_t d = 0; d < StorageInfo::ndims; ++d)
+                res[d] = info.strides()[d] ? info.total_lengths()[d] : 1;
+            return res;
+        }
+
+        /**
+         * @brief Splits the points of the storage along its outermost dimension, the slices are distributed among the
+         * threads in contiguous chunks.
+         */
+        template <class StorageInfo, class F>
+        void split_outermost_dim(StorageInfo const &info, F const &f) {
+            using layout_t = typename StorageInfo::layout_t;
+            const coords_t<StorageInfo> end = points_end(info);
+            if (layout_t::unmasked_length < 2) {
+                f(coords_t<StorageInfo>{}, end);
+                return;
+            }
+            const int_t dim = layout_t::find(0);
+            const int_t length = end[dim];
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+            for (int_t i = 0; i < length; ++i) {
+                coords_t<StorageInfo> first = {};
+                coords_t<StorageInfo> last = end;
+                first[dim] = i;
+                last[dim] = i + 1;
+                f(first, last);
+            }
+        }
+
+        /**
+         * @brief Calls `f(offset, coords, n)` for the rows of n points along the stride-one dimension of the storage
+         * that make up the box `[first, last)`, in layout order. `coords` are the coordinates of the first point and
+         * `offset` is its index in the storage.
+         */
+        template <class StorageInfo, class F>
+        void for_each_row(
+            StorageInfo const &info, coords_t<StorageInfo> const &first, coords_t<StorageInfo> const &last, F &&f) {
+            using layout_t = typename StorageInfo::layout_t;
+            constexpr int_t ndims = StorageInfo::ndims;
+            for (int_t d = 0; d < ndims; ++d)
+                if (first[d] >= last[d])
+                    return;
+            const int_t inner = layout_t::unmasked_length ? layout_t::find(layout_t::unmasked_length - 1) : -1;
+            const int_t n = inner < 0 ? 1 : last[inner] - first[inner];
+            coords_t<StorageInfo> pos = first;
+            while (true) {
+                f(info.index(pos), pos, n);
+                // next row: increment the coordinates of the other dimensions, the fastest first
+                int_t l = layout_t::unmasked_length - 2;
+                for (; l >= 0; --l) {
+                    const int_t d = layout_t::find(l);
+                    if (++pos[d] < last[d])
+                        break;
+                    pos[d] = first[d];
+                }
+                if (l < 0)
+                    return;
+            }
+        }
+
+        /**
+         * @brief Stride of `info` along the stride-one dimension of `Dst`, i.e., along the rows of `for_each_row`.
+         */
+        template <class Dst, class StorageInfo>
+        int_t row_stride(StorageInfo const &info) {
+            using layout_t = typename Dst::layout_t;
+            return layout_t::unmasked_length ? info.strides()[layout_t::find(layout_t::unmasked_length - 1)] : 0;
+        }
+
+        template <class StorageInfo>
+        struct is_strided_storage_info : std::false_type {};
+
+        template <uint_t Id, class Layout, class Halo, class Alignment, class Padding>
+        struct is_strided_storage_info<storage_info<Id, Layout, Halo, Alignment, Padding>> : std::true_type {};
+
+        template <class DataStore>
+        using is_bulk_data_store = bool_constant<is_data_store<DataStore>::value &&
+                                                 (is_host_storage<typename DataStore::storage_t>::value ||
+                                                     is_mc_storage<typename DataStore::storage_t>::value) &&
+                                                 is_strided_storage_info<typename DataStore::storage_info_t>::value>;
+
+        template <class Initializer, class StorageInfo, size_t... Is>
+        auto call_initializer(
+            Initializer const &initializer, coords_t<StorageInfo> const &pos, std::index_sequence<Is...>) {
+            return initializer(pos[Is]...);
+        }
+    } // namespace _impl_bulk_operations
+
+    /**
+     * @brief Calls `f(first, last)` in parallel for boxes of points `[first, last)` (arrays of coordinates) that
+     * partition the points of the storage. Storages can provide overloads to control which thread processes which
+     * points, by default the outermost dimension is split among the threads.
+     */
+    template <class Storage, class StorageInfo, class F>
+    void for_each_point_block(Storage const &, StorageInfo const &info, F const &f) {
+        _impl_bulk_operations::split_outermost_dim(info, f);
+    }
+
+    /**
+     * @brief Version for mc storages, the boxes are the blocks that `execinfo_mc` gives for the inner region of the
+     * storage and are processed by the threads that run them in the stencils (see `for_each_block_mc`).
+     */
+    template <class DataType, class StorageInfo, class F, std::enable_if_t<(StorageInfo::ndims >= 2), int> = 0>
+    void for_each_point_block(mc_storage<DataType> const &, StorageInfo const &info, F const &f) {
+        if (info.template stride<1>() != 0)
+            for_each_block_mc(info, f);
+        else
+            _impl_bulk_operations::split_outermost_dim(info, f);
+    }
+
+    /**
+     * @brief Sets all points (including the halo) of the data store to `value`.
+     */
+    template <class DataStore, std::enable_if_t<_impl_bulk_operations::is_bulk_data_store<DataStore>::value, int> = 0>
+    void fill(DataStore &dst, typename DataStore::data_t const &value) {
+        GT_ASSERT_OR_THROW(dst.valid(), "The data store is not allocated.");
+        using data_t = typename DataStore::data_t;
+        auto const &info = dst.info();
+        data_t *ptr = dst.get_storage_ptr()->get_cpu_ptr();
+        for_each_point_block(*dst.get_storage_ptr(), info, [&](auto const &first, auto const &last) {
+            _impl_bulk_operations::for_each_row(info, first, last, [&](int_t offset, auto const &, int_t n) {
+                data_t *GT_RESTRICT row = ptr + offset;
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+                for (int_t i = 0; i < n; ++i)
+                    row[i] = value;
+            });
+        });
+    }
+
+    /**
+     * @brief Sets all points (including the halo) of the data store to `initializer(i, j, k, ...)`.
+     */
+    template <class DataStore,
+        class Initializer,
+        std::enable_if_t<_impl_bulk_operations::is_bulk_data_store<DataStore>::value &&
+                             !std::is_convertible<Initializer, typename DataStore::data_t const &>::value,
+            int> = 0>
+    void fill(DataStore &dst, Initializer const &initializer) {
+        GT_ASSERT_OR_THROW(dst.valid(), "The data store is not allocated.");
+        using data_t = typename DataStore::data_t;
+        using storage_info_t = typename DataStore::storage_info_t;
+        using layout_t = typename storage_info_t::layout_t;
+        auto const &info = dst.info();
+        data_t *ptr = dst.get_storage_ptr()->get_cpu_ptr();
+        for_each_point_block(*dst.get_storage_ptr(), info, [&](auto const &first, auto const &last) {
+            _impl_bulk_operations::for_each_row(info, first, last, [&](int_t offset, auto pos, int_t n) {
+                const int_t inner = layout_t::unmasked_length ? layout_t::find(layout_t::unmasked_length - 1) : 0;
+                const int_t start = pos[inner];
+                for (int_t i = 0; i < n; ++i) {
+                    pos[inner] = start + i;
+                    ptr[offset + i] = _impl_bulk_operations::call_initializer<Initializer, storage_info_t>(
+                        initializer, pos, std::make_index_sequence<storage_info_t::ndims>());
+                }
+            });
+        });
+    }
+
+    /**
+     * @brief Copies all points (including the halo) of `src` to `dst`. The data stores need to have the same total
+     * lengths, but can differ in layout, alignment, halo (as long as it fits) and data type.
+     */
+    template <class Src,
+        class Dst,
+        std::enable_if_t<_impl_bulk_operations::is_bulk_data_store<Src>::value &&
+                             _impl_bulk_operations::is_bulk_data_store<Dst>::value,
+            int> = 0>
+    void copy(Src const &src, Dst &dst) {
+        GT_ASSERT_OR_THROW(src.valid() && dst.valid(), "The data stores are not allocated.");
+        GT_STATIC_ASSERT(Src::storage_info_t::ndims == Dst::storage_info_t::ndims,
+            "The data stores need to have the same number of dimensions.");
+        GT_ASSERT_OR_THROW(src.info().total_lengths() == dst.info().total_lengths(),
+            "The data stores need to have the same total lengths.");
+        using src_t = typename Src::data_t;
+        using dst_t = typename Dst::data_t;
+        auto const &src_info = src.info();
+        auto const &dst_info = dst.info();
+        src_t const *src_ptr = src.get_storage_ptr()->get_cpu_ptr();
+        dst_t *dst_ptr = dst.get_storage_ptr()->get_cpu_ptr();
+        const int_t src_stride = _impl_bulk_operations::row_stride<typename Dst::storage_info_t>(src_info);
+        for_each_point_block(*dst.get_storage_ptr(), dst_info, [&](auto const &first, auto const &last) {
+            _impl_bulk_operations::for_each_row(dst_info, first, last, [&](int_t offset, auto const &pos, int_t n) {
+                dst_t *GT_RESTRICT dst_row = dst_ptr + offset;
+                src_t const *GT_RESTRICT src_row = src_ptr + src_info.index(pos);
+                if (src_stride == 1) {
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+                    for (int_t i = 0; i < n; ++i)
+                        dst_row[i] = static_cast<dst_t>(src_row[i]);
+                } else {
+                    for (int_t i = 0; i < n; ++i)
+                        dst_row[i] = static_cast<dst_t>(src_row[i * src_stride]);
+                }
+            });
+        });
+    }
+
+    /**
+     * @brief Computes `y = a * x + y` for all points (including the halo). The data stores need to have the same
+     * total lengths, but can differ in layout, alignment and halo (as long as it fits).
+     */
+    template <class X,
+        class Y,
+        std::enable_if_t<_impl_bulk_operations::is_bulk_data_store<X>::value &&
+                             _impl_bulk_operations::is_bulk_data_store<Y>::value,
+            int> = 0>
+    void axpy(typename Y::data_t a, X const &x, Y &y) {
+        GT_ASSERT_OR_THROW(x.valid() && y.valid(), "The data stores are not allocated.");
+        GT_STATIC_ASSERT(X::storage_info_t::ndims == Y::storage_info_t::ndims,
+            "The data stores need to have the same number of dimensions.");
+        GT_ASSERT_OR_THROW(x.info().total_lengths() == y.info().total_lengths(),
+            "The data stores need to have the same total lengths.");
+        using x_t = typename X::data_t;
+        using y_t = typename Y::data_t;
+        auto const &x_info = x.info();
+        auto const &y_info = y.info();
+        x_t const *x_ptr = x.get_storage_ptr()->get_cpu_ptr();
+        y_t *y_ptr = y.get_storage_ptr()->get_cpu_ptr();
+        const int_t x_stride = _impl_bulk_operations::row_stride<typename Y::storage_info_t>(x_info);
+        for_each_point_block(*y.get_storage_ptr(), y_info, [&](auto const &first, auto const &last) {
+            _impl_bulk_operations::for_each_row(y_info, first, last, [&](int_t offset, auto const &pos, int_t n) {
+                y_t *GT_RESTRICT y_row = y_ptr + offset;
+                x_t const *GT_RESTRICT x_row = x_ptr + x_info.index(pos);
+                if (x_stride == 1) {
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+                    for (int_t i = 0; i < n; ++i)
+                        y_row[i] = a * x_row[i] + y_row[i];
+                } else {
+                    for (int_t i = 0; i < n; ++i)
+                        y_row[i] = a * x_row[i * x_stride] + y_row[i];
+                }
+            });
+        });
+    }
+
+    /**
+     * @}
+     */
+} // namespace gridtools
@@ -0,0 +1,277 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include "../../common/demangle.hpp"
+
+/**
+ * @file
+ * Accounting of the memory held by data stores and by the temporaries of computations.
+ *
+ * If GT_ENABLE_MEMORY_REGISTRY is defined, data stores register the storages they allocate with
+ * `memory_registry::instance()` until the last data store sharing the storage is destroyed, and computations register
+ * the storages of their temporaries for their lifetime. Otherwise the accounting is compiled out.
+ */
+namespace gridtools {
+    /**
+     * @brief Memory held by the storages of a data store name, a storage type or a computation.
+     */
+    struct memory_record {
+        std::string name;                  /** Data store name, storage type or computation. */
+        std::size_t bytes = 0;             /** Bytes currently held. */
+        std::size_t peak_bytes = 0;        /** Maximum of `bytes` since the last `reset_peaks`. */
+        std::size_t allocations = 0;       /** Number of storages currently held. */
+        std::size_t total_allocations = 0; /** Number of storages registered so far. */
+        std::size_t domain_bytes = 0;      /** Computations only: bytes needed by the temporaries for the grid. */
+    };
+
+    namespace _impl_memory_registry {
+        using record_map = std::map<std::string, memory_record>;
+
+        inline memory_record &add(record_map &records, std::string const &name, std::size_t bytes) {
+            memory_record &record = records[name];
+            record.name = name;
+            record.bytes += bytes;
+            record.peak_bytes = std::max(record.peak_bytes, record.bytes);
+            ++record.allocations;
+            ++record.total_allocations;
+            return record;
+        }
+
+        inline void remove(record_map &records, std::string const &name, std::size_t bytes) {
+            memory_record &record = records[name];
+            record.bytes -= bytes;
+            --record.allocations;
+        }
+
+        inline std::vector<memory_record> sorted(record_map const &records) {
+            std::vector<memory_record> res;
+            for (auto const &item : records)
+                res.push_back(item.second);
+            std::stable_sort(res.begin(), res.end(), [](memory_record const &lhs, memory_record const &rhs) {
+                return lhs.peak_bytes > rhs.peak_bytes;
+            });
+            return res;
+        }
+
+        inline void write_json(std::ostream &out, std::vector<memory_record> const &records) {
+            out << "[";
+            bool first = true;
+            for (auto const &record : records) {
+                out << (first ? "" : ",") << "\n    {\"name\": \"";
+                for (char c : record.name)
+                    out << (c == '"' || c == '\\' ? "\\" : "") << c;
+                out << "\", \"bytes\": " << record.bytes << ", \"peak_bytes\": " << record.peak_bytes
+                    << ", \"allocations\": " << record.allocations
+                    << ", \"total_allocations\": " << record.total_allocations;
+                if (record.domain_bytes)
+                    out << ", \"domain_bytes\": " << record.domain_bytes;
+                out << "}";
+                first = false;
+            }
+            out << (first ? "]" : "\n  ]");
+        }
+    } // namespace _impl_memory_registry
+
+    /**
+     * @brief Process-wide registry of the live storages, by data store name, by storage type and by computation.
+     *
+     * The totals count every storage once. The temporaries of computations are data stores as well, so the records of
+     * the computations show which part of the total is held by temporaries. Storages that wrap external pointers or
+     * that are passed to a data store ready-made (e.g., file-backed storages) are not counted.
+     */
+    class memory_registry {
+        mutable std::mutex m_mutex;
+        _impl_memory_registry::record_map m_names;
+        _impl_memory_registry::record_map m_storage_types;
+        _impl_memory_registry::record_map m_computations;
+        std::size_t m_bytes = 0;
+        std::size_t m_peak_bytes = 0;
+        std::size_t m_computation_count = 0;
+
+        memory_registry() = default;
+
+      public:
+        static memory_registry &instance() {
+            static memory_registry res;
+            return res;
+        }
+
+        /**
+         * @brief Registers a storage of `bytes` bytes held by data stores with the given name.
+         */
+        void add_storage(std::string const &name, std::string const &storage_type, std::size_t bytes) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            _impl_memory_registry::add(m_names, name.empty() ? "<unnamed>" : name, bytes);
+            _impl_memory_registry::add(m_storage_types, storage_type, bytes);
+            m_bytes += bytes;
+            m_peak_bytes = std::max(m_peak_bytes, m_bytes);
+        }
+
+        void remove_storage(std::string const &name, std::string const &storage_type, std::size_t bytes) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            _impl_memory_registry::remove(m_names, name.empty() ? "<unnamed>" : name, bytes);
+            _impl_memory_registry::remove(m_storage_types, storage_type, bytes);
+            m_bytes -= bytes;
+        }
+
+        /**
+         * @brief Registers the temporaries of a new computation, returns the name of its record.
+         */
+        std::string add_computation(std::size_t bytes, std::size_t domain_bytes) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            std::string name = "computation " + std::to_string(m_computation_count++);
+            _impl_memory_registry::add(m_computations, name, bytes).domain_bytes = domain_bytes;
+            return name;
+        }
+
+        void remove_computation(std::string const &name, std::size_t bytes) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            _impl_memory_registry::remove(m_computations, name, bytes);
+        }
+
+        /** @brief Bytes currently held by all storages. */
+        std::size_t bytes() const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_bytes;
+        }
+
+        /** @brief High-water mark of `bytes` since the last `reset_peaks`. */
+        std::size_t peak_bytes() const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_peak_bytes;
+        }
+
+        /** @brief The records per data store name, the largest peak first. */
+        std::vector<memory_record> names() const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return _impl_memory_registry::sorted(m_names);
+        }
+
+        /** @brief The records per storage type, the largest peak first. */
+        std::vector<memory_record> storage_types() const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return _impl_memory_registry::sorted(m_storage_types);
+        }
+
+        /** @brief The records of the temporaries per computation, the largest peak first. */
+        std::vector<memory_record> computations() const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return _impl_memory_registry::sorted(m_computations);
+        }
+
+        /**
+         * @brief Resets the high-water marks to the bytes currently held and drops the records that hold nothing.
+         */
+        void reset_peaks() {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_peak_bytes = m_bytes;
+            for (auto *records : {&m_names, &m_storage_types, &m_computations})
+                for (auto it = records->begin(); it != records->end();) {
+                    if (it->second.allocations == 0) {
+                        it = records->erase(it);
+                        continue;
+                    }
+                    it->second.peak_bytes = it->second.bytes;
+                    ++it;
+                }
+        }
+
+        /**
+         * @brief The totals and all records as a JSON object.
+         */
+        std::string to_json() const {
+            std::ostringstream out;
+            out << "{\n  \"bytes\": " << bytes() << ",\n  \"peak_bytes\": " << peak_bytes() << ",\n  \"names\": ";
+            _impl_memory_registry::write_json(out, names());
+            out << ",\n  \"storage_types\": ";
+            _impl_memory_registry::write_json(out, storage_types());
+            out << ",\n  \"computations\": ";
+            _impl_memory_registry::write_json(out, computations());
+            out << "\n}";
+            return out.str();
+        }
+    };
+
+    namespace _impl_memory_registry {
+        template <class Storage>
+        std::string const &storage_type() {
+            static const std::string res = demangle(typeid(Storage).name());
+            return res;
+        }
+
+        template <class Storage>
+        struct storage_deleter {
+            std::string name;
+            std::size_t bytes;
+
+            void operator()(Storage *storage) const {
+                memory_registry::instance().remove_storage(name, storage_type<Storage>(), bytes);
+                delete storage;
+            }
+        };
+    } // namespace _impl_memory_registry
+
+    /**
+     * @brief Allocates a storage for the given storage info that is held by data stores with the given name. If
+     * GT_ENABLE_MEMORY_REGISTRY is defined, the storage is registered with the memory registry until it is destroyed.
+     */
+    template <class Storage, class StorageInfo>
+    std::shared_ptr<Storage> make_registered_storage(StorageInfo const &info, std::string const &name) {
+        using alignment_t = typename StorageInfo::alignment_t;
+        const std::size_t length = info.padded_total_length();
+#ifdef GT_ENABLE_MEMORY_REGISTRY
+        const std::size_t bytes = length * sizeof(typename Storage::data_t);
+        std::shared_ptr<Storage> res(new Storage(length, info.first_index_of_inner_region(), alignment_t{}),
+            _impl_memory_registry::storage_deleter<Storage>{name, bytes});
+        memory_registry::instance().add_storage(name, _impl_memory_registry::storage_type<Storage>(), bytes);
+        return res;
+#else
+        return std::make_shared<Storage>(length, info.first_index_of_inner_region(), alignment_t{});
+#endif
+    }
+
+    /**
+     * @brief Registers the temporaries of a computation with the memory registry for the lifetime of this object.
+     */
+    class computation_memory_registration {
+        struct entry {
+            std::string name;
+            std::size_t bytes;
+
+            ~entry() { memory_registry::instance().remove_computation(name, bytes); }
+        };
+        std::unique_ptr<entry> m_entry;
+
+      public:
+        computation_memory_registration() = default;
+
+        /**
+         * @param bytes bytes of the storages of the temporaries
+         * @param domain_bytes bytes the temporaries would need for the points of the grid alone
+         */
+        computation_memory_registration(std::size_t bytes, std::size_t domain_bytes)
+            : m_entry(new entry{memory_registry::instance().add_computation(bytes, domain_bytes), bytes}) {}
+
+        /** @brief Name of the record of the computation, empty if nothing is registered. */
+        std::string name() const { return m_entry ? m_entry->name : std::string(); }
+    };
+} // namespace gridtools
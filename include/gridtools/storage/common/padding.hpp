@@ -0,0 +1,87 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include <type_traits>
+
+#include "../../common/array.hpp"
+#include "../../common/defs.hpp"
+#include "../../common/host_device.hpp"
+
+namespace gridtools {
+
+    /** \ingroup storage
+     * @{
+     */
+
+    /**
+     * @brief Padding policy that keeps the padded lengths as they result from the alignment.
+     */
+    struct no_padding {
+        template <typename Layout, typename Alignment, size_t N>
+        GT_FUNCTION static GT_CONSTEXPR array<uint_t, N> pad(array<uint_t, N> const &padded_lengths) {
+            return padded_lengths;
+        }
+    };
+
+    /**
+     * @brief Padding policy that avoids strides which are a multiple of `CriticalStride` bytes.
+     *
+     * Elements whose addresses differ by a multiple of the critical stride map to the same cache set (e.g. 4 KiB for a
+     * 32 KiB, 8-way L1 cache with 64 byte lines, which also covers the larger L2 and L3 set spans) and alias in the
+     * load/store disambiguation and in the TLB. Stencils that access neighbours in j and k then evict their own lines
+     * for sizes like 256x256x80. Starting from the stride-1 dimension, the policy increases the padded length of the
+     * next faster dimension until no stride is a multiple of the critical stride. The stride-1 dimension is increased
+     * in steps of the alignment, so the alignment is preserved.
+     *
+     * As storage_infos are shared among fields of different data types, strides are checked for elements of
+     * `MaxElementSize` bytes, which also avoids the aliasing for all smaller power-of-two sized types.
+     *
+     * @tparam CriticalStride critical stride in bytes
+     * @tparam MaxElementSize size in bytes of the largest data type stored with this storage_info
+     */
+    template <uint_t CriticalStride = 4096, uint_t MaxElementSize = 8>
+    struct cache_padding {
+        GT_STATIC_ASSERT(CriticalStride % MaxElementSize == 0 && CriticalStride / MaxElementSize > 1,
+            "The critical stride has to be a multiple of the element size");
+
+        static constexpr uint_t critical_stride_elements = CriticalStride / MaxElementSize;
+
+        template <typename Layout, typename Alignment, size_t N>
+        GT_FUNCTION static GT_CONSTEXPR array<uint_t, N> pad(array<uint_t, N> padded_lengths) {
+            GT_STATIC_ASSERT(Alignment::value % critical_stride_elements != 0,
+                "The alignment must not be a multiple of the critical stride");
+            uint_t stride = 1;
+            for (int l = Layout::unmasked_length - 1; l > 0; --l) {
+                // padded_lengths[dim] determines the stride of the dimension with layout value l - 1
+                const size_t dim = Layout::find(l);
+                const uint_t step = l == Layout::unmasked_length - 1 ? Alignment::value : 1;
+                while (stride * padded_lengths[dim] % critical_stride_elements == 0)
+                    padded_lengths[dim] += step;
+                stride *= padded_lengths[dim];
+            }
+            return padded_lengths;
+        }
+    };
+
+    template <typename T>
+    struct is_padding : std::false_type {};
+
+    template <>
+    struct is_padding<no_padding> : std::true_type {};
+
+    template <uint_t CriticalStride, uint_t MaxElementSize>
+    struct is_padding<cache_padding<CriticalStride, MaxElementSize>> : std::true_type {};
+
+    /**
+     * @}
+     */
+} // namespace gridtools
@@ -25,6 +25,7 @@
 #include "../../meta/type_traits.hpp"
 #include "alignment.hpp"
 #include "halo.hpp"
+#include "padding.hpp"
 #include "storage_info_metafunctions.hpp"
 
 namespace gridtools {
@@ -66,28 +67,32 @@ namespace gridtools {
      * @tparam Layout information about the memory layout
      * @tparam Halo information about the halo sizes (by default no halo is set)
      * @tparam Alignment information about the alignment
+     * @tparam Padding policy that pads the lengths on top of the alignment, see padding.hpp
      */
     template <uint_t Id,
         typename Layout,
         typename Halo = zero_halo<Layout::masked_length>,
-        typename Alignment = alignment<1>>
+        typename Alignment = alignment<1>,
+        typename Padding = no_padding>
     struct storage_info;
 
-    template <uint_t Id, int... LayoutArgs, uint_t... Halos, typename Align>
-    struct storage_info<Id, layout_map<LayoutArgs...>, halo<Halos...>, Align> {
+    template <uint_t Id, int... LayoutArgs, uint_t... Halos, typename Align, typename Padding>
+    struct storage_info<Id, layout_map<LayoutArgs...>, halo<Halos...>, Align, Padding> {
         using layout_t = layout_map<LayoutArgs...>;
         using halo_t = halo<Halos...>;
         using alignment_t = Align;
+        using padding_t = Padding;
         static const int max_layout_v = layout_t::max();
 
         GT_STATIC_ASSERT((sizeof...(Halos) == layout_t::masked_length),
             GT_INTERNAL_ERROR_MSG("Halo size does not match number of dimensions"));
         GT_STATIC_ASSERT(is_alignment<Align>::value, GT_INTERNAL_ERROR_MSG("Given type is not an alignment type"));
+        GT_STATIC_ASSERT(is_padding<Padding>::value, GT_INTERNAL_ERROR_MSG("Given type is not a padding type"));
 
         static constexpr uint_t ndims = layout_t::masked_length;
 
       private:
-        using this_t = storage_info<Id, layout_map<LayoutArgs...>, halo<Halos...>, Align>;
+        using this_t = storage_info<Id, layout_map<LayoutArgs...>, halo<Halos...>, Align, Padding>;
         array<uint_t, ndims> m_total_lengths;
         array<uint_t, ndims> m_padded_lengths;
         array<uint_t, ndims> m_strides;
@@ -125,21 +130,27 @@ namespace gridtools {
                 ((layout_t::template at<Ints>() < 0) or (((int)coords >= 0) and (coords < m_total_lengths[Ints])))...);
         }
 
+        template <size_t... Seq>
+        GT_FUNCTION static GT_CONSTEXPR array<uint_t, ndims> strides_from_padded_lengths(
+            std::index_sequence<Seq...>, array<uint_t, ndims> const &padded_lengths) {
+            return get_strides<layout_t>::get_stride_array(padded_lengths[Seq]...);
+        }
+
       public:
         constexpr static uint_t id = Id;
 
         /**
          * @brief storage info constructor. Additionally to initializing the members the halo
-         * region is added to the corresponding dimensions and the alignment is applied.
+         * region is added to the corresponding dimensions and the alignment and the padding policy are applied.
          */
         template <typename... Dims,
             std::enable_if_t<sizeof...(Dims) == ndims && is_all_integral_or_enum<Dims...>::value, int> = 0>
         GT_FUNCTION GT_CONSTEXPR storage_info(Dims... dims_)
             : m_total_lengths{static_cast<uint_t>(dims_)...},
-              m_padded_lengths{pad_dimensions<alignment_t, max_layout_v, LayoutArgs>(
-                  handle_masked_dims<LayoutArgs>::extend(dims_))...},
-              m_strides(get_strides<layout_t>::get_stride_array(pad_dimensions<alignment_t, max_layout_v, LayoutArgs>(
-                  handle_masked_dims<LayoutArgs>::extend(dims_))...)) {}
+              m_padded_lengths(padding_t::template pad<layout_t, alignment_t>(array<uint_t, ndims>{
+                  pad_dimensions<alignment_t, max_layout_v, LayoutArgs>(
+                      handle_masked_dims<LayoutArgs>::extend(dims_))...})),
+              m_strides(strides_from_padded_lengths(std::make_index_sequence<ndims>{}, m_padded_lengths)) {}
 
         GT_FUNCTION
         storage_info(array<uint_t, ndims> dims, array<uint_t, ndims> strides)
@@ -361,8 +372,8 @@ namespace gridtools {
     template <typename T>
     struct is_storage_info : std::false_type {};
 
-    template <uint_t Id, typename Layout, typename Halo, typename Alignment>
-    struct is_storage_info<storage_info<Id, Layout, Halo, Alignment>> : std::true_type {};
+    template <uint_t Id, typename Layout, typename Halo, typename Alignment, typename Padding>
+    struct is_storage_info<storage_info<Id, Layout, Halo, Alignment, Padding>> : std::true_type {};
 
     /**
      * @}
@@ -23,12 +23,15 @@ namespace gridtools {
      * @brief A storage info runtime object, providing dimensions and strides but without type information of the
      * storage info. Can be used in interfaces where no strict type information is available, i.e. in the interface to
      * Fortran.
+     * The paddings are the number of elements by which the padded lengths exceed the total lengths, i.e. the padding
+     * added by the alignment and the padding policy of the storage info (0 for masked dimensions).
      */
     class storage_info_rt {
         using vec_t = std::vector<uint_t>;
         vec_t m_total_lengths;
         vec_t m_padded_lengths;
         vec_t m_strides;
+        vec_t m_paddings;
 
       public:
         template <class TotalLengths, class PaddedLengths, class Strides>
@@ -40,11 +43,15 @@ namespace gridtools {
                 m_padded_lengths.push_back(elem);
             for (auto &&elem : strides)
                 m_strides.push_back(elem);
+            for (size_t i = 0; i < m_total_lengths.size() && i < m_padded_lengths.size(); ++i)
+                m_paddings.push_back(
+                    m_padded_lengths[i] > m_total_lengths[i] ? m_padded_lengths[i] - m_total_lengths[i] : 0);
         }
 
         const vec_t &total_lengths() const { return m_total_lengths; }
         const vec_t &padded_lengths() const { return m_padded_lengths; }
         const vec_t &strides() const { return m_strides; }
+        const vec_t &paddings() const { return m_paddings; }
     };
 
     /*
@@ -21,6 +21,7 @@
 #include "../common/gt_assert.hpp"
 #include "../meta/type_traits.hpp"
 #include "./common/definitions.hpp"
+#include "./common/memory_registry.hpp"
 #include "./common/storage_info.hpp"
 #include "./common/storage_interface.hpp"
 
@@ -30,6 +31,28 @@ namespace gridtools {
      * @{
      */
 
+    /**
+     * @brief Writes `initializer(offset)` to all elements of the storage. Storages can provide overloads to control
+     * which thread touches which data.
+     */
+    template <class Storage, class StorageInfo, class Initializer>
+    void initialize_storage(Storage &storage, StorageInfo const &info, Initializer const &initializer) {
+        int length = info.padded_total_length();
+        auto *dst = storage.get_cpu_ptr();
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (int i = 0; i < length; ++i)
+            dst[i] = initializer(i);
+    }
+
+    /**
+     * @brief Called after a storage is allocated without initializer. Storages can provide overloads to touch the
+     * memory, by default the memory is left untouched.
+     */
+    template <class Storage, class StorageInfo>
+    void first_touch_storage(Storage &, StorageInfo const &) {}
+
     namespace data_store_impl_ {
         template <class Fun, class StorageInfo, class = std::make_index_sequence<StorageInfo::ndims>>
         struct initializer_adapter_f;
@@ -75,14 +98,9 @@ namespace gridtools {
       private:
         template <class Initializer>
         data_store(std::true_type, StorageInfo const &info, Initializer &&initializer, std::string const &name)
-            : data_store(info, name) {
-            int length = m_shared_storage_info->padded_total_length();
-            auto *dst = m_shared_storage->get_cpu_ptr();
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-            for (int i = 0; i < length; ++i)
-                dst[i] = initializer(i);
+            : m_shared_storage(make_registered_storage<storage_t>(info, name)),
+              m_shared_storage_info(new storage_info_t(info)), m_name(name) {
+            initialize_storage(*m_shared_storage, *m_shared_storage_info, initializer);
             m_shared_storage->clone_to_device();
         }
 
@@ -98,9 +116,10 @@ namespace gridtools {
          * @param name Human readable name for the data_store
          */
         data_store(StorageInfo const &info, std::string const &name = "")
-            : m_shared_storage(new storage_t(
-                  info.padded_total_length(), info.first_index_of_inner_region(), typename StorageInfo::alignment_t{})),
-              m_shared_storage_info(new storage_info_t(info)), m_name(name) {}
+            : m_shared_storage(make_registered_storage<storage_t>(info, name)),
+              m_shared_storage_info(new storage_info_t(info)), m_name(name) {
+            first_touch_storage(*m_shared_storage, *m_shared_storage_info);
+        }
 
         /**
          * @brief data_store constructor. This constructor triggers an allocation of the required space.
@@ -148,6 +167,16 @@ namespace gridtools {
             : m_shared_storage(new storage_t(info.padded_total_length(), external_ptr, own)),
               m_shared_storage_info(new storage_info_t(info)), m_name(name) {}
 
+        /**
+         * @brief data_store constructor. Wraps an already constructed storage instance, e.g. a file-backed storage
+         * (see make_mmap_data_store).
+         * @param info storage info instance
+         * @param storage the storage, which has to be large enough for info
+         * @param name Human readable name for the data_store
+         */
+        data_store(StorageInfo const &info, std::shared_ptr<storage_t> storage, std::string const &name = "")
+            : m_shared_storage(std::move(storage)), m_shared_storage_info(new storage_info_t(info)), m_name(name) {}
+
         /**
          * @brief allocate the needed memory. this will instantiate a storage instance.
          *
@@ -157,9 +186,8 @@ namespace gridtools {
             GT_ASSERT_OR_THROW(
                 !m_shared_storage_info.get() && !m_shared_storage.get(), "This data store has already been allocated.");
             m_shared_storage_info = std::make_shared<storage_info_t>(info);
-            m_shared_storage = std::make_shared<storage_t>(m_shared_storage_info->padded_total_length(),
-                m_shared_storage_info->first_index_of_inner_region(),
-                typename StorageInfo::alignment_t{});
+            m_shared_storage = make_registered_storage<storage_t>(*m_shared_storage_info, m_name);
+            first_touch_storage(*m_shared_storage, *m_shared_storage_info);
         }
 
         /**
@@ -30,12 +30,14 @@ namespace gridtools {
      * @tparam Layout information about the memory layout
      * @tparam Halo information about the halo sizes (by default no halo is set)
      * @tparam Alignment information about the alignment (cuda_storage_info is aligned to 32 by default)
+     * @tparam Padding padding policy applied on top of the alignment
      */
     template <uint_t Id,
         typename Layout,
         typename Halo = zero_halo<Layout::masked_length>,
-        typename Alignment = alignment<32>>
-    using cuda_storage_info = storage_info<Id, Layout, Halo, Alignment>;
+        typename Alignment = alignment<32>,
+        typename Padding = no_padding>
+    using cuda_storage_info = storage_info<Id, Layout, Halo, Alignment, Padding>;
 
     namespace impl_ {
         /*
@@ -55,9 +57,9 @@ namespace gridtools {
      * to a kernel.
      * @return a storage info device pointer
      */
-    template <uint_t Id, typename Layout, typename Halo, typename Alignment>
-    storage_info<Id, Layout, Halo, Alignment> *get_gpu_storage_info_ptr(
-        storage_info<Id, Layout, Halo, Alignment> const &src) {
+    template <uint_t Id, typename Layout, typename Halo, typename Alignment, typename Padding>
+    storage_info<Id, Layout, Halo, Alignment, Padding> *get_gpu_storage_info_ptr(
+        storage_info<Id, Layout, Halo, Alignment, Padding> const &src) {
         thread_local static auto cache = impl_::make_storage_info_ptr_cache(src);
         if (cache.first != src)
             cache = impl_::make_storage_info_ptr_cache(src);
@@ -11,6 +11,8 @@
 #pragma once
 
 #include "../common/layout_map.hpp"
+#include "../common/reduced_precision.hpp"
+#include "bulk_operations.hpp"
 #include "common/definitions.hpp"
 #include "common/halo.hpp"
 #include "data_store.hpp"
@@ -65,6 +67,12 @@ namespace gridtools {
         template <typename ValueType, typename StorageInfo>
         using data_store_t = data_store<storage_t<ValueType>, StorageInfo>;
 
+        // file-backed data store, see make_mmap_data_store (host backends only)
+        template <typename ValueType, typename StorageInfo>
+        using mmap_data_store_t = data_store<
+            typename gridtools::storage_traits_from_id<Backend>::template select_mmap_storage<ValueType>::type,
+            StorageInfo>;
+
         template <uint_t Id, uint_t Dims, typename Halo, typename Align>
         using storage_info_align_t = typename gridtools::storage_traits_from_id<
             Backend>::template select_storage_info_align<Id, Dims, Halo, Align>::type;
@@ -76,6 +84,21 @@ namespace gridtools {
         template <uint_t Id, typename Selector, typename Halo, typename Align>
         using special_storage_info_align_t = typename gridtools::storage_traits_from_id<
             Backend>::template select_special_storage_info_align<Id, Selector, Halo, Align>::type;
+
+        // storage_info with the default layout and alignment of the backend, whose lengths are padded by the given
+        // padding policy (see padding.hpp), by default the one the backend selects for its cache geometry
+        template <uint_t Id,
+            uint_t Dims,
+            typename Halo = zero_halo<Dims>,
+            typename Padding = typename gridtools::storage_traits_from_id<Backend>::default_padding>
+        using padded_storage_info_t = typename gridtools::storage_traits_from_id<
+            Backend>::template select_padded_storage_info<Id, Dims, Halo, Padding>::type;
+
+        // three-dimensional storage_info whose i/j-tiles are stored contiguously, see tiled_storage_info (mc backend
+        // only)
+        template <uint_t Id, typename Halo = zero_halo<3>, typename Tile = tile<32, 8>>
+        using tiled_storage_info_t = typename gridtools::storage_traits_from_id<
+            Backend>::template select_tiled_storage_info<Id, Halo, Tile>::type;
     };
 
     /**
@@ -12,13 +12,51 @@
 
 #include <cassert>
 #include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
 #include <utility>
 
+#include "../../common/caching_arena.hpp"
 #include "../common/alignment.hpp"
 #include "../common/state_machine.hpp"
 #include "../common/storage_interface.hpp"
 
 namespace gridtools {
+    namespace _impl_host_storage {
+        /**
+         * @brief Destroys the elements of an arena block, without releasing the block itself.
+         */
+        template <class T>
+        struct destroy_elements {
+            std::size_t m_size;
+
+            void operator()(T *ptr) const {
+                if (!std::is_trivially_destructible<T>::value)
+                    for (std::size_t i = 0; i != m_size; ++i)
+                        ptr[i].~T();
+            }
+        };
+
+        /**
+         * @brief Default-initializes `size` elements at `ptr`, like `new T[size]` does.
+         */
+        template <class T>
+        std::unique_ptr<T, destroy_elements<T>> construct_elements(void *ptr, std::size_t size) {
+            T *first = static_cast<T *>(ptr);
+            if (!std::is_trivially_default_constructible<T>::value) {
+                std::size_t i = 0;
+                try {
+                    for (; i != size; ++i)
+                        new (first + i) T;
+                } catch (...) {
+                    destroy_elements<T>{i}(first);
+                    throw;
+                }
+            }
+            return {first, destroy_elements<T>{size}};
+        }
+    } // namespace _impl_host_storage
 
     /** \ingroup storage
      * @{
@@ -35,6 +73,8 @@ namespace gridtools {
      * but we prefer the CRTP because it can be seen as the standard
      * gridtools pattern and we clearly want to avoid virtual
      * methods, etc.
+     * The memory is allocated through the active caching arena (see caching_arena_scope), if any. The elements are
+     * default-initialized in it and destroyed before it is released, as with `new DataType[]`.
      */
     template <typename DataType>
     struct host_storage : storage_interface<host_storage<DataType>> {
@@ -42,7 +82,9 @@ namespace gridtools {
         typedef state_machine state_machine_t;
 
       private:
-        std::unique_ptr<DataType[]> m_holder;
+        arena_ptr m_holder;
+        // declared after m_holder, such that the elements are destroyed before the memory is released
+        std::unique_ptr<DataType, _impl_host_storage::destroy_elements<DataType>> m_elements;
         DataType *m_ptr;
 
       public:
@@ -52,8 +94,10 @@ namespace gridtools {
          */
         template <uint_t Align = 1>
         host_storage(uint_t size, uint_t offset_to_align = 0u, alignment<Align> = alignment<1u>{})
-            : m_holder(new DataType[size + Align - 1]), m_ptr(nullptr) {
-            auto *allocated_ptr = m_holder.get();
+            : m_holder(arena_allocate((size + Align - 1) * sizeof(DataType), heap_upstream())),
+              m_elements(_impl_host_storage::construct_elements<DataType>(m_holder.get(), size + Align - 1)),
+              m_ptr(nullptr) {
+            auto *allocated_ptr = m_elements.get();
             // New will align addresses according to the size(DataType)
             auto delta =
                 (reinterpret_cast<std::uintptr_t>(allocated_ptr + offset_to_align) % (Align * sizeof(DataType))) /
@@ -79,6 +123,7 @@ namespace gridtools {
         void swap_impl(host_storage &other) {
             using std::swap;
             swap(m_holder, other.m_holder);
+            swap(m_elements, other.m_elements);
             swap(m_ptr, other.m_ptr);
         }
 
@@ -0,0 +1,312 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../../common/gt_assert.hpp"
+#include "../common/state_machine.hpp"
+#include "../common/storage_interface.hpp"
+#include "../data_store.hpp"
+#include "host_storage.hpp"
+
+namespace gridtools {
+
+    /** \ingroup storage
+     * @{
+     */
+
+    /**
+     * @brief How the file of a mmap_storage is opened.
+     */
+    enum class mmap_mode {
+        // creates (or truncates) the file, the data is zero-initialized, writes go to the file
+        create,
+        // opens an existing file, writes go to the file
+        read_write,
+        // opens an existing file, writes stay private to the process and never reach the file
+        copy_on_write
+    };
+
+    namespace _impl_mmap_storage {
+        constexpr std::uint32_t max_ndims = 16;
+        constexpr std::uint32_t version = 1;
+        constexpr char magic[8] = "GTSTORE";
+
+        /*
+         * @brief File header, stored at the start of the file. The data follows at `data_offset`, laid out as
+         * described by the storage_info, including halos and padding.
+         */
+        struct header {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t element_size;
+            // 'f' for floating point, 'i' for signed integral, 'u' for unsigned integral, 'o' for other types
+            char element_kind;
+            char reserved[3];
+            std::uint32_t ndims;
+            std::uint32_t alignment;
+            // offset in bytes of the element with index 0 from the start of the file
+            std::uint64_t data_offset;
+            std::uint64_t padded_total_length;
+            std::int32_t layout[max_ndims];
+            std::uint32_t halo[max_ndims];
+            std::uint32_t total_lengths[max_ndims];
+            std::uint32_t strides[max_ndims];
+        };
+
+        template <class T>
+        constexpr char element_kind() {
+            if (std::is_floating_point<T>::value)
+                return 'f';
+            if (std::is_integral<T>::value)
+                return std::is_signed<T>::value ? 'i' : 'u';
+            return 'o';
+        }
+
+        // start of the data area in the files written, a multiple of all common page sizes (4KB to 64KB), such that
+        // the data is page aligned on every system
+        constexpr std::size_t data_area_offset = 64 * 1024;
+        GT_STATIC_ASSERT(sizeof(header) <= data_area_offset, GT_INTERNAL_ERROR);
+
+        template <class DataType, class StorageInfo>
+        header make_header(StorageInfo const &info) {
+            GT_STATIC_ASSERT(StorageInfo::ndims <= max_ndims, "too many dimensions for a mmap_storage");
+            constexpr std::size_t align = StorageInfo::alignment_t::value;
+            header res{};
+            std::memcpy(res.magic, magic, sizeof(magic));
+            res.version = version;
+            res.element_size = sizeof(DataType);
+            res.element_kind = element_kind<DataType>();
+            res.ndims = StorageInfo::ndims;
+            res.alignment = align;
+            // the data starts at the data area, shifted such that the first element of the inner region is aligned
+            const std::size_t shift = (align - info.first_index_of_inner_region() % align) % align;
+            res.data_offset = data_area_offset + shift * sizeof(DataType);
+            res.padded_total_length = info.padded_total_length();
+            for (std::uint32_t dim = 0; dim < StorageInfo::ndims; ++dim) {
+                res.layout[dim] = StorageInfo::layout_t::at(dim);
+                res.halo[dim] = StorageInfo::halo_t::at(dim);
+                res.total_lengths[dim] = info.total_lengths()[dim];
+                res.strides[dim] = info.strides()[dim];
+            }
+            return res;
+        }
+
+        inline void check_field(bool ok, std::string const &path, char const *field) {
+            if (!ok)
+                throw std::runtime_error("mmap_storage: " + path + " does not match the storage: different " + field);
+        }
+
+        template <std::size_t N, class T>
+        bool equal(T const (&lhs)[N], T const (&rhs)[N]) {
+            return std::equal(lhs, lhs + N, rhs);
+        }
+
+        inline void check_header(header const &file, header const &expected, std::string const &path) {
+            if (std::memcmp(file.magic, magic, sizeof(magic)) || file.version != version)
+                throw std::runtime_error("mmap_storage: " + path + " is not a storage file of this version");
+            check_field(file.element_size == expected.element_size && file.element_kind == expected.element_kind,
+                path,
+                "data type");
+            check_field(file.ndims == expected.ndims && equal(file.layout, expected.layout), path, "layout");
+            check_field(equal(file.halo, expected.halo), path, "halo");
+            check_field(file.alignment == expected.alignment, path, "alignment");
+            check_field(equal(file.total_lengths, expected.total_lengths), path, "lengths");
+            check_field(
+                equal(file.strides, expected.strides) && file.padded_total_length == expected.padded_total_length,
+                path,
+                "padding");
+            // the data is mapped at the offset of the file, which may have been written with another data area
+            // offset, e.g. on a system with another page size
+            const std::uint64_t block = expected.alignment * expected.element_size;
+            check_field(file.data_offset >= sizeof(header) &&
+                            file.data_offset % block == expected.data_offset % block,
+                path,
+                "data offset");
+        }
+
+        [[noreturn]] inline void throw_errno(std::string const &what) {
+            throw std::system_error(errno, std::generic_category(), "mmap_storage: " + what);
+        }
+
+        struct file_descriptor {
+            int fd;
+            ~file_descriptor() { ::close(fd); }
+        };
+    } // namespace _impl_mmap_storage
+
+    /*
+     * @brief Host storage backed by a memory mapping of a file. The file starts with a header that records the data
+     * type, layout, halo, alignment, lengths and strides of the storage, followed by the data laid out exactly as in
+     * memory, including halos and padding. Opening a file thus is zero-copy: the pages are read lazily from the page
+     * cache when they are first accessed, and writing a checkpoint reduces to `flush`.
+     * Opening a file that does not match the storage_info throws. The data is stored in the byte order of the host.
+     * Instances of this class are noncopyable, use make_mmap_data_store to create data stores.
+     * @tparam DataType the type of the data, which has to be trivially copyable
+     */
+    template <typename DataType>
+    struct mmap_storage : storage_interface<mmap_storage<DataType>> {
+        GT_STATIC_ASSERT(
+            std::is_trivially_copyable<DataType>::value, "mmap_storage requires a trivially copyable type");
+
+        typedef DataType data_t;
+        typedef state_machine state_machine_t;
+
+      private:
+        void *m_mapping = nullptr;
+        std::size_t m_mapping_size = 0;
+        DataType *m_ptr = nullptr;
+
+      public:
+        /*
+         * @brief mmap_storage constructor. Maps the file at `path` according to `mode`.
+         * @param path path of the file
+         * @param mode mmap_mode::create to write a new file, mmap_mode::read_write or mmap_mode::copy_on_write to open
+         * an existing one
+         * @param info storage_info instance that describes the layout of the data
+         */
+        template <class StorageInfo>
+        mmap_storage(std::string const &path, mmap_mode mode, StorageInfo const &info) {
+            namespace impl = _impl_mmap_storage;
+            const auto expected = impl::make_header<DataType>(info);
+            std::size_t data_offset = expected.data_offset;
+
+            const int flags = mode == mmap_mode::create ? O_RDWR | O_CREAT | O_TRUNC
+                                                        : mode == mmap_mode::read_write ? O_RDWR : O_RDONLY;
+            impl::file_descriptor file{::open(path.c_str(), flags, 0644)};
+            if (file.fd < 0)
+                impl::throw_errno("cannot open " + path);
+
+            if (mode == mmap_mode::create) {
+                const std::size_t size = data_offset + expected.padded_total_length * sizeof(DataType);
+                if (::ftruncate(file.fd, size))
+                    impl::throw_errno("cannot resize " + path);
+                if (::pwrite(file.fd, &expected, sizeof(expected), 0) != sizeof(expected))
+                    impl::throw_errno("cannot write the header of " + path);
+            } else {
+                impl::header header;
+                if (::pread(file.fd, &header, sizeof(header), 0) != sizeof(header))
+                    throw std::runtime_error("mmap_storage: cannot read the header of " + path);
+                impl::check_header(header, expected, path);
+                data_offset = header.data_offset;
+                struct stat st;
+                if (::fstat(file.fd, &st))
+                    impl::throw_errno("cannot stat " + path);
+                if (std::size_t(st.st_size) < data_offset + expected.padded_total_length * sizeof(DataType))
+                    throw std::runtime_error("mmap_storage: " + path + " is truncated");
+            }
+            const std::size_t size = data_offset + expected.padded_total_length * sizeof(DataType);
+
+            void *mapping = ::mmap(nullptr,
+                size,
+                PROT_READ | PROT_WRITE,
+                mode == mmap_mode::copy_on_write ? MAP_PRIVATE : MAP_SHARED,
+                file.fd,
+                0);
+            if (mapping == MAP_FAILED)
+                impl::throw_errno("cannot map " + path);
+            m_mapping = mapping;
+            m_mapping_size = size;
+            m_ptr = reinterpret_cast<DataType *>(static_cast<char *>(mapping) + data_offset);
+        }
+
+        mmap_storage(mmap_storage const &) = delete;
+        mmap_storage &operator=(mmap_storage const &) = delete;
+
+        ~mmap_storage() {
+            if (m_mapping)
+                ::munmap(m_mapping, m_mapping_size);
+        }
+
+        /*
+         * @brief Writes the modified pages back to the file. Without effect for mmap_mode::copy_on_write.
+         * @param async if true, only schedules the write-back
+         */
+        void flush(bool async = false) const {
+            if (m_mapping && ::msync(m_mapping, m_mapping_size, async ? MS_ASYNC : MS_SYNC))
+                _impl_mmap_storage::throw_errno("msync failed");
+        }
+
+        /*
+         * @brief swap implementation for mmap_storage
+         */
+        void swap_impl(mmap_storage &other) {
+            using std::swap;
+            swap(m_mapping, other.m_mapping);
+            swap(m_mapping_size, other.m_mapping_size);
+            swap(m_ptr, other.m_ptr);
+        }
+
+        /*
+         * @brief retrieve the host data pointer.
+         * @return data pointer
+         */
+        DataType *get_cpu_ptr() const { return m_ptr; }
+
+        DataType *get_target_ptr() const { return m_ptr; }
+
+        /*
+         * @brief valid implementation for mmap_storage.
+         */
+        bool valid_impl() const { return m_ptr; }
+
+        void clone_to_device_impl() {}
+        void clone_from_device_impl() {}
+        void sync_impl() {}
+        bool device_needs_update_impl() const { return false; }
+        bool host_needs_update_impl() const { return false; }
+        void reactivate_target_write_views_impl() {}
+        void reactivate_host_write_views_impl() {}
+        state_machine *get_state_machine_ptr_impl() { return nullptr; }
+    };
+
+    // the mapping lives in host memory, hence host views can be created
+    template <typename T>
+    struct is_host_storage<mmap_storage<T>> : std::true_type {};
+
+    /**
+     * @brief Creates a data store backed by the file at `path`, see mmap_storage.
+     * @tparam DataStore a data store type with a mmap_storage, e.g. storage_traits<Backend>::mmap_data_store_t
+     */
+    template <class DataStore>
+    DataStore make_mmap_data_store(typename DataStore::storage_info_t const &info,
+        std::string const &path,
+        mmap_mode mode,
+        std::string const &name = "") {
+        return {info, std::make_shared<typename DataStore::storage_t>(path, mode, info), name};
+    }
+
+    /**
+     * @brief Writes the data of a file-backed data store back to its file, see mmap_storage::flush.
+     */
+    template <class DataStore>
+    void flush_data_store(DataStore const &ds, bool async = false) {
+        ds.get_storage_ptr()->flush(async);
+    }
+
+    /**
+     * @}
+     */
+} // namespace gridtools
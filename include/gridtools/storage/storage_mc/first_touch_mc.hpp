@@ -0,0 +1,182 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <type_traits>
+
+#include <omp.h>
+
+#include "../../common/array.hpp"
+#include "../../common/defs.hpp"
+#include "../../common/gt_assert.hpp"
+#include "../../common/host_device.hpp"
+#include "../../stencil_composition/structured_grids/backend_mc/execinfo_mc.hpp"
+
+/**@file
+ * @brief NUMA-aware (first-touch) initialization of mc storages.
+ *
+ * Memory pages are placed on the NUMA node of the thread that touches them first. If the data of a storage is
+ * initialized by the same threads that later run the stencils on it, all threads work on local memory. Define
+ * GT_MC_FIRST_TOUCH to also touch the storages that are allocated without an initializer and the temporaries of the mc
+ * backend in parallel.
+ */
+namespace gridtools {
+    namespace _impl_first_touch_mc {
+        /**
+         * @brief The inner region of a storage, in the interface of a grid, to decompose it with `execinfo_mc`.
+         */
+        template <class StorageInfo>
+        struct inner_region {
+            StorageInfo const &m_info;
+
+            GT_FUNCTION int_t i_low_bound() const { return m_info.template begin<0>(); }
+            GT_FUNCTION int_t i_high_bound() const {
+                return i_low_bound() + std::max<int_t>(m_info.template length<0>(), 1) - 1;
+            }
+            GT_FUNCTION int_t j_low_bound() const { return m_info.template begin<1>(); }
+            GT_FUNCTION int_t j_high_bound() const {
+                return j_low_bound() + std::max<int_t>(m_info.template length<1>(), 1) - 1;
+            }
+        };
+
+        /**
+         * @brief The default block decomposition of the mc backend for the inner region of the given storage.
+         */
+        template <class StorageInfo>
+        execinfo_mc make_execinfo(StorageInfo const &info) {
+            return execinfo_mc(inner_region<StorageInfo>{info});
+        }
+
+        /**
+         * @brief Range of storage indices `[first, last)` covered by the given block, the halo and padding is added to
+         * the first and last block.
+         */
+        struct block_range {
+            int_t first, last;
+
+            block_range(int_t block, int_t blocks, int_t block_first, int_t block_size) {
+                first = block == 0 ? 0 : block_first;
+                last = block == blocks - 1 ? std::numeric_limits<int_t>::max() : block_first + block_size;
+            }
+        };
+    } // namespace _impl_first_touch_mc
+
+    /**
+     * @brief Calls `f(offset)` for all offsets of a storage in parallel, version for storages without j-dimension.
+     */
+    template <class StorageInfo, class F, std::enable_if_t<(StorageInfo::ndims < 2), int> = 0>
+    void for_each_offset_mc(StorageInfo const &info, F const &f) {
+        const int_t length = info.padded_total_length();
+#pragma omp parallel for
+        for (int_t offset = 0; offset < length; ++offset)
+            f(offset);
+    }
+
+    /**
+     * @brief Calls `f(offset)` for all offsets of a storage in parallel.
+     *
+     * Every offset is visited by the thread that processes the corresponding point when a stencil is run on the
+     * inner region of the storage with the default block decomposition of the mc backend: the blocks are taken from
+     * `execinfo_mc` and are distributed with the same OpenMP loop. Halo points and padding are visited by the threads
+     * of the outermost blocks. The offsets are visited in contiguous runs, one per j-row and i-period.
+     */
+    template <class StorageInfo, class F, std::enable_if_t<(StorageInfo::ndims >= 2), int> = 0>
+    void for_each_offset_mc(StorageInfo const &info, F const &f) {
+        const int_t length = info.padded_total_length();
+        const int_t i_stride = info.template stride<0>();
+        const int_t j_stride = info.template stride<1>();
+        if (j_stride == 0) {
+#pragma omp parallel for
+            for (int_t offset = 0; offset < length; ++offset)
+                f(offset);
+            return;
+        }
+        const int_t i_padded_length = info.template padded_length<0>();
+        const int_t j_padded_length = info.template padded_length<1>();
+        const int_t i_period = i_stride * i_padded_length;
+        const int_t j_period = j_stride * j_padded_length;
+        const execinfo_mc exinfo = _impl_first_touch_mc::make_execinfo(info);
+        const int_t i_blocks = i_stride ? exinfo.i_blocks() : 1;
+        const int_t j_blocks = exinfo.j_blocks();
+
+#pragma omp parallel for collapse(2)
+        for (int_t bj = 0; bj < j_blocks; ++bj) {
+            for (int_t bi = 0; bi < i_blocks; ++bi) {
+                const auto block = exinfo.block(bi, bj);
+                const _impl_first_touch_mc::block_range is(bi, i_blocks, block.i_first, block.i_block_size);
+                const _impl_first_touch_mc::block_range js(bj, j_blocks, block.j_first, block.j_block_size);
+                const int_t i_first = is.first;
+                const int_t i_last = std::min(is.last, i_padded_length);
+                const int_t j_last = std::min(js.last, j_padded_length);
+                for (int_t base = 0; base < length; base += j_period) {
+                    for (int_t j = js.first; j < j_last; ++j) {
+                        const int_t row_first = base + j * j_stride;
+                        const int_t row_last = std::min(row_first + j_stride, length);
+                        if (i_blocks == 1) {
+                            for (int_t offset = row_first; offset < row_last; ++offset)
+                                f(offset);
+                        } else if (i_stride > j_stride) {
+                            // the i-index is constant along the row
+                            const int_t i = row_first / i_stride % i_padded_length;
+                            if (i >= i_first && i < i_last)
+                                for (int_t offset = row_first; offset < row_last; ++offset)
+                                    f(offset);
+                        } else {
+                            for (int_t period = row_first; period < row_last; period += i_period) {
+                                const int_t last = std::min(period + i_last * i_stride, row_last);
+                                for (int_t offset = period + i_first * i_stride; offset < last; ++offset)
+                                    f(offset);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Calls `f(first, last)` in parallel for boxes of points `[first, last)` (arrays of coordinates) that
+     * partition the points of the storage, for storages with an unmasked j-dimension.
+     *
+     * The points of a box are processed by the thread that processes them when a stencil is run on the inner region
+     * of the storage with the default block decomposition of the mc backend, as in `for_each_offset_mc`.
+     */
+    template <class StorageInfo, class F>
+    void for_each_block_mc(StorageInfo const &info, F const &f) {
+        GT_STATIC_ASSERT(StorageInfo::ndims >= 2, GT_INTERNAL_ERROR);
+        const execinfo_mc exinfo = _impl_first_touch_mc::make_execinfo(info);
+        const int_t i_blocks = info.template stride<0>() ? exinfo.i_blocks() : 1;
+        const int_t j_blocks = exinfo.j_blocks();
+
+#pragma omp parallel for collapse(2)
+        for (int_t bj = 0; bj < j_blocks; ++bj) {
+            for (int_t bi = 0; bi < i_blocks; ++bi) {
+                const auto block = exinfo.block(bi, bj);
+                const _impl_first_touch_mc::block_range is(bi, i_blocks, block.i_first, block.i_block_size);
+                const _impl_first_touch_mc::block_range js(bj, j_blocks, block.j_first, block.j_block_size);
+                array<int_t, StorageInfo::ndims> first = {};
+                array<int_t, StorageInfo::ndims> last;
+                for (std::size_t d = 0; d < StorageInfo::ndims; ++d)
+                    last[d] = info.strides()[d] ? info.total_lengths()[d] : 1;
+                if (i_blocks > 1) {
+                    first[0] = is.first;
+                    last[0] = std::min<int_t>(is.last, last[0]);
+                }
+                first[1] = js.first;
+                last[1] = std::min<int_t>(js.last, last[1]);
+                f(first, last);
+            }
+        }
+    }
+} // namespace gridtools
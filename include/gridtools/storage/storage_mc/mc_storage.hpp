@@ -13,10 +13,11 @@
 #include <atomic>
 #include <utility>
 
+#include "../../common/caching_arena.hpp"
 #include "../../common/gt_assert.hpp"
-#include "../../common/hugepage_alloc.hpp"
 #include "../common/state_machine.hpp"
 #include "../common/storage_interface.hpp"
+#include "first_touch_mc.hpp"
 
 namespace gridtools {
 
@@ -38,19 +39,20 @@ namespace gridtools {
         typedef state_machine state_machine_t;
 
       private:
-        std::unique_ptr<void, std::integral_constant<decltype(&hugepage_free), &hugepage_free>> m_holder;
+        arena_ptr m_holder;
         DataType *m_ptr;
 
       public:
         /*
          * @brief mc_storage constructor. Allocates data aligned to 2MB pages (to encourage the system to use
          * transparent huge pages) and adds an additional samll offset which changes for every allocation to reduce the
-         * risk of L1 cache set conflicts.
+         * risk of L1 cache set conflicts. The memory is allocated through the active caching arena (see
+         * caching_arena_scope), if any.
          * @param size defines the size of the storage and the allocated space.
          */
         template <uint_t Align = 1>
         mc_storage(uint_t size, uint_t offset_to_align = 0u, alignment<Align> = alignment<1u>{})
-            : m_holder(hugepage_alloc((size + Align) * sizeof(DataType))) {
+            : m_holder(arena_allocate((size + Align) * sizeof(DataType), hugepage_upstream())) {
             constexpr auto byte_alignment = Align * sizeof(DataType);
             auto byte_offset = offset_to_align * sizeof(DataType);
             auto address_to_align = reinterpret_cast<std::uintptr_t>(m_holder.get()) + byte_offset;
@@ -85,6 +87,12 @@ namespace gridtools {
         DataType *get_cpu_ptr() const { return m_ptr; }
 
         DataType *get_target_ptr() const { return m_ptr; }
+
+        /*
+         * @brief huge page strategy and coverage of the allocation, empty for external pointers.
+         */
+        hugepage_allocation_info hugepage_info() const { return gridtools::hugepage_info(m_holder.get()); }
+
         /*
          * @brief valid implementation for mc_storage.
          */
@@ -131,6 +139,27 @@ namespace gridtools {
         state_machine *get_state_machine_ptr_impl() { return nullptr; }
     };
 
+    /*
+     * @brief Initializes a mc storage in parallel, each thread initializes the data it processes when running stencils
+     * on the storage (see for_each_offset_mc).
+     */
+    template <class DataType, class StorageInfo, class Initializer>
+    void initialize_storage(mc_storage<DataType> &storage, StorageInfo const &info, Initializer const &initializer) {
+        auto *dst = storage.get_cpu_ptr();
+        for_each_offset_mc(info, [&](int_t offset) { dst[offset] = initializer(offset); });
+    }
+
+#ifdef GT_MC_FIRST_TOUCH
+    /*
+     * @brief Default-initializes a newly allocated mc storage in parallel, such that the memory pages are placed close
+     * to the threads that process them.
+     */
+    template <class DataType, class StorageInfo>
+    void first_touch_storage(mc_storage<DataType> &storage, StorageInfo const &info) {
+        initialize_storage(storage, info, [](int_t) { return DataType(); });
+    }
+#endif
+
     // simple metafunction to check if a type is a mc storage
     template <typename T>
     struct is_mc_storage : std::false_type {};
@@ -19,10 +19,12 @@ namespace gridtools {
      * @tparam Layout information about the memory layout
      * @tparam Halo information about the halo sizes (by default no halo is set)
      * @tparam Alignment information about the alignment
+     * @tparam Padding padding policy applied on top of the alignment
      */
     template <uint_t Id,
         typename Layout,
         typename Halo = zero_halo<Layout::masked_length>,
-        typename Alignment = alignment<8>>
-    using mc_storage_info = storage_info<Id, Layout, Halo, Alignment>;
+        typename Alignment = alignment<8>,
+        typename Padding = no_padding>
+    using mc_storage_info = storage_info<Id, Layout, Halo, Alignment, Padding>;
 } // namespace gridtools
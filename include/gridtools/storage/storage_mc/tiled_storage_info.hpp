@@ -0,0 +1,310 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+
+#include "../../common/array.hpp"
+#include "../../common/defs.hpp"
+#include "../../common/error.hpp"
+#include "../../common/generic_metafunctions/is_all_integrals.hpp"
+#include "../../common/gt_assert.hpp"
+#include "../../common/host_device.hpp"
+#include "../../common/hymap.hpp"
+#include "../../common/integral_constant.hpp"
+#include "../../common/layout_map.hpp"
+#include "../../stencil_composition/sid/blocked_dim.hpp"
+#include "../common/alignment.hpp"
+#include "../common/halo.hpp"
+#include "../common/storage_info.hpp"
+#include "../data_store.hpp"
+#include "first_touch_mc.hpp"
+
+namespace gridtools {
+
+    /** \ingroup storage
+     * @{
+     */
+
+    /**
+     * @brief Size of the i/j-tiles of a tiled_storage_info, in number of elements.
+     */
+    template <uint_t I, uint_t J>
+    struct tile {
+        GT_STATIC_ASSERT(I > 0 && J > 0, "Tile sizes must be greater than 0");
+        static constexpr uint_t i = I;
+        static constexpr uint_t j = J;
+    };
+
+    template <typename T>
+    struct is_tile : std::false_type {};
+
+    template <uint_t I, uint_t J>
+    struct is_tile<tile<I, J>> : std::true_type {};
+
+    /**
+     * @brief Storage info of a three-dimensional field whose i/j-tiles are stored contiguously.
+     *
+     * The domain (including the halo) is split into tiles of Tile::i x Tile::j x k-length elements. Inside a tile, the
+     * i-dimension has stride one, followed by the j- and the k-dimension. The tiles are stored one after the other,
+     * the i-tiles of a j-tile row first. Tiles start at the first point of the inner region, such that a block of the
+     * mc backend that starts at a tile boundary accesses a single contiguous chunk of memory per tile, which needs a
+     * fraction of the pages and TLB entries of the strided layout.
+     *
+     * The in-tile strides are returned by strides(), the strides between tiles by tile_strides(). As a SID, data
+     * stores with a tiled storage info provide both: the in-tile strides along dim i, j and k and the tile strides
+     * along sid::blocked_dim<i> and sid::blocked_dim<j>. The index of a point thus is not linear in its coordinates,
+     * index() takes care of the decomposition, so host views can be indexed with logical (i, j, k) coordinates.
+     *
+     * @tparam Id unique ID that should be shared among all storage infos with the same dimensionality.
+     * @tparam Halo information about the halo sizes
+     * @tparam Tile the tile sizes, tile<I, J>. Tile::i should be a multiple of the SIMD width for aligned accesses and
+     * powers of two make the index decomposition cheap.
+     */
+    template <uint_t Id, typename Halo = zero_halo<3>, typename Tile = tile<32, 8>>
+    struct tiled_storage_info;
+
+    template <uint_t Id, uint_t HaloI, uint_t HaloJ, uint_t HaloK, uint_t TileI, uint_t TileJ>
+    struct tiled_storage_info<Id, halo<HaloI, HaloJ, HaloK>, tile<TileI, TileJ>> {
+        // order of the dimensions inside a tile
+        using layout_t = layout_map<2, 1, 0>;
+        using halo_t = halo<HaloI, HaloJ, HaloK>;
+        using tile_t = tile<TileI, TileJ>;
+        using alignment_t = alignment<(TileI % 8 == 0 ? 8 : 1)>;
+
+        static constexpr uint_t ndims = 3;
+        constexpr static uint_t id = Id;
+
+      private:
+        using this_t = tiled_storage_info<Id, halo_t, tile_t>;
+
+        array<uint_t, ndims> m_total_lengths;
+        array<uint_t, 2> m_tiles;
+        array<uint_t, 2> m_tile_strides;
+
+        GT_FUNCTION static GT_CONSTEXPR uint_t tile_count(uint_t length, uint_t offset, uint_t tile_size) {
+            return (length + offset + tile_size - 1) / tile_size;
+        }
+
+      public:
+        /**
+         * @brief The number of unused elements in front of the first tile, such that tiles start at the inner region.
+         */
+        template <uint_t Dim>
+        GT_FUNCTION static GT_CONSTEXPR uint_t tile_offset() {
+            GT_STATIC_ASSERT(Dim < 2, GT_INTERNAL_ERROR_MSG("Only the i- and j-dimension are tiled"));
+            return Dim == 0 ? (TileI - HaloI % TileI) % TileI : (TileJ - HaloJ % TileJ) % TileJ;
+        }
+
+        template <typename... Dims,
+            std::enable_if_t<sizeof...(Dims) == ndims && is_all_integral_or_enum<Dims...>::value, int> = 0>
+        GT_FUNCTION GT_CONSTEXPR tiled_storage_info(Dims... dims_)
+            : m_total_lengths{static_cast<uint_t>(dims_)...},
+              m_tiles{tile_count(m_total_lengths[0], tile_offset<0>(), TileI),
+                  tile_count(m_total_lengths[1], tile_offset<1>(), TileJ)},
+              m_tile_strides{TileI * TileJ * m_total_lengths[2], m_tiles[0] * TileI * TileJ * m_total_lengths[2]} {}
+
+        GT_CONSTEXPR tiled_storage_info(tiled_storage_info const &other) = default;
+
+        /**
+         * @brief Number of allocated elements, including the partially used tiles at the boundaries.
+         */
+        GT_FUNCTION GT_CONSTEXPR uint_t padded_total_length() const { return m_tile_strides[1] * m_tiles[1]; }
+
+        GT_FUNCTION GT_CONSTEXPR uint_t total_length() const {
+            return m_total_lengths[0] * m_total_lengths[1] * m_total_lengths[2];
+        }
+
+        GT_FUNCTION GT_CONSTEXPR uint_t length() const {
+            return length<0>() * length<1>() * length<2>();
+        }
+
+        GT_FUNCTION GT_CONSTEXPR const array<uint_t, ndims> &total_lengths() const { return m_total_lengths; }
+
+        template <uint_t Dim>
+        GT_FUNCTION GT_CONSTEXPR int total_length() const {
+            GT_STATIC_ASSERT(
+                (Dim < ndims), GT_INTERNAL_ERROR_MSG("Out of bounds access in storage info dimension call."));
+            return m_total_lengths[Dim];
+        }
+
+        /**
+         * @brief Returns the length of a dimension including the halo points, the unused elements in front of the first
+         * tile and the unused elements of the last tile.
+         */
+        template <uint_t Dim>
+        GT_FUNCTION GT_CONSTEXPR uint_t padded_length() const {
+            return Dim == 0 ? m_tiles[0] * TileI : Dim == 1 ? m_tiles[1] * TileJ : m_total_lengths[2];
+        }
+
+        GT_FUNCTION GT_CONSTEXPR array<uint_t, ndims> padded_lengths() const {
+            return {padded_length<0>(), padded_length<1>(), padded_length<2>()};
+        }
+
+        template <uint_t Dim>
+        GT_FUNCTION GT_CONSTEXPR uint_t length() const {
+            return m_total_lengths[Dim] - 2 * halo_t::template at<Dim>();
+        }
+
+        template <uint_t Dim>
+        GT_FUNCTION GT_CONSTEXPR uint_t total_begin() const {
+            return 0;
+        }
+
+        template <uint_t Dim>
+        GT_FUNCTION GT_CONSTEXPR uint_t total_end() const {
+            return total_length<Dim>() - 1;
+        }
+
+        template <uint_t Dim>
+        GT_FUNCTION GT_CONSTEXPR uint_t begin() const {
+            return halo_t::template at<Dim>();
+        }
+
+        template <uint_t Dim>
+        GT_FUNCTION GT_CONSTEXPR uint_t end() const {
+            return begin<Dim>() + length<Dim>() - 1;
+        }
+
+        /**
+         * @brief Returns the stride of a dimension inside a tile.
+         */
+        template <uint_t Dim>
+        GT_FUNCTION GT_CONSTEXPR uint_t stride() const {
+            GT_STATIC_ASSERT((Dim < ndims), GT_INTERNAL_ERROR_MSG("Out of bounds access in storage info stride call."));
+            return Dim == 0 ? 1 : Dim == 1 ? TileI : TileI * TileJ;
+        }
+
+        /**
+         * @brief Returns the strides inside a tile.
+         */
+        GT_FUNCTION GT_CONSTEXPR array<uint_t, ndims> strides() const {
+            return {stride<0>(), stride<1>(), stride<2>()};
+        }
+
+        /**
+         * @brief Returns the strides between neighbouring tiles along i and j.
+         */
+        GT_FUNCTION GT_CONSTEXPR const array<uint_t, 2> &tile_strides() const { return m_tile_strides; }
+
+        template <typename... Ints,
+            std::enable_if_t<sizeof...(Ints) == ndims && is_all_integral_or_enum<Ints...>::value, int> = 0>
+        GT_FUNCTION GT_CONSTEXPR int index(Ints... idx) const {
+            return index(array<int, ndims>{static_cast<int>(idx)...});
+        }
+
+        GT_FUNCTION GT_CONSTEXPR int index(array<int, ndims> const &idx) const {
+#ifdef NDEBUG
+            return offset(idx[0] + tile_offset<0>(), idx[1] + tile_offset<1>(), idx[2]);
+#else
+            return error_or_return(idx[0] >= 0 && idx[0] < (int)m_total_lengths[0] && idx[1] >= 0 &&
+                                       idx[1] < (int)m_total_lengths[1] && idx[2] >= 0 &&
+                                       idx[2] < (int)m_total_lengths[2],
+                offset(idx[0] + tile_offset<0>(), idx[1] + tile_offset<1>(), idx[2]),
+                "Storage out of bounds access");
+#endif
+        }
+
+        /**
+         * @brief Returns the index of the point at the given coordinates, relative to the first tile. `i` and `j`
+         * include the tile offsets and have to be non-negative.
+         */
+        GT_FUNCTION GT_CONSTEXPR int offset(int i, int j, int k) const {
+            return i / (int)TileI * (int)m_tile_strides[0] + i % (int)TileI + j / (int)TileJ * (int)m_tile_strides[1] +
+                   j % (int)TileJ * (int)TileI + k * (int)(TileI * TileJ);
+        }
+
+        GT_FUNCTION GT_CONSTEXPR int first_index_of_inner_region() const { return index(HaloI, HaloJ, HaloK); }
+
+        GT_FUNCTION bool operator==(this_t const &rhs) const {
+            return m_total_lengths[0] == rhs.m_total_lengths[0] && m_total_lengths[1] == rhs.m_total_lengths[1] &&
+                   m_total_lengths[2] == rhs.m_total_lengths[2];
+        }
+
+        GT_FUNCTION bool operator!=(this_t const &rhs) const { return !operator==(rhs); }
+    };
+
+    template <uint_t Id, typename Halo, typename Tile>
+    struct is_storage_info<tiled_storage_info<Id, Halo, Tile>> : std::true_type {};
+
+    template <typename T>
+    struct is_tiled_storage_info : std::false_type {};
+
+    template <uint_t Id, typename Halo, typename Tile>
+    struct is_tiled_storage_info<tiled_storage_info<Id, Halo, Tile>> : std::true_type {};
+
+    namespace data_store_impl_ {
+        // the coordinates of an offset are found by inverting the tile decomposition
+        template <class Fun, uint_t Id, class Halo, class Tile>
+        struct initializer_adapter_f<Fun, tiled_storage_info<Id, Halo, Tile>, std::index_sequence<0, 1, 2>> {
+            using info_t = tiled_storage_info<Id, Halo, Tile>;
+            Fun const &m_fun;
+            info_t const &m_info;
+
+            auto operator()(int offset) const {
+                const int tile_j = offset / (int)m_info.tile_strides()[1];
+                offset %= m_info.tile_strides()[1];
+                const int tile_i = offset / (int)m_info.tile_strides()[0];
+                offset %= m_info.tile_strides()[0];
+                const int i = tile_i * Tile::i + offset % Tile::i - info_t::template tile_offset<0>();
+                const int j = tile_j * Tile::j + offset / Tile::i % Tile::j - info_t::template tile_offset<1>();
+                const int k = offset / (Tile::i * Tile::j);
+                // unused elements of the boundary tiles are mapped to the closest point of the storage
+                return m_fun(std::min(std::max(i, 0), m_info.template total_length<0>() - 1),
+                    std::min(std::max(j, 0), m_info.template total_length<1>() - 1),
+                    k);
+            }
+        };
+    } // namespace data_store_impl_
+
+    /**
+     *   Makes data stores with a tiled_storage_info model the `SID` concept, with the in-tile strides along the i-, j-
+     *   and k-dimension and the tile strides along the blocked i- and j-dimension.
+     */
+    template <class Storage, uint_t Id, class Halo, class Tile>
+    typename hymap::keys<integral_constant<int, 0>,
+        integral_constant<int, 1>,
+        integral_constant<int, 2>,
+        sid::blocked_dim<integral_constant<int, 0>>,
+        sid::blocked_dim<integral_constant<int, 1>>>::
+        template values<integral_constant<int_t, 1>,
+            integral_constant<int_t, Tile::i>,
+            integral_constant<int_t, Tile::i * Tile::j>,
+            int_t,
+            int_t>
+        sid_get_strides(data_store<Storage, tiled_storage_info<Id, Halo, Tile>> const &obj) {
+        auto const &tile_strides = obj.info().tile_strides();
+        return {integral_constant<int_t, 1>{},
+            integral_constant<int_t, Tile::i>{},
+            integral_constant<int_t, Tile::i * Tile::j>{},
+            (int_t)tile_strides[0],
+            (int_t)tile_strides[1]};
+    }
+
+    /**
+     * @brief Calls `f(offset)` for all offsets of a tiled storage in parallel, tile by tile.
+     */
+    template <uint_t Id, class Halo, class Tile, class F>
+    void for_each_offset_mc(tiled_storage_info<Id, Halo, Tile> const &info, F const &f) {
+        const int_t tile_size = info.tile_strides()[0];
+        const int_t tiles = info.padded_total_length() / tile_size;
+#pragma omp parallel for
+        for (int_t t = 0; t < tiles; ++t)
+            for (int_t offset = t * tile_size; offset < (t + 1) * tile_size; ++offset)
+                f(offset);
+    }
+
+    /**
+     * @}
+     */
+} // namespace gridtools
@@ -78,6 +78,22 @@ namespace gridtools {
             typedef typename get_layout<Selector::size(), false>::type layout;
             typedef storage_info<Id, typename get_special_layout<layout, Selector>::type, Halo, Align> type;
         };
+
+        // GPU caches are not prone to set aliasing at power-of-two strides, the alignment is sufficient
+        typedef no_padding default_padding;
+
+        template <uint_t Id, uint_t Dims, typename Halo, typename Padding>
+        struct select_padded_storage_info {
+            GT_STATIC_ASSERT(is_halo<Halo>::value, "Given type is not a halo type.");
+            GT_STATIC_ASSERT(is_padding<Padding>::value, "Given type is not a padding type.");
+            typedef typename get_layout<Dims, false>::type layout;
+            typedef cuda_storage_info<Id, layout, Halo, alignment<32>, Padding> type;
+        };
+
+        template <uint_t Id, typename Halo, typename Tile>
+        struct select_tiled_storage_info {
+            GT_STATIC_ASSERT(sizeof(Tile) == 0, "Tiled storages are only supported by the mc backend.");
+        };
     };
 
     /**
@@ -15,8 +15,10 @@
 #include "../common/selector.hpp"
 #include "./common/halo.hpp"
 #include "./common/storage_traits_metafunctions.hpp"
+#include "./storage_host/mmap_storage.hpp"
 #include "./storage_mc/mc_storage.hpp"
 #include "./storage_mc/mc_storage_info.hpp"
+#include "./storage_mc/tiled_storage_info.hpp"
 
 namespace gridtools {
     template <class Backend>
@@ -43,6 +45,11 @@ namespace gridtools {
             using type = mc_storage<ValueType>;
         };
 
+        template <typename ValueType>
+        struct select_mmap_storage {
+            using type = mmap_storage<ValueType>;
+        };
+
         template <uint_t Id, uint_t Dims, typename Halo>
         struct select_storage_info {
             GT_STATIC_ASSERT(is_halo<Halo>::value, "Given type is not a halo type.");
@@ -102,5 +109,27 @@ namespace gridtools {
 #endif
             using type = storage_info<Id, typename get_special_layout<layout, Selector>::type, Halo, Align>;
         };
+
+        // pad strides away from multiples of the 4 KiB critical stride of the caches
+        using default_padding = cache_padding<>;
+
+        template <uint_t Id, uint_t Dims, typename Halo, typename Padding>
+        struct select_padded_storage_info {
+            GT_STATIC_ASSERT(is_halo<Halo>::value, "Given type is not a halo type.");
+            GT_STATIC_ASSERT(is_padding<Padding>::value, "Given type is not a padding type.");
+#ifndef GT_ICOSAHEDRAL_GRIDS
+            using layout = typename impl::layout_swap_mc<typename get_layout<Dims, false>::type>::type;
+#else
+            using layout = typename get_layout<Dims, true>::type;
+#endif
+            using type = mc_storage_info<Id, layout, Halo, alignment<8>, Padding>;
+        };
+
+        template <uint_t Id, typename Halo, typename Tile>
+        struct select_tiled_storage_info {
+            GT_STATIC_ASSERT(is_halo<Halo>::value, "Given type is not a halo type.");
+            GT_STATIC_ASSERT(is_tile<Tile>::value, "Given type is not a tile type.");
+            using type = tiled_storage_info<Id, Halo, Tile>;
+        };
     };
 } // namespace gridtools
@@ -15,6 +15,7 @@
 #include "./common/definitions.hpp"
 #include "./common/storage_traits_metafunctions.hpp"
 #include "./storage_host/host_storage.hpp"
+#include "./storage_host/mmap_storage.hpp"
 
 namespace gridtools {
     /** \ingroup storage
@@ -33,6 +34,11 @@ namespace gridtools {
             typedef host_storage<ValueType> type;
         };
 
+        template <typename ValueType>
+        struct select_mmap_storage {
+            typedef mmap_storage<ValueType> type;
+        };
+
         template <uint_t Id, uint_t Dims, typename Halo>
         struct select_storage_info {
             GT_STATIC_ASSERT(is_halo<Halo>::value, "Given type is not a halo type.");
@@ -76,6 +82,22 @@ namespace gridtools {
             typedef typename get_layout<Selector::size(), true>::type layout;
             typedef storage_info<Id, typename get_special_layout<layout, Selector>::type, Halo, Align> type;
         };
+
+        // pad strides away from multiples of the 4 KiB critical stride of the caches
+        typedef cache_padding<> default_padding;
+
+        template <uint_t Id, uint_t Dims, typename Halo, typename Padding>
+        struct select_padded_storage_info {
+            GT_STATIC_ASSERT(is_halo<Halo>::value, "Given type is not a halo type.");
+            GT_STATIC_ASSERT(is_padding<Padding>::value, "Given type is not a padding type.");
+            typedef typename get_layout<Dims, true>::type layout;
+            typedef storage_info<Id, layout, Halo, alignment<1>, Padding> type;
+        };
+
+        template <uint_t Id, typename Halo, typename Tile>
+        struct select_tiled_storage_info {
+            GT_STATIC_ASSERT(sizeof(Tile) == 0, "Tiled storages are only supported by the mc backend.");
+        };
     };
 
     /**
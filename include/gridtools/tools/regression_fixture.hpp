@@ -11,6 +11,7 @@
 
 #include <iostream>
 #include <utility>
+#include <vector>
 
 #include "../common/defs.hpp"
 #include "../stencil_composition/axis.hpp"
@@ -29,21 +30,35 @@ namespace gridtools {
                 computation_fixture<HaloSize, Axis>::verify(wstd::forward<Args>(args)...);
         }
 
+        /**
+         * Runs the computation `s_warmup` times and then measures `s_steps` runs with a flushed cache. The bandwidth
+         * and floating point rate are derived from the cost per point of the computation domain.
+         */
         template <class Comp>
-        void benchmark(Comp &&comp) const {
+        void benchmark(Comp &&comp, stencil_cost const &cost = {}) const {
             if (s_steps == 0)
                 return;
-            // we run a first time the stencil, since if there is data allocation before by other codes, the first run
-            // of the stencil is very slow (we dont know why). The flusher should make sure we flush the cache
-            comp.run();
+            // we run the stencil before measuring, since if there is data allocation before by other codes, the first
+            // run of the stencil is very slow (we dont know why). The flusher should make sure we flush the cache
+            for (size_t i = 0; i != s_warmup; ++i)
+                comp.run();
             comp.reset_meter();
+            std::vector<double> samples;
             for (size_t i = 0; i != s_steps; ++i) {
 #ifndef __CUDACC__
                 flush_cache();
 #endif
+                double start = comp.get_time();
                 comp.run();
+                samples.push_back(comp.get_time() - start);
             }
             std::cout << comp.print_meter() << std::endl;
+
+            const double points = double(this->d1() - 2 * HaloSize) * (this->d2() - 2 * HaloSize) * this->d3();
+            report(samples,
+                points,
+                (cost.loads + cost.stores) * (cost.value_size ? cost.value_size : sizeof(float_type)) * points,
+                cost.flops * points);
         }
     };
 } // namespace gridtools
@@ -9,9 +9,25 @@
  */
 #pragma once
 
+#include <vector>
+
 #include "../common/defs.hpp"
 
 namespace gridtools {
+    /**
+     * @brief Cost of a stencil per point of the computation domain, used to derive the metrics of a benchmark.
+     *
+     * `loads` and `stores` are the numbers of values that have to be moved from and to memory, assuming that every
+     * value is moved only once, `flops` is the number of floating point operations. `value_size` is the size of the
+     * stored values in bytes, if it differs from the size of float_type (e.g. for reduced precision storages).
+     */
+    struct stencil_cost {
+        double loads = 0;
+        double stores = 0;
+        double flops = 0;
+        double value_size = 0;
+    };
+
     namespace _impl {
         class regression_fixture_base {
           protected:
@@ -19,10 +35,17 @@ namespace gridtools {
             static uint_t s_d2;
             static uint_t s_d3;
             static uint_t s_steps;
+            static uint_t s_warmup;
             static bool s_needs_verification;
 
             static void flush_cache();
 
+            /**
+             * Prints the statistics of the benchmark samples [s], in a human-readable line and in a JSON line that is
+             * parsed by pyutils/perftest.
+             */
+            static void report(std::vector<double> const &samples, double points, double bytes, double flops);
+
           public:
             static void init(int argc, char **argv);
         };
@@ -16,6 +16,7 @@
 #include "../common/array_addons.hpp"
 #include "../common/gt_math.hpp"
 #include "../common/hypercube_iterator.hpp"
+#include "../common/reduced_precision.hpp"
 #include "../common/tuple_util.hpp"
 #include "../meta/type_traits.hpp"
 #include "../storage/common/storage_info_rt.hpp"
@@ -36,6 +37,18 @@ namespace gridtools {
         struct default_precision_impl<double> {
             static constexpr double value = 1e-14;
         };
+
+        // half of the spacing of the representable values, 2^-8 and 2^-11, with some slack for the rounding of
+        // intermediate results
+        template <>
+        struct default_precision_impl<bfloat16> {
+            static constexpr double value = 1e-2;
+        };
+
+        template <>
+        struct default_precision_impl<float16> {
+            static constexpr double value = 1e-3;
+        };
     } // namespace impl_
 
     template <class T>
@@ -50,7 +63,14 @@ namespace gridtools {
         return abs_error < precision || abs_error < abs_max * precision;
     }
 
-    template <typename T, typename Dummy = int, std::enable_if_t<!std::is_floating_point<T>::value, int> = 0>
+    template <typename T, std::enable_if_t<is_reduced_precision<T>::value, int> = 0>
+    GT_FUNCTION bool expect_with_threshold(T expected, T actual, double precision = default_precision<T>()) {
+        return expect_with_threshold<float>(expected, actual, precision);
+    }
+
+    template <typename T,
+        typename Dummy = int,
+        std::enable_if_t<!std::is_floating_point<T>::value && !is_reduced_precision<T>::value, int> = 0>
     GT_FUNCTION bool expect_with_threshold(T const &expected, T const &actual, Dummy = 0) {
         return actual == expected;
     }
@@ -113,6 +113,27 @@ if buildinfo:
                                  result)
 
 
+@perftest.command(description='compare performance results to a reference')
+@args.arg('--input', '-i', required=True, help='result file')
+@args.arg('--reference', '-r', required=True, help='reference result file')
+@args.arg('--threshold', '-t', default=0.1, type=float,
+          help='relative slowdown of the median run time that is reported '
+               'as a regression')
+def check(input, reference, threshold):
+    from perftest import result
+    comparisons = result.compare_to_reference(result.load(input),
+                                              result.load(reference),
+                                              threshold)
+    for c in comparisons:
+        log.info(f'{c["stencil"]}: {c["median"]:.6f} s (reference '
+                 f'{c["reference"]:.6f} s, {c["change"]:+.1%})')
+    regressed = [c['stencil'] for c in comparisons if c['regressed']]
+    if regressed:
+        raise RuntimeError('Performance regression in ' +
+                           ', '.join(regressed))
+    log.info('No performance regressions')
+
+
 @perftest.command(description='plot performance results')
 def plot():
     pass
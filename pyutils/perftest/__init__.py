@@ -1,5 +1,6 @@
 # -*- coding: utf-8 -*-
 
+import json
 import os
 import re
 
@@ -38,12 +39,36 @@ def _git_datetime():
     return time.from_posix(posixtime)
 
 
-def _parse_time(output):
-    p = re.compile(r'.*\[s\]\s*([0-9.]+).*', re.MULTILINE | re.DOTALL)
-    m = p.match(output)
-    if not m:
-        raise RuntimeError(f'Could not parse time in output:\n{output}')
-    return float(m.group(1))
+def _parse_results(output):
+    """Parses the JSON benchmark results printed by the regression fixture.
+
+    Returns:
+        A list of dicts, one per benchmark in the binary, with the samples,
+        percentiles, moved bytes and floating point operations.
+    """
+    results = [json.loads(m) for m in
+               re.findall(r'^benchmark result: (\{.*\})$', output,
+                          re.MULTILINE)]
+    if not results:
+        raise RuntimeError(
+            f'Could not parse benchmark results in output:\n{output}')
+    return results
+
+
+def _metrics(results):
+    """Computes total time, bandwidth and GFLOP/s of a run of a binary.
+
+    The total time is the sum of all samples (as measured by the meters of
+    the computations), the bandwidth and GFLOP/s are derived from the median
+    sample times.
+    """
+    total = sum(sum(r['samples']) for r in results)
+    median = sum(r['percentiles']['50'] for r in results)
+    nbytes = sum(r['bytes'] for r in results)
+    flops = sum(r['flops'] for r in results)
+    if median <= 0:
+        return total, None, None
+    return total, nbytes / median * 1e-9, flops / median * 1e-9
 
 
 def run(domain, runs):
@@ -60,8 +85,11 @@ def run(domain, runs):
         log.info('Running stencils')
         alloutputs = runtools.sbatch_retry(allcommands, 5)
         log.info('Running stencils finished')
-        alltimes = [_parse_time(o) for o in alloutputs]
-        times = [alltimes[i:i + runs] for i in range(0, len(alltimes), runs)]
+        allmetrics = [_metrics(_parse_results(o)) for o in alloutputs]
+        metrics = [list(zip(*allmetrics[i:i + runs]))
+                   for i in range(0, len(allmetrics), runs)]
+        times, bandwidths, gflops = (
+            [list(m[j]) for m in metrics] for j in range(3))
 
         info = result.RunInfo(name='gridtools',
                               version=_git_commit(),
@@ -73,5 +101,6 @@ def run(domain, runs):
                               hostname=env.hostname(),
                               clustername=env.clustername())
 
-        results[backend] = result.from_data(info, domain, stencils, times)
+        results[backend] = result.from_data(info, domain, stencils, times,
+                                            bandwidths, gflops)
     return results
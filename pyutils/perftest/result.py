@@ -6,7 +6,7 @@ from pyutils import log
 from perftest import time
 
 
-version = 0.5
+version = 0.6
 
 
 def record(name, attrs):
@@ -37,19 +37,27 @@ RunInfo = record('RunInfo',
                   'grid', 'compiler', 'hostname', 'clustername'])
 
 
-Time = record('Time', ['stencil', 'measurements'])
+Time = record('Time', ['stencil', 'measurements', 'bandwidth', 'gflops'])
 
 
-def from_data(runinfo, domain, stencils, times):
+def from_data(runinfo, domain, stencils, times, bandwidths=None,
+              gflops=None):
     """Creates a Result object from collected data.
 
     Args:
         runinfo: A `RunInfo` object.
         domain: The domain size as a tuple or list.
         times: List of list of run times per stencil.
+        bandwidths: Optional list of list of effective bandwidths [GB/s] per
+                    stencil.
+        gflops: Optional list of list of GFLOP/s per stencil.
     """
-    times_data = [Time(stencil=s.name, measurements=t) for s, t
-                  in zip(stencils, times)]
+    if bandwidths is None:
+        bandwidths = [[] for _ in stencils]
+    if gflops is None:
+        gflops = [[] for _ in stencils]
+    times_data = [Time(stencil=s.name, measurements=t, bandwidth=b, gflops=g)
+                  for s, t, b, g in zip(stencils, times, bandwidths, gflops)]
 
     return Result(runinfo=runinfo,
                   times=times_data,
@@ -90,7 +98,7 @@ def load(filename):
         data = json.load(fp)
     log.debug(f'Read json from {filename}', data)
 
-    if data['version'] == version:
+    if data['version'] in (version, 0.5):
         d = data['runinfo']
         runinfo_data = RunInfo(name=d['name'],
                                version=d['version'],
@@ -117,7 +125,10 @@ def load(filename):
     elif data['version'] != version:
         raise ValueError(f'Unknown result file version "{data["version"]}"')
 
-    times_data = [Time(stencil=d['stencil'], measurements=d['measurements'])
+    times_data = [Time(stencil=d['stencil'],
+                       measurements=d['measurements'],
+                       bandwidth=d.get('bandwidth', []),
+                       gflops=d.get('gflops', []))
                   for d in data['times']]
 
     result = Result(runinfo=runinfo_data,
@@ -173,3 +184,38 @@ def compare(results):
     diff = [{k: v for k, v in r if k not in common.keys()}
             for r in results]
     return common, diff
+
+
+def compare_to_reference(result, reference, threshold):
+    """Compares the median run times of a result to a reference result.
+
+    Args:
+        result: A `Result` object.
+        reference: A `Result` object, usually loaded from the stored
+                   references.
+        threshold: Relative slowdown of the median run time above which a
+                   stencil is reported as regressed.
+
+    Returns:
+        A list of dicts, one per stencil contained in both results, with the
+        median times, the relative change and whether it regressed.
+    """
+    def median(values):
+        values = sorted(values)
+        n = len(values)
+        return (values[(n - 1) // 2] + values[n // 2]) / 2
+
+    references = {t.stencil: t.measurements for t in reference.times}
+    comparisons = []
+    for t in result.times:
+        if t.stencil not in references or not t.measurements:
+            continue
+        current = median(t.measurements)
+        ref = median(references[t.stencil])
+        change = current / ref - 1
+        comparisons.append(dict(stencil=t.stencil,
+                                median=current,
+                                reference=ref,
+                                change=change,
+                                regressed=change > threshold))
+    return comparisons
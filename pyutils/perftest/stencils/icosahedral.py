@@ -27,3 +27,18 @@ class StencilOnNeighcellOfEdges(Stencil):
 class StencilManualFold(Stencil):
     gridtools_path = path('stencil_manual_fold')
     halo = 1
+
+
+class Curl(Stencil):
+    gridtools_path = path('curl')
+    halo = 2
+
+
+class Div(Stencil):
+    gridtools_path = path('div')
+    halo = 2
+
+
+class Lap(Stencil):
+    gridtools_path = path('lap')
+    halo = 2
@@ -0,0 +1,158 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <iostream>
+#include <mpi.h>
+#include <stdlib.h>
+#include <utility>
+#include <vector>
+
+#include <gridtools/communication/halo_exchange.hpp>
+
+#include "gtest/gtest.h"
+
+/**@file
+ * Compares the time of the halo exchange of the CPU pattern with the halos packed into buffers, sent with MPI derived
+ * datatypes and with the automatic selection between the two. The exchanged fields are compared across the modes.
+ */
+namespace halo_exchange_3D_modes {
+    typedef gridtools::halo_exchange_dynamic_ut<gridtools::layout_map<0, 1, 2>,
+        gridtools::layout_map<0, 1, 2>,
+        double,
+        gridtools::gcl_cpu>
+        pattern_type;
+
+    struct timings {
+        double pack = 0, exchange = 0, unpack = 0;
+    };
+
+    std::vector<std::vector<double>> make_fields(int n_fields, int size, int rank) {
+        std::vector<std::vector<double>> fields(n_fields, std::vector<double>(size));
+        for (int f = 0; f < n_fields; ++f)
+            for (int n = 0; n < size; ++n)
+                fields[f][n] = (rank * 10 + f) * 1e7 + n;
+        return fields;
+    }
+
+    /**
+     * Runs `iterations` exchanges of `n_fields` fields of DIM1 x DIM2 x DIM3 points with halo width H, returns the
+     * average time per exchange in milliseconds, maximized over the processes.
+     */
+    timings run(gridtools::halo_exchange_mode mode,
+        std::vector<std::vector<double>> &fields,
+        int DIM1,
+        int DIM2,
+        int DIM3,
+        int H,
+        int iterations,
+        MPI_Comm comm) {
+        pattern_type he(pattern_type::grid_type::period_type(true, true, true), comm);
+        he.set_exchange_mode(mode);
+        he.add_halo<0>(H, H, H, DIM1 + H - 1, DIM1 + 2 * H);
+        he.add_halo<1>(H, H, H, DIM2 + H - 1, DIM2 + 2 * H);
+        he.add_halo<2>(H, H, H, DIM3 + H - 1, DIM3 + 2 * H);
+        he.setup(fields.size());
+
+        std::vector<double *> ptrs;
+        for (auto &f : fields)
+            ptrs.push_back(f.data());
+
+        timings res;
+        // the first exchange creates the datatypes and is not timed
+        for (int it = -1; it < iterations; ++it) {
+            MPI_Barrier(comm);
+            double start = MPI_Wtime();
+            he.pack(ptrs);
+            double stop1 = MPI_Wtime();
+            he.exchange();
+            double stop2 = MPI_Wtime();
+            he.unpack(ptrs);
+            double stop3 = MPI_Wtime();
+            if (it >= 0) {
+                res.pack += stop1 - start;
+                res.exchange += stop2 - stop1;
+                res.unpack += stop3 - stop2;
+            }
+        }
+
+        double local[3] = {res.pack, res.exchange, res.unpack}, global[3];
+        MPI_Allreduce(local, global, 3, MPI_DOUBLE, MPI_MAX, comm);
+        res.pack = global[0] * 1000 / iterations;
+        res.exchange = global[1] * 1000 / iterations;
+        res.unpack = global[2] * 1000 / iterations;
+        return res;
+    }
+
+    bool test(int DIM1, int DIM2, int DIM3, int H, int n_fields, int iterations) {
+        int nprocs, pid;
+        MPI_Comm_size(gridtools::GCL_WORLD, &nprocs);
+        int dims[3] = {0, 0, 0};
+        MPI_Dims_create(nprocs, 3, dims);
+        int period[3] = {1, 1, 1};
+        MPI_Comm comm;
+        MPI_Cart_create(gridtools::GCL_WORLD, 3, dims, period, false, &comm);
+        MPI_Comm_rank(comm, &pid);
+
+        const int size = (DIM1 + 2 * H) * (DIM2 + 2 * H) * (DIM3 + 2 * H);
+        const std::pair<gridtools::halo_exchange_mode, char const *> modes[] = {
+            {gridtools::halo_exchange_mode::packing, "packing  "},
+            {gridtools::halo_exchange_mode::datatypes, "datatypes"},
+            {gridtools::halo_exchange_mode::automatic, "automatic"}};
+
+        if (pid == 0)
+            std::cout << "Halo exchange of " << n_fields << " fields of " << DIM1 << "x" << DIM2 << "x" << DIM3
+                      << " with halo " << H << " on " << dims[0] << "x" << dims[1] << "x" << dims[2]
+                      << " processes, average of " << iterations << " exchanges in ms" << std::endl;
+
+        bool passed = true;
+        std::vector<std::vector<double>> reference;
+        for (auto const &mode : modes) {
+            auto fields = make_fields(n_fields, size, pid);
+            timings t = run(mode.first, fields, DIM1, DIM2, DIM3, H, iterations, comm);
+            if (pid == 0)
+                std::cout << mode.second << " PACK: " << t.pack << " EXCH: " << t.exchange << " UNPK: " << t.unpack
+                          << " ALL: " << t.pack + t.exchange + t.unpack << std::endl;
+            if (reference.empty())
+                reference = fields;
+            else
+                passed = passed && fields == reference;
+        }
+
+        int all_passed;
+        int local_passed = passed;
+        MPI_Allreduce(&local_passed, &all_passed, 1, MPI_INT, MPI_LAND, comm);
+        MPI_Comm_free(&comm);
+        return all_passed;
+    }
+} // namespace halo_exchange_3D_modes
+
+#ifdef STANDALONE
+int main(int argc, char **argv) {
+    MPI_Init(&argc, &argv);
+    gridtools::GCL_Init(argc, argv);
+
+    if (argc != 7) {
+        std::cout << "Usage: benchmark_halo_exchange_3D_modes dimx dimy dimz halo fields iterations\n where args are "
+                     "integer sizes of the data fields, halo width, number of fields and number of exchanges"
+                  << std::endl;
+        return 1;
+    }
+
+    bool passed = halo_exchange_3D_modes::test(
+        atoi(argv[1]), atoi(argv[2]), atoi(argv[3]), atoi(argv[4]), atoi(argv[5]), atoi(argv[6]));
+
+    MPI_Finalize();
+    return passed ? 0 : 1;
+}
+#else
+TEST(Communication, benchmark_halo_exchange_3D_modes) {
+    bool passed = halo_exchange_3D_modes::test(64, 48, 20, 2, 3, 5);
+    EXPECT_TRUE(passed);
+}
+#endif
@@ -38,5 +38,5 @@ TEST_F(copy_stencil, test) {
 
     comp.run();
     verify(in, out);
-    benchmark(comp);
+    benchmark(comp, {1, 1, 0});
 }
@@ -28,6 +28,7 @@ namespace {
             m_meter.pause();
         }
         void reset_meter() { m_meter.reset(); }
+        double get_time() const { return m_meter.total_time(); }
         std::string print_meter() { return m_meter.to_string(); }
 
       private:
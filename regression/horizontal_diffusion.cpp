@@ -99,5 +99,5 @@ TEST_F(horizontal_diffusion, test) {
 
     comp.run();
     verify(make_storage(repo.out), out);
-    benchmark(comp);
+    benchmark(comp, {2, 1, 16});
 }
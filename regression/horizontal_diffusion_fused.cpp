@@ -100,5 +100,5 @@ TEST_F(horizontal_diffusion_fused, test) {
 
     comp.run();
     verify(make_storage(repo.out), out);
-    benchmark(comp);
+    benchmark(comp, {2, 1, 16});
 }
@@ -55,12 +55,14 @@ TEST_F(curl, weights) {
 }
 
 TEST_F(curl, flow_convention) {
-    make_computation(p_in_edges = make_storage<edges>(repo.u),
+    auto comp = make_computation(p_in_edges = make_storage<edges>(repo.u),
         p_dual_area_reciprocal = make_storage<vertices, vertex_2d_storage_type>(repo.dual_area_reciprocal),
         p_dual_edge_length = make_storage<edges, edge_2d_storage_type>(repo.dual_edge_length),
         p_out_vertices = out_vertices,
         make_multistage(execute::parallel(),
             make_stage<curl_functor_flow_convention, topology_t, vertices>(
-                p_in_edges, p_dual_area_reciprocal, p_dual_edge_length, p_out_vertices)))
-        .run();
+                p_in_edges, p_dual_area_reciprocal, p_dual_edge_length, p_out_vertices)));
+    comp.run();
+    // per point: the three edges of the vertex are loaded, the 2D fields are neglected
+    benchmark(comp, {3, 1, 13});
 }
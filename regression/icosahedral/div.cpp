@@ -52,12 +52,14 @@ TEST_F(div, reduction_into_scalar) {
 }
 
 TEST_F(div, flow_convention) {
-    make_computation(p_in_edges = make_storage<edges>(repo.u),
+    auto comp = make_computation(p_in_edges = make_storage<edges>(repo.u),
         p_edge_length = make_storage<edges, edge_2d_storage_type>(repo.edge_length),
         p_cell_area_reciprocal = make_storage<cells, cell_2d_storage_type>(repo.cell_area_reciprocal),
         p_out_cells = out_cells,
         make_multistage(execute::forward(),
             make_stage<div_functor_flow_convention_connectivity, topology_t, cells>(
-                p_in_edges, p_edge_length, p_cell_area_reciprocal, p_out_cells)))
-        .run();
+                p_in_edges, p_edge_length, p_cell_area_reciprocal, p_out_cells)));
+    comp.run();
+    // per point: the three edges are loaded for the two cells, the 2D fields are neglected
+    benchmark(comp, {3, 2, 14});
 }
@@ -0,0 +1,92 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <gtest/gtest.h>
+
+#include <gridtools/common/reduced_precision.hpp>
+#include <gridtools/stencil_composition/stencil_composition.hpp>
+#include <gridtools/tools/regression_fixture.hpp>
+
+using namespace gridtools;
+
+struct copy_functor {
+    using in = in_accessor<0>;
+    using out = inout_accessor<1>;
+    using param_list = make_param_list<in, out>;
+
+    template <typename Evaluation>
+    GT_FUNCTION static void apply(Evaluation eval) {
+        eval(out()) = eval(in());
+    }
+};
+
+struct lap_functor {
+    using in = in_accessor<0, extent<-1, 1, -1, 1>>;
+    using out = inout_accessor<1>;
+    using param_list = make_param_list<in, out>;
+
+    template <typename Evaluation>
+    GT_FUNCTION static void apply(Evaluation eval) {
+        eval(out()) = 4 * eval(in()) - (eval(in(1, 0)) + eval(in(0, 1)) + eval(in(-1, 0)) + eval(in(0, -1)));
+    }
+};
+
+// evaluated on SIMD packs by the mc backend
+struct simd_lap_functor : lap_functor {
+    using simd = std::true_type;
+};
+
+template <class T>
+struct reduced_precision : regression_fixture<1> {
+    using value_t = T;
+    using reduced_storage_t = storage_tr::data_store_t<T, storage_info_t>;
+
+    static float input(int i, int j, int k) { return (i * 7 + j * 13 + k * 3) % 23 * .25f - 2; }
+
+    template <class Functor>
+    void run_laplacian() {
+        arg<0, reduced_storage_t> p_in;
+        arg<1, reduced_storage_t> p_out;
+        auto in = make_storage<reduced_storage_t>(input);
+        auto out = make_storage<reduced_storage_t>(-1.);
+        // the stencil computes in float, from the rounded inputs
+        auto ref = [](int i, int j, int k) {
+            auto in = [](int i, int j, int k) { return float(T(input(i, j, k))); };
+            return 4 * in(i, j, k) - (in(i + 1, j, k) + in(i, j + 1, k) + in(i - 1, j, k) + in(i, j - 1, k));
+        };
+
+        auto comp = make_computation(
+            p_in = in, p_out = out, make_multistage(execute::parallel(), make_stage<Functor>(p_in, p_out)));
+        comp.run();
+        verify(make_storage<reduced_storage_t>(ref), out, default_precision<T>());
+        benchmark(comp, {1, 1, 6, sizeof(T)});
+    }
+};
+
+using reduced_precision_types = ::testing::Types<bfloat16, float16>;
+TYPED_TEST_CASE(reduced_precision, reduced_precision_types);
+
+TYPED_TEST(reduced_precision, copy) {
+    using storage_t = typename TestFixture::reduced_storage_t;
+    arg<0, storage_t> p_in;
+    arg<1, storage_t> p_out;
+    auto in = this->template make_storage<storage_t>(TestFixture::input);
+    auto out = this->template make_storage<storage_t>(-1.);
+
+    auto comp = this->make_computation(
+        p_in = in, p_out = out, make_multistage(execute::parallel(), make_stage<copy_functor>(p_in, p_out)));
+    comp.run();
+    // copies are exact
+    this->verify(in, out, default_precision<float>());
+    this->benchmark(comp, {1, 1, 0, sizeof(TypeParam)});
+}
+
+TYPED_TEST(reduced_precision, laplacian) { this->template run_laplacian<lap_functor>(); }
+
+TYPED_TEST(reduced_precision, simd_laplacian) { this->template run_laplacian<simd_lap_functor>(); }
@@ -192,5 +192,6 @@ TEST_F(vertical_advection_dycore, test) {
             make_stage<u_backward_function>(p_utens_stage, p_u_pos, p_dtr_stage, p_ccol, p_dcol, p_data_col)));
     comp.run();
     verify_utens_stage();
-    benchmark(comp);
+    // the flushed k-cached columns are stored by the forward and loaded again by the backward sweep
+    benchmark(comp, {7, 3, 31});
 }
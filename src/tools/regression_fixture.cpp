@@ -9,9 +9,13 @@
  */
 #include <gridtools/tools/regression_fixture_impl.hpp>
 
+#include <algorithm>
+#include <cmath>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
+#include <sstream>
+#include <string>
 #include <vector>
 
 #include <gtest/gtest.h>
@@ -24,6 +28,7 @@ namespace gridtools {
         uint_t regression_fixture_base::s_d2 = 0;
         uint_t regression_fixture_base::s_d3 = 0;
         uint_t regression_fixture_base::s_steps = 0;
+        uint_t regression_fixture_base::s_warmup = 1;
         bool regression_fixture_base::s_needs_verification = true;
 
         void regression_fixture_base::flush_cache() {
@@ -37,11 +42,54 @@ namespace gridtools {
                 a[i] = b[i] * c[i];
         }
 
+        namespace {
+            // percentile of sorted samples, linearly interpolated between the closest ranks
+            double percentile(std::vector<double> const &sorted, double q) {
+                double rank = q / 100 * (sorted.size() - 1);
+                std::size_t lower = std::floor(rank);
+                std::size_t upper = std::ceil(rank);
+                return sorted[lower] + (rank - lower) * (sorted[upper] - sorted[lower]);
+            }
+        } // namespace
+
+        void regression_fixture_base::report(
+            std::vector<double> const &samples, double points, double bytes, double flops) {
+            if (samples.empty())
+                return;
+            std::vector<double> sorted = samples;
+            std::sort(sorted.begin(), sorted.end());
+            const double median = percentile(sorted, 50);
+            const double bandwidth = median > 0 ? bytes / median * 1e-9 : 0;
+            const double gflops = median > 0 ? flops / median * 1e-9 : 0;
+
+            auto const *test_info = ::testing::UnitTest::GetInstance()->current_test_info();
+            std::string name = test_info ? std::string(test_info->test_case_name()) + "." + test_info->name() : "";
+
+            std::cout << "samples: " << samples.size() << ", median [s]: " << median
+                      << ", p10 [s]: " << percentile(sorted, 10) << ", p90 [s]: " << percentile(sorted, 90)
+                      << ", bandwidth [GB/s]: " << bandwidth << ", GFLOP/s: " << gflops
+                      << ", intensity [flop/B]: " << (bytes > 0 ? flops / bytes : 0) << std::endl;
+
+            std::ostringstream json;
+            json << "{\"stencil\": \"" << name << "\", \"domain\": [" << s_d1 << ", " << s_d2 << ", " << s_d3
+                 << "], \"warmup\": " << s_warmup << ", \"points\": " << points << ", \"bytes\": " << bytes
+                 << ", \"flops\": " << flops << ", \"samples\": [";
+            for (std::size_t i = 0; i != samples.size(); ++i)
+                json << (i ? ", " : "") << samples[i];
+            json << "], \"percentiles\": {";
+            const int qs[] = {0, 10, 25, 50, 75, 90, 100};
+            for (int q : qs)
+                json << (q ? ", " : "") << "\"" << q << "\": " << percentile(sorted, q);
+            json << "}, \"bandwidth\": " << bandwidth << ", \"gflops\": " << gflops << "}";
+            std::cout << "benchmark result: " << json.str() << std::endl;
+        }
+
         void regression_fixture_base::init(int argc, char **argv) {
             if (argc < 4) {
                 std::cerr << "Usage: " << argv[0] << " "
                           << "dimx dimy dimz tsteps\n\twhere args are integer sizes of the data fields and tsteps "
-                             "is the number of time steps to run in a benchmark run"
+                             "is the number of time steps to run in a benchmark run. The number of warm-up runs "
+                             "is taken from GT_BENCHMARK_WARMUP (1 by default)"
                           << std::endl;
                 exit(1);
             }
@@ -50,6 +98,8 @@ namespace gridtools {
             s_d3 = std::atoi(argv[3]);
             s_steps = argc > 4 ? std::atoi(argv[4]) : 0;
             s_needs_verification = argc < 6 || std::strcmp(argv[5], "-d") != 0;
+            if (char const *warmup = std::getenv("GT_BENCHMARK_WARMUP"))
+                s_warmup = std::atoi(warmup);
         }
     } // namespace _impl
 } // namespace gridtools
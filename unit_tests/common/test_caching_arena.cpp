@@ -0,0 +1,115 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gtest/gtest.h>
+
+#include <gridtools/common/caching_arena.hpp>
+#include <gridtools/storage/storage_facility.hpp>
+#include <gridtools/tools/backend_select.hpp>
+
+namespace gridtools {
+    namespace {
+        TEST(caching_arena, bucket_size) {
+            EXPECT_EQ(64, caching_arena::bucket_size(1));
+            EXPECT_EQ(64, caching_arena::bucket_size(64));
+            EXPECT_EQ(128, caching_arena::bucket_size(65));
+            EXPECT_EQ(2 * 1024 * 1024, caching_arena::bucket_size(2 * 1024 * 1024 - 1));
+            EXPECT_EQ(4 * 1024 * 1024, caching_arena::bucket_size(2 * 1024 * 1024 + 1));
+        }
+
+        TEST(caching_arena, reuse) {
+            caching_arena arena;
+            void *ptr = arena.allocate(1000, heap_upstream());
+            arena.deallocate(ptr, 1000, heap_upstream());
+
+            // same bucket, same upstream
+            EXPECT_EQ(ptr, arena.allocate(900, heap_upstream()));
+            // same bucket, different upstream
+            void *hugepage_ptr = arena.allocate(1000, hugepage_upstream());
+            EXPECT_NE(ptr, hugepage_ptr);
+
+            auto stats = arena.stats();
+            EXPECT_EQ(1, stats.hits);
+            EXPECT_EQ(2, stats.misses);
+            EXPECT_EQ(2048, stats.bytes_in_use);
+            EXPECT_EQ(0, stats.bytes_cached);
+            EXPECT_EQ(2048, stats.peak_bytes);
+
+            arena.deallocate(ptr, 900, heap_upstream());
+            arena.deallocate(hugepage_ptr, 1000, hugepage_upstream());
+            stats = arena.stats();
+            EXPECT_EQ(0, stats.bytes_in_use);
+            EXPECT_EQ(2048, stats.bytes_cached);
+
+            arena.release();
+            EXPECT_EQ(0, arena.stats().bytes_cached);
+            EXPECT_EQ(2048, arena.stats().peak_bytes);
+        }
+
+        TEST(caching_arena, max_cached_bytes) {
+            caching_arena arena(1024);
+            void *ptr1 = arena.allocate(1024, heap_upstream());
+            void *ptr2 = arena.allocate(1024, heap_upstream());
+            arena.deallocate(ptr1, 1024, heap_upstream());
+            arena.deallocate(ptr2, 1024, heap_upstream());
+            EXPECT_EQ(1024, arena.stats().bytes_cached);
+        }
+
+        TEST(caching_arena, scope) {
+            auto arena = std::make_shared<caching_arena>();
+            void *ptr;
+            {
+                caching_arena_scope scope(arena);
+                ptr = arena_allocate(100, hugepage_upstream()).get();
+                EXPECT_EQ(1, scope.stats().misses);
+                {
+                    caching_arena_scope inner;
+                    arena_allocate(100, hugepage_upstream());
+                    EXPECT_EQ(1, inner.stats().misses);
+                }
+                EXPECT_EQ(ptr, arena_allocate(100, hugepage_upstream()).get());
+                EXPECT_EQ(1, scope.stats().hits);
+            }
+            // no active arena
+            arena_allocate(100, hugepage_upstream());
+            EXPECT_EQ(2, arena->stats().hits + arena->stats().misses);
+        }
+
+        TEST(caching_arena, outlives_scope) {
+            arena_ptr ptr;
+            {
+                caching_arena_scope scope;
+                ptr = arena_allocate(100, heap_upstream());
+            }
+            // the block is returned to the arena of the ended scope, which is then destroyed
+            ptr.reset();
+        }
+
+        using storage_info_t = storage_traits<backend_t>::storage_info_t<0, 3>;
+        using data_store_t = storage_traits<backend_t>::data_store_t<double, storage_info_t>;
+
+        TEST(caching_arena, data_store) {
+            storage_info_t info(16, 17, 18);
+            auto arena = std::make_shared<caching_arena>();
+            double *ptr;
+            {
+                caching_arena_scope scope(arena);
+                data_store_t ds(info, 1.);
+                ptr = make_host_view(ds).data();
+            }
+            caching_arena_scope scope(arena);
+            data_store_t ds(info, 2.);
+            EXPECT_EQ(ptr, make_host_view(ds).data());
+            EXPECT_EQ(2., make_host_view(ds)(3, 4, 5));
+            EXPECT_EQ(1, arena->stats().hits);
+            EXPECT_EQ(1, arena->stats().misses);
+        }
+    } // namespace
+} // namespace gridtools
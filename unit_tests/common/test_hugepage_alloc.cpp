@@ -9,7 +9,9 @@
  */
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <set>
+#include <stdexcept>
 
 #include <gridtools/common/hugepage_alloc.hpp>
 
@@ -43,5 +45,58 @@ namespace gridtools {
             EXPECT_EQ(offsets.size(), checks);
         }
 
+        TEST(hugepage_alloc, strategy_names) {
+            for (auto strategy : {hugepage_strategy::transparent,
+                     hugepage_strategy::madvise,
+                     hugepage_strategy::hugetlb,
+                     hugepage_strategy::hugetlb_1gb})
+                EXPECT_EQ(strategy, parse_hugepage_strategy(hugepage_strategy_name(strategy)));
+            EXPECT_THROW(parse_hugepage_strategy("huge"), std::invalid_argument);
+        }
+
+        TEST(hugepage_alloc, set_strategy) {
+            auto previous = get_hugepage_strategy();
+            set_hugepage_strategy(hugepage_strategy::transparent);
+            void *ptr = hugepage_alloc(100);
+            EXPECT_EQ(hugepage_strategy::transparent, hugepage_info(ptr).requested);
+            hugepage_free(ptr);
+            set_hugepage_strategy(previous);
+        }
+
+        class hugepage_alloc_strategy : public ::testing::TestWithParam<hugepage_strategy> {};
+
+        TEST_P(hugepage_alloc_strategy, alloc_free) {
+            // hugetlb pages are only available if the pool is configured, the strategies fall back otherwise
+            const std::size_t n = 3 * 1024 * 1024;
+            for (std::size_t size : {std::size_t(100), n}) {
+                char *ptr = static_cast<char *>(hugepage_alloc(size, GetParam()));
+                EXPECT_EQ(reinterpret_cast<std::uintptr_t>(ptr) % 64, 0);
+                std::fill(ptr, ptr + size, 1);
+                EXPECT_EQ(size, std::count(ptr, ptr + size, 1));
+
+                auto info = hugepage_info(ptr);
+                EXPECT_EQ(GetParam(), info.requested);
+                EXPECT_LE(info.strategy, GetParam());
+                EXPECT_EQ(size, info.size);
+                EXPECT_EQ(info.strategy == hugepage_strategy::hugetlb_1gb ? 1024 * 1024 * 1024 : 2 * 1024 * 1024,
+                    info.page_size);
+                EXPECT_LE(info.huge_bytes, size);
+                if (info.strategy == hugepage_strategy::hugetlb || info.strategy == hugepage_strategy::hugetlb_1gb) {
+                    EXPECT_EQ(1., info.coverage());
+                }
+
+                hugepage_free(ptr);
+            }
+        }
+
+        INSTANTIATE_TEST_CASE_P(strategies,
+            hugepage_alloc_strategy,
+            ::testing::Values(hugepage_strategy::transparent,
+                hugepage_strategy::madvise,
+                hugepage_strategy::hugetlb,
+                hugepage_strategy::hugetlb_1gb));
+
+        TEST(hugepage_alloc, info_of_null) { EXPECT_EQ(0, hugepage_info(nullptr).size); }
+
     } // namespace
 } // namespace gridtools
@@ -0,0 +1,88 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gridtools/common/reduced_precision.hpp>
+
+#include <cmath>
+#include <limits>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/tools/verifier.hpp>
+
+namespace gridtools {
+    namespace {
+        TEST(reduced_precision, layout) {
+            EXPECT_EQ(2, sizeof(bfloat16));
+            EXPECT_EQ(2, sizeof(float16));
+            EXPECT_TRUE(std::is_trivial<bfloat16>::value);
+            EXPECT_TRUE(std::is_trivial<float16>::value);
+            EXPECT_TRUE((std::is_same<float, widened_t<bfloat16>>::value));
+            EXPECT_TRUE((std::is_same<double, widened_t<double>>::value));
+        }
+
+        template <class T>
+        void check_round_trip() {
+            for (std::uint32_t bits = 0; bits < 0x10000; ++bits) {
+                float value = T::from_bits(bits);
+                if (std::isnan(value))
+                    EXPECT_TRUE(std::isnan(float(T(value))));
+                else
+                    EXPECT_EQ(bits, T(value).bits()) << value;
+            }
+        }
+
+        TEST(reduced_precision, bfloat16_round_trip) { check_round_trip<bfloat16>(); }
+
+        TEST(reduced_precision, float16_round_trip) { check_round_trip<float16>(); }
+
+        TEST(reduced_precision, float16_values) {
+            EXPECT_EQ(0x3c00, float16(1.f).bits());
+            EXPECT_EQ(0xc000, float16(-2.f).bits());
+            EXPECT_EQ(0x7bff, float16(65504.f).bits());
+            EXPECT_EQ(0x0001, float16(5.9604644775390625e-8f).bits());
+            EXPECT_EQ(65504.f, float(float16::from_bits(0x7bff)));
+            EXPECT_EQ(std::pow(2.f, -24), float(float16::from_bits(0x0001)));
+            EXPECT_EQ(-0.f, float(float16::from_bits(0x8000)));
+        }
+
+        TEST(reduced_precision, rounding) {
+            // ties to even
+            EXPECT_EQ(1.f, float(float16(1 + std::pow(2.f, -11))));
+            EXPECT_EQ(1 + std::pow(2.f, -9), float(float16(1 + 3 * std::pow(2.f, -11))));
+            EXPECT_EQ(1.f, float(bfloat16(1 + std::pow(2.f, -8))));
+            EXPECT_EQ(1 + std::pow(2.f, -7), float(bfloat16(1 + std::pow(2.f, -8) + std::pow(2.f, -20))));
+            // overflows and subnormals
+            EXPECT_EQ(std::numeric_limits<float>::infinity(), float(float16(65520.f)));
+            EXPECT_EQ(-std::numeric_limits<float>::infinity(), float(float16(-1e10f)));
+            EXPECT_EQ(0.f, float(float16(std::pow(2.f, -26))));
+            EXPECT_EQ(std::pow(2.f, -24), float(float16(3 * std::pow(2.f, -26))));
+            EXPECT_TRUE(std::isnan(float(float16(std::numeric_limits<float>::quiet_NaN()))));
+            EXPECT_TRUE(std::isnan(float(bfloat16(std::numeric_limits<float>::quiet_NaN()))));
+        }
+
+        TEST(reduced_precision, arithmetic) {
+            bfloat16 a = 1.5, b = 2.;
+            float16 c = 3.;
+            EXPECT_EQ(3.5f, a + b);
+            EXPECT_EQ(4.5f, a * c);
+            EXPECT_TRUE(a < b);
+            a = a * 3;
+            EXPECT_EQ(4.5f, a);
+        }
+
+        TEST(reduced_precision, verifier) {
+            EXPECT_TRUE(expect_with_threshold(bfloat16(100.f), bfloat16(100.5f)));
+            EXPECT_FALSE(expect_with_threshold(bfloat16(100.f), bfloat16(104.f)));
+            EXPECT_TRUE(expect_with_threshold(float16(100.f), float16(100.05f)));
+            EXPECT_FALSE(expect_with_threshold(float16(100.f), float16(100.5f)));
+        }
+    } // namespace
+} // namespace gridtools
@@ -0,0 +1,90 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gridtools/common/simd_pack.hpp>
+
+#include <cmath>
+
+#include <gtest/gtest.h>
+
+using namespace gridtools;
+
+using pack_t = simd_pack<double, 4>;
+
+namespace {
+    pack_t make_pack(double a, double b, double c, double d) {
+        double values[] = {a, b, c, d};
+        return pack_t::load(values, 1, 4);
+    }
+
+    void expect_pack(pack_t const &pack, double a, double b, double c, double d) {
+        EXPECT_EQ(a, pack[0]);
+        EXPECT_EQ(b, pack[1]);
+        EXPECT_EQ(c, pack[2]);
+        EXPECT_EQ(d, pack[3]);
+    }
+} // namespace
+
+TEST(simd_pack, arithmetic) {
+    auto a = make_pack(1, 2, 3, 4);
+    auto b = make_pack(4, 3, 2, 1);
+    expect_pack(a + b, 5, 5, 5, 5);
+    expect_pack(a - b, -3, -1, 1, 3);
+    expect_pack(a * b, 4, 6, 6, 4);
+    expect_pack(a / b, .25, 2. / 3, 1.5, 4);
+    expect_pack(-a, -1, -2, -3, -4);
+    expect_pack(2 * a + 1, 3, 5, 7, 9);
+    a += b;
+    expect_pack(a, 5, 5, 5, 5);
+    expect_pack(pack_t(7), 7, 7, 7, 7);
+    expect_pack(pack_t::iota(3), 3, 4, 5, 6);
+    expect_pack(pack_t(simd_pack<int_t, 4>::iota(-1)), -1, 0, 1, 2);
+}
+
+TEST(simd_pack, load_store) {
+    double src[] = {1, 2, 3, 4, 5, 6, 7, 8};
+    expect_pack(pack_t::load(src, 2, 4), 1, 3, 5, 7);
+    expect_pack(pack_t::load(src + 3, 0, 4), 4, 4, 4, 4);
+    // inactive lanes repeat the first one
+    expect_pack(pack_t::load(src + 1, 1, 2), 2, 3, 2, 2);
+
+    double dst[] = {0, 0, 0, 0, 0, 0, 0, 0};
+    make_pack(1, 2, 3, 4).store(dst, 1, 4);
+    make_pack(5, 6, 7, 8).store(dst + 4, 1, 3);
+    EXPECT_EQ(1, dst[0]);
+    EXPECT_EQ(4, dst[3]);
+    EXPECT_EQ(7, dst[6]);
+    EXPECT_EQ(0, dst[7]);
+}
+
+TEST(simd_pack, select) {
+    auto a = make_pack(1, -2, 3, -4);
+    auto b = make_pack(0, 0, 5, -5);
+    auto mask = a > b;
+    EXPECT_TRUE(mask[0]);
+    EXPECT_FALSE(mask[1]);
+    EXPECT_FALSE(mask[2]);
+    EXPECT_TRUE(mask[3]);
+    expect_pack(select(mask, a, b), 1, 0, 5, -4);
+    expect_pack(select(a < 0 || b > 4, 0., a), 1, 0, 0, 0);
+    expect_pack(select(!(a < 0), a, -1.), 1, -1, 3, -1);
+    EXPECT_EQ(2, select(false, 1, 2));
+}
+
+TEST(simd_pack, math) {
+    auto a = make_pack(1, -4, 9, -16);
+    expect_pack(math::fabs(a), 1, 4, 9, 16);
+    expect_pack(math::sqrt(math::fabs(a)), 1, 2, 3, 4);
+    expect_pack(math::max(a, 0.), 1, 0, 9, 0);
+    expect_pack(math::min(a, make_pack(0, 0, 10, 0)), 0, -4, 9, -16);
+    expect_pack(math::pow(math::fabs(a), pack_t(.5)), 1, 2, 3, 4);
+    EXPECT_DOUBLE_EQ(std::exp(1.), math::exp(pack_t(1))[2]);
+    EXPECT_DOUBLE_EQ(1, math::log(pack_t(std::exp(1.)))[3]);
+}
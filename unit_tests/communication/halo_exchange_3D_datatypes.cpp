@@ -0,0 +1,154 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <vector>
+
+#include <mpi.h>
+
+#include "gtest/gtest.h"
+#include <gridtools/communication/halo_exchange.hpp>
+
+namespace {
+    using namespace gridtools;
+
+    MPI_Comm cart_comm() {
+        int nprocs;
+        MPI_Comm_size(GCL_WORLD, &nprocs);
+        int dims[3] = {0, 0, 0};
+        MPI_Dims_create(nprocs, 3, dims);
+        int period[3] = {1, 1, 1};
+        MPI_Comm comm;
+        MPI_Cart_create(GCL_WORLD, 3, dims, period, false, &comm);
+        return comm;
+    }
+
+    struct value_t {
+        double x;
+        int rank, field;
+    };
+
+    bool operator==(value_t const &a, value_t const &b) {
+        return a.x == b.x && a.rank == b.rank && a.field == b.field;
+    }
+
+    // sizes of the field along the logical dimensions i, j and k, including the halos
+    constexpr int n0 = 7, n1 = 9, n2 = 10;
+    constexpr int minus0 = 1, plus0 = 2, minus1 = 2, plus1 = 1, minus2 = 3, plus2 = 2;
+
+    template <typename Layout>
+    struct field {
+        std::vector<value_t> data;
+
+        field(int step, int f, int rank) : data(n0 * n1 * n2, value_t{-1, -1, -1}) {
+            for (int i = minus0; i < n0 - plus0; ++i)
+                for (int j = minus1; j < n1 - plus1; ++j)
+                    for (int k = minus2; k < n2 - plus2; ++k)
+                        at(i, j, k) = value_t{step * 1000. + i * 100 + j * 10 + k, rank, f};
+        }
+
+        value_t &at(int i, int j, int k) {
+            // the dimension with the largest value in the layout map has stride 1
+            auto idx = make_array(i, j, k);
+            auto len = make_array(n0, n1, n2);
+            return data[(idx[Layout::template find<0>()] * len[Layout::template find<1>()] +
+                            idx[Layout::template find<1>()]) *
+                            len[Layout::template find<2>()] +
+                        idx[Layout::template find<2>()]];
+        }
+    };
+
+    template <typename Layout>
+    using pattern_t = halo_exchange_dynamic_ut<Layout, layout_map<0, 1, 2>, value_t>;
+
+    template <typename Layout>
+    void setup(pattern_t<Layout> &he) {
+        he.template add_halo<0>(minus0, plus0, minus0, n0 - plus0 - 1, n0);
+        he.template add_halo<1>(minus1, plus1, minus1, n1 - plus1 - 1, n1);
+        he.template add_halo<2>(minus2, plus2, minus2, n2 - plus2 - 1, n2);
+        he.setup(3);
+    }
+
+    /**
+     * Exchanges with the given mode and compares with the packing mode. The fields are reallocated in some steps
+     * and the number of fields changes, so that the datatypes have to be recreated.
+     */
+    template <typename Layout>
+    void compare(halo_exchange_mode mode, std::size_t min_run_bytes, bool persistent) {
+        MPI_Comm comm = cart_comm();
+        int rank;
+        MPI_Comm_rank(comm, &rank);
+        pattern_t<Layout> reference(typename pattern_t<Layout>::grid_type::period_type(true, false, true), comm);
+        pattern_t<Layout> he(typename pattern_t<Layout>::grid_type::period_type(true, false, true), comm);
+        he.set_exchange_mode(mode, min_run_bytes);
+        he.set_persistent_requests(persistent);
+        setup(reference);
+        setup(he);
+
+        std::vector<field<Layout>> expected, actual;
+        for (int step = 0; step < 5; ++step) {
+            const int n_fields = step < 3 ? 3 : 2;
+            if (step % 2 == 0 || int(actual.size()) != n_fields) {
+                expected.clear();
+                actual.clear();
+                for (int f = 0; f < n_fields; ++f) {
+                    expected.emplace_back(step, f, rank);
+                    actual.emplace_back(step, f, rank);
+                }
+            } else {
+                for (int f = 0; f < n_fields; ++f)
+                    expected[f] = actual[f] = field<Layout>(step, f, rank);
+            }
+            std::vector<value_t *> expected_ptrs, actual_ptrs;
+            for (int f = 0; f < n_fields; ++f) {
+                expected_ptrs.push_back(expected[f].data.data());
+                actual_ptrs.push_back(actual[f].data.data());
+            }
+
+            reference.pack(expected_ptrs);
+            reference.exchange();
+            reference.unpack(expected_ptrs);
+
+            if (step == 4) {
+                he.pack(actual_ptrs[0], actual_ptrs[1]);
+                he.start_exchange();
+                he.wait();
+                he.unpack(actual_ptrs[0], actual_ptrs[1]);
+            } else {
+                he.pack(actual_ptrs);
+                he.exchange();
+                he.unpack(actual_ptrs);
+            }
+
+            for (int f = 0; f < n_fields; ++f) {
+                // the halos along the periodic dimension i are always updated
+                EXPECT_EQ(actual[f].at(0, minus1, minus2).field, f);
+                EXPECT_TRUE(expected[f].data == actual[f].data) << "step " << step << ", field " << f;
+            }
+        }
+    }
+
+    TEST(Communication, halo_exchange_datatypes) {
+        compare<layout_map<0, 1, 2>>(halo_exchange_mode::datatypes, 0, false);
+        compare<layout_map<2, 1, 0>>(halo_exchange_mode::datatypes, 0, false);
+        compare<layout_map<1, 2, 0>>(halo_exchange_mode::datatypes, 0, false);
+    }
+
+    TEST(Communication, halo_exchange_datatypes_persistent) {
+        compare<layout_map<0, 1, 2>>(halo_exchange_mode::datatypes, 0, true);
+        compare<layout_map<2, 0, 1>>(halo_exchange_mode::datatypes, 0, true);
+    }
+
+    TEST(Communication, halo_exchange_automatic) {
+        // with this limit, some regions of the fields are sent with datatypes and some packed
+        const std::size_t min_run_bytes = 3 * sizeof(value_t);
+        compare<layout_map<0, 1, 2>>(halo_exchange_mode::automatic, min_run_bytes, false);
+        compare<layout_map<2, 1, 0>>(halo_exchange_mode::automatic, min_run_bytes, true);
+        compare<layout_map<1, 0, 2>>(halo_exchange_mode::automatic, min_run_bytes, false);
+    }
+} // namespace
@@ -0,0 +1,169 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <vector>
+
+#include <mpi.h>
+
+#include "gtest/gtest.h"
+#include <gridtools/communication/halo_exchange.hpp>
+#include <gridtools/communication/low_level/Halo_Exchange_3D.hpp>
+#include <gridtools/communication/low_level/proc_grids_3D.hpp>
+
+namespace {
+    using grid_type = gridtools::MPI_3D_process_grid_t<3>;
+
+    MPI_Comm periodic_comm() {
+        int nprocs;
+        MPI_Comm_size(gridtools::GCL_WORLD, &nprocs);
+        int dims[3] = {0, 0, 0};
+        MPI_Dims_create(nprocs, 3, dims);
+        int period[3] = {1, 1, 1};
+        MPI_Comm comm;
+        MPI_Cart_create(gridtools::GCL_WORLD, 3, dims, period, false, &comm);
+        return comm;
+    }
+
+    int neighbor_index(int i, int j, int k) { return (i + 1) * 9 + (j + 1) * 3 + k + 1; }
+
+    // value sent in `step` by `rank` to its neighbor (i, j, k)
+    int message(int step, int rank, int i, int j, int k) {
+        return step * 100000 + rank * 100 + neighbor_index(i, j, k);
+    }
+
+    TEST(Communication, Halo_Exchange_3D_persistent) {
+        MPI_Comm comm = periodic_comm();
+        grid_type pg(gridtools::boollist<3>(true, true, true), comm);
+        gridtools::Halo_Exchange_3D<grid_type> he(pg);
+        he.set_persistent_requests(true);
+        EXPECT_TRUE(he.persistent_requests());
+
+        int rank;
+        MPI_Comm_rank(comm, &rank);
+
+        // two values per neighbor, the second one is only sent after the sizes are changed
+        std::vector<int> send(27 * 2), recv(27 * 2), other_recv(27 * 2);
+        for (int i = -1; i <= 1; ++i)
+            for (int j = -1; j <= 1; ++j)
+                for (int k = -1; k <= 1; ++k)
+                    if (i || j || k) {
+                        he.register_send_to_buffer(&send[2 * neighbor_index(i, j, k)], sizeof(int), i, j, k);
+                        he.register_receive_from_buffer(&recv[2 * neighbor_index(i, j, k)], sizeof(int), i, j, k);
+                    }
+
+        auto check = [&](int step, std::vector<int> const &received, int n) {
+            for (int i = -1; i <= 1; ++i)
+                for (int j = -1; j <= 1; ++j)
+                    for (int k = -1; k <= 1; ++k)
+                        if (i || j || k) {
+                            for (int m = 0; m < n; ++m) {
+                                EXPECT_EQ(received[2 * neighbor_index(i, j, k) + m],
+                                    message(step + m, pg.proc(i, j, k), -i, -j, -k))
+                                    << "step " << step << ", neighbor " << i << " " << j << " " << k;
+                            }
+                        }
+        };
+        auto fill = [&](int step) {
+            for (int i = -1; i <= 1; ++i)
+                for (int j = -1; j <= 1; ++j)
+                    for (int k = -1; k <= 1; ++k) {
+                        send[2 * neighbor_index(i, j, k)] = message(step, rank, i, j, k);
+                        send[2 * neighbor_index(i, j, k) + 1] = message(step + 1, rank, i, j, k);
+                    }
+        };
+
+        // the requests are created in the first exchange and reused afterwards
+        for (int step = 0; step < 3; ++step) {
+            fill(step);
+            he.exchange();
+            check(step, recv, 1);
+        }
+
+        // split phase exchange
+        fill(3);
+        he.post_receives();
+        he.do_sends();
+        he.wait();
+        check(3, recv, 1);
+
+        // changed sizes and buffers
+        for (int i = -1; i <= 1; ++i)
+            for (int j = -1; j <= 1; ++j)
+                for (int k = -1; k <= 1; ++k)
+                    if (i || j || k) {
+                        he.set_send_to_size(2 * sizeof(int), i, j, k);
+                        he.register_receive_from_buffer(
+                            &other_recv[2 * neighbor_index(i, j, k)], 2 * sizeof(int), i, j, k);
+                    }
+        fill(4);
+        he.exchange();
+        check(4, other_recv, 2);
+
+        he.set_persistent_requests(false);
+        EXPECT_FALSE(he.persistent_requests());
+        fill(6);
+        he.exchange();
+        check(6, other_recv, 2);
+    }
+
+    TEST(Communication, halo_exchange_dynamic_ut_persistent) {
+        using pattern_type =
+            gridtools::halo_exchange_dynamic_ut<gridtools::layout_map<0, 1, 2>, gridtools::layout_map<0, 1, 2>, int>;
+        const int n = 6, h = 2, size = n + 2 * h;
+
+        MPI_Comm comm = periodic_comm();
+        pattern_type reference(pattern_type::grid_type::period_type(true, true, true), comm);
+        pattern_type persistent(pattern_type::grid_type::period_type(true, true, true), comm);
+        persistent.set_persistent_requests(true);
+        for (auto *he : {&reference, &persistent}) {
+            he->add_halo<0>(h, h, h, n + h - 1, size);
+            he->add_halo<1>(h, h, h, n + h - 1, size);
+            he->add_halo<2>(h, h, h, n + h - 1, size);
+            he->setup(3);
+        }
+
+        int rank;
+        MPI_Comm_rank(comm, &rank);
+        std::vector<int> fields[2][3];
+        for (int step = 0; step < 4; ++step) {
+            // the number of fields changes after two steps
+            const int n_fields = step < 2 ? 3 : 2;
+            std::vector<int *> ptrs[2];
+            for (int p = 0; p < 2; ++p)
+                for (int f = 0; f < n_fields; ++f) {
+                    fields[p][f].assign(size * size * size, -1);
+                    for (int i = h; i < n + h; ++i)
+                        for (int j = h; j < n + h; ++j)
+                            for (int k = h; k < n + h; ++k)
+                                fields[p][f][(i * size + j) * size + k] = ((step * 10 + f) * 100 + rank) * 1000 + i;
+                    ptrs[p].push_back(fields[p][f].data());
+                }
+
+            reference.pack(ptrs[0]);
+            reference.exchange();
+            reference.unpack(ptrs[0]);
+
+            if (step % 2) {
+                persistent.post_receives();
+                persistent.pack(ptrs[1]);
+                persistent.do_sends();
+                persistent.wait();
+            } else {
+                persistent.pack(ptrs[1]);
+                persistent.exchange();
+            }
+            persistent.unpack(ptrs[1]);
+
+            for (int f = 0; f < n_fields; ++f) {
+                EXPECT_NE(fields[1][f].front(), -1) << "step " << step << ", field " << f;
+                EXPECT_EQ(fields[0][f], fields[1][f]) << "step " << step << ", field " << f;
+            }
+        }
+    }
+} // namespace
@@ -0,0 +1,164 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <cstdlib>
+#include <vector>
+
+#include <mpi.h>
+
+#include "gtest/gtest.h"
+#include <gridtools/communication/halo_exchange.hpp>
+#include <gridtools/communication/low_level/Halo_Exchange_3D.hpp>
+#include <gridtools/communication/low_level/proc_grids_3D.hpp>
+
+namespace {
+    using grid_type = gridtools::MPI_3D_process_grid_t<3>;
+
+    MPI_Comm periodic_comm() {
+        int nprocs;
+        MPI_Comm_size(gridtools::GCL_WORLD, &nprocs);
+        int dims[3] = {0, 0, 0};
+        MPI_Dims_create(nprocs, 3, dims);
+        int period[3] = {1, 1, 1};
+        MPI_Comm comm;
+        MPI_Cart_create(gridtools::GCL_WORLD, 3, dims, period, false, &comm);
+        return comm;
+    }
+
+    int neighbor_index(int i, int j, int k) { return (i + 1) * 9 + (j + 1) * 3 + k + 1; }
+
+    // value sent in `step` by `rank` to its neighbor (i, j, k)
+    int message(int step, int rank, int i, int j, int k) {
+        return step * 100000 + rank * 100 + neighbor_index(i, j, k);
+    }
+
+    void test_low_level(bool persistent) {
+        MPI_Comm comm = periodic_comm();
+        grid_type pg(gridtools::boollist<3>(true, true, true), comm);
+        gridtools::Halo_Exchange_3D<grid_type> he(pg);
+        he.set_persistent_requests(persistent);
+
+        int rank;
+        MPI_Comm_rank(comm, &rank);
+
+        std::vector<int> send(27), recv(27);
+        for (int i = -1; i <= 1; ++i)
+            for (int j = -1; j <= 1; ++j)
+                for (int k = -1; k <= 1; ++k)
+                    if (i || j || k) {
+                        he.register_send_to_buffer(&send[neighbor_index(i, j, k)], sizeof(int), i, j, k);
+                        he.register_receive_from_buffer(&recv[neighbor_index(i, j, k)], sizeof(int), i, j, k);
+                    }
+        he.setup_shared_memory();
+        EXPECT_TRUE(he.shared_memory());
+
+        // the faces are received through shared memory, the edges and corners with MPI
+        auto received = [&](int i, int j, int k) {
+            void *p = he.shared_receive_buffer(i, j, k);
+            return p && std::abs(i) + std::abs(j) + std::abs(k) == 1 ? *static_cast<int *>(p)
+                                                                     : recv[neighbor_index(i, j, k)];
+        };
+        for (int i = -1; i <= 1; ++i)
+            for (int j = -1; j <= 1; ++j)
+                for (int k = -1; k <= 1; ++k)
+                    if (std::abs(i) + std::abs(j) + std::abs(k) == 1 && he.shared_receive_buffer(i, j, k))
+                        he.register_receive_from_buffer(he.shared_receive_buffer(i, j, k), sizeof(int), i, j, k);
+
+        for (int step = 0; step < 4; ++step) {
+            for (int i = -1; i <= 1; ++i)
+                for (int j = -1; j <= 1; ++j)
+                    for (int k = -1; k <= 1; ++k)
+                        send[neighbor_index(i, j, k)] = message(step, rank, i, j, k);
+            if (step % 2) {
+                he.post_receives();
+                he.do_sends();
+                he.wait();
+            } else {
+                he.exchange();
+            }
+            for (int i = -1; i <= 1; ++i)
+                for (int j = -1; j <= 1; ++j)
+                    for (int k = -1; k <= 1; ++k)
+                        if (i || j || k) {
+                            EXPECT_EQ(received(i, j, k), message(step, pg.proc(i, j, k), -i, -j, -k))
+                                << "step " << step << ", neighbor " << i << " " << j << " " << k;
+                        }
+        }
+    }
+
+    TEST(Communication, Halo_Exchange_3D_shared_memory) { test_low_level(false); }
+
+    TEST(Communication, Halo_Exchange_3D_shared_memory_persistent) { test_low_level(true); }
+
+    using pattern_type =
+        gridtools::halo_exchange_dynamic_ut<gridtools::layout_map<0, 1, 2>, gridtools::layout_map<0, 1, 2>, double>;
+
+    void test_dynamic_ut(bool persistent, gridtools::halo_exchange_mode mode) {
+        const int n = 6, h = 2, size = n + 2 * h;
+
+        MPI_Comm comm = periodic_comm();
+        pattern_type reference(pattern_type::grid_type::period_type(true, false, true), comm);
+        pattern_type shared(pattern_type::grid_type::period_type(true, false, true), comm);
+        shared.set_shared_memory(true);
+        shared.set_persistent_requests(persistent);
+        shared.set_exchange_mode(mode, 2 * n * sizeof(double));
+        for (auto *he : {&reference, &shared}) {
+            he->add_halo<0>(h, h, h, n + h - 1, size);
+            he->add_halo<1>(h, h, h, n + h - 1, size);
+            he->add_halo<2>(h, h, h, n + h - 1, size);
+            he->setup(3);
+        }
+        EXPECT_TRUE(shared.pattern().shared_memory());
+
+        int rank;
+        MPI_Comm_rank(comm, &rank);
+        std::vector<double> fields[2][3];
+        for (int step = 0; step < 4; ++step) {
+            // the number of fields changes after two steps
+            const int n_fields = step < 2 ? 3 : 2;
+            std::vector<double *> ptrs[2];
+            for (int p = 0; p < 2; ++p)
+                for (int f = 0; f < n_fields; ++f) {
+                    fields[p][f].assign(size * size * size, -1);
+                    for (int i = h; i < n + h; ++i)
+                        for (int j = h; j < n + h; ++j)
+                            for (int k = h; k < n + h; ++k)
+                                fields[p][f][(i * size + j) * size + k] = ((step * 10 + f) * 100 + rank) * 1000 + i;
+                    ptrs[p].push_back(fields[p][f].data());
+                }
+
+            reference.pack(ptrs[0]);
+            reference.exchange();
+            reference.unpack(ptrs[0]);
+
+            shared.pack(ptrs[1]);
+            if (step % 2) {
+                shared.start_exchange();
+                shared.wait();
+            } else {
+                shared.exchange();
+            }
+            shared.unpack(ptrs[1]);
+
+            for (int f = 0; f < n_fields; ++f)
+                EXPECT_EQ(fields[0][f], fields[1][f]) << "step " << step << ", field " << f;
+        }
+    }
+
+    TEST(Communication, halo_exchange_dynamic_ut_shared_memory) {
+        test_dynamic_ut(false, gridtools::halo_exchange_mode::packing);
+        test_dynamic_ut(true, gridtools::halo_exchange_mode::packing);
+    }
+
+    TEST(Communication, halo_exchange_dynamic_ut_shared_memory_datatypes) {
+        // the neighbors with datatypes are not sent through shared memory
+        test_dynamic_ut(false, gridtools::halo_exchange_mode::automatic);
+        test_dynamic_ut(true, gridtools::halo_exchange_mode::automatic);
+    }
+} // namespace
@@ -0,0 +1,126 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <gridtools/communication/high_level/halo_region.hpp>
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace gridtools {
+    namespace {
+        // field of 2 + 5 + 3 by 1 + 4 + 2 by 2 + 3 + 2 elements
+        array<halo_descriptor, 3> halos() {
+            return {halo_descriptor(2, 3, 2, 6, 10), halo_descriptor(1, 2, 1, 4, 7), halo_descriptor(2, 2, 2, 4, 7)};
+        }
+
+        int index(int i, int j, int k) { return i + 10 * j + 70 * k; }
+
+        TEST(halo_region, corner) {
+            auto region = _impl::make_halo_region<true>(halos(), {-1, -1, -1});
+            EXPECT_EQ(region.offset, index(2, 1, 2));
+            EXPECT_EQ(region.run, 3);
+            EXPECT_EQ(region.rows(), 2 * 2);
+            EXPECT_EQ(region.size(), 3 * 2 * 2);
+
+            region = _impl::make_halo_region<false>(halos(), {1, 1, 1});
+            EXPECT_EQ(region.offset, index(7, 5, 5));
+            EXPECT_EQ(region.size(), 3 * 2 * 2);
+        }
+
+        TEST(halo_region, merges_contiguous_dimensions) {
+            array<halo_descriptor, 3> full = {
+                halo_descriptor(0, 0, 0, 9, 10), halo_descriptor(0, 0, 0, 6, 7), halo_descriptor(2, 2, 2, 4, 7)};
+            auto region = _impl::make_halo_region<true>(full, {0, 0, 1});
+            EXPECT_EQ(region.offset, index(0, 0, 3));
+            EXPECT_EQ(region.run, 10 * 7 * 2);
+            EXPECT_EQ(region.rows(), 1);
+
+            region = _impl::make_halo_region<true>(full, {0, 0, 0});
+            EXPECT_EQ(region.offset, index(0, 0, 2));
+            EXPECT_EQ(region.run, 10 * 7 * 3);
+            EXPECT_EQ(region.rows(), 1);
+        }
+
+        TEST(halo_region, empty) {
+            array<halo_descriptor, 3> no_halo = {
+                halo_descriptor(0, 0, 0, 9, 10), halo_descriptor(0, 0, 0, 6, 7), halo_descriptor(0, 0, 0, 6, 7)};
+            auto region = _impl::make_halo_region<false>(no_halo, {1, 0, 0});
+            EXPECT_EQ(region.rows(), 0);
+            EXPECT_EQ(region.size(), 0);
+        }
+
+        TEST(halo_region, pack_unpack_roundtrip) {
+            std::vector<int> field(10 * 7 * 7);
+            for (std::size_t n = 0; n < field.size(); ++n)
+                field[n] = n;
+
+            for (int ii = -1; ii <= 1; ++ii)
+                for (int jj = -1; jj <= 1; ++jj)
+                    for (int kk = -1; kk <= 1; ++kk) {
+                        array<int, 3> eta = {ii, jj, kk};
+                        auto send = _impl::make_halo_region<true>(halos(), eta);
+                        std::vector<int> buffer(send.size());
+
+                        _impl::halo_copy_tasks<int> tasks;
+                        EXPECT_EQ(tasks.add_pack(send, field.data(), buffer.data()), buffer.data() + buffer.size());
+                        tasks.pack();
+
+                        // the buffer holds the elements in the order of increasing strides
+                        auto it = buffer.begin();
+                        for (int k = halos()[2].loop_low_bound_inside(kk); k <= halos()[2].loop_high_bound_inside(kk);
+                             ++k)
+                            for (int j = halos()[1].loop_low_bound_inside(jj);
+                                 j <= halos()[1].loop_high_bound_inside(jj);
+                                 ++j)
+                                for (int i = halos()[0].loop_low_bound_inside(ii);
+                                     i <= halos()[0].loop_high_bound_inside(ii);
+                                     ++i)
+                                    EXPECT_EQ(*it++, index(i, j, k));
+                        EXPECT_EQ(it, buffer.end());
+
+                        std::vector<int> target(field.size(), -1);
+                        auto recv = send;
+                        tasks.clear();
+                        tasks.add_unpack(recv, buffer.data(), target.data());
+                        tasks.unpack();
+                        std::size_t unpacked = 0;
+                        for (std::size_t n = 0; n < field.size(); ++n) {
+                            if (target[n] != -1) {
+                                EXPECT_EQ(target[n], field[n]);
+                                ++unpacked;
+                            }
+                        }
+                        EXPECT_EQ(unpacked, buffer.size());
+                    }
+        }
+
+        TEST(halo_region, large_faces_are_split) {
+            array<halo_descriptor, 3> big = {halo_descriptor(3, 3, 3, 402, 406),
+                halo_descriptor(3, 3, 3, 402, 406),
+                halo_descriptor(0, 0, 0, 79, 80)};
+            auto region = _impl::make_halo_region<true>(big, {0, 1, 0});
+            EXPECT_EQ(region.run, 400);
+            EXPECT_EQ(region.rows(), 3 * 80);
+
+            std::vector<double> field(406 * 406 * 80), buffer(region.size()), target(field.size());
+            for (std::size_t n = 0; n < field.size(); ++n)
+                field[n] = n;
+            _impl::halo_copy_tasks<double> tasks;
+            tasks.add_pack(region, field.data(), buffer.data());
+            tasks.pack();
+            tasks.clear();
+            tasks.add_unpack(region, buffer.data(), target.data());
+            tasks.unpack();
+            for (std::ptrdiff_t row = 0; row < region.rows(); ++row)
+                for (std::ptrdiff_t n = 0; n < region.run; ++n)
+                    EXPECT_EQ(target[region.row_offset(row) + n], region.row_offset(row) + n);
+        }
+    } // namespace
+} // namespace gridtools
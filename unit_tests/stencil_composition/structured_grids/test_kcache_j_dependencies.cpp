@@ -0,0 +1,189 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include "kcache_fixture.hpp"
+#include "gtest/gtest.h"
+#include <gridtools/stencil_composition/stencil_composition.hpp>
+#include <gridtools/tools/verifier.hpp>
+
+using namespace gridtools;
+
+struct sum_forward {
+    typedef accessor<0, intent::in> in;
+    typedef accessor<1, intent::inout, extent<0, 0, 0, 0, -1, 0>> sum;
+
+    typedef make_param_list<in, sum> param_list;
+
+    template <typename Evaluation>
+    GT_FUNCTION static void apply(Evaluation &eval, kminimum) {
+        eval(sum()) = eval(in());
+    }
+
+    template <typename Evaluation>
+    GT_FUNCTION static void apply(Evaluation &eval, kbody_high) {
+        eval(sum()) = eval(sum(0, 0, -1)) + eval(in());
+    }
+};
+
+struct sum_backward {
+    typedef accessor<0, intent::in> in;
+    typedef accessor<1, intent::inout, extent<0, 0, 0, 0, 0, 1>> sum;
+
+    typedef make_param_list<in, sum> param_list;
+
+    template <typename Evaluation>
+    GT_FUNCTION static void apply(Evaluation &eval, kmaximum) {
+        eval(sum()) = eval(in());
+    }
+
+    template <typename Evaluation>
+    GT_FUNCTION static void apply(Evaluation &eval, kbody_low) {
+        eval(sum()) = eval(sum(0, 0, 1)) + eval(in());
+    }
+};
+
+struct copy_sum {
+    typedef accessor<0, intent::in> sum;
+    typedef accessor<1, intent::inout> out;
+
+    typedef make_param_list<sum, out> param_list;
+
+    template <typename Evaluation>
+    GT_FUNCTION static void apply(Evaluation &eval, kfull) {
+        eval(out()) = eval(sum());
+    }
+};
+
+struct j_neighbors {
+    typedef accessor<0, intent::in> sum;
+    typedef accessor<1, intent::in, extent<0, 0, -1, 1>> copy;
+    typedef accessor<2, intent::inout> out;
+
+    typedef make_param_list<sum, copy, out> param_list;
+
+    template <typename Evaluation>
+    GT_FUNCTION static void apply(Evaluation &eval, kfull) {
+        eval(out()) = eval(copy(0, -1, 0)) + eval(sum()) + 2 * eval(copy(0, 1, 0));
+    }
+};
+
+struct same_row {
+    typedef accessor<0, intent::in> sum;
+    typedef accessor<1, intent::in> copy;
+    typedef accessor<2, intent::inout> out;
+
+    typedef make_param_list<sum, copy, out> param_list;
+
+    template <typename Evaluation>
+    GT_FUNCTION static void apply(Evaluation &eval, kfull) {
+        eval(out()) = eval(copy()) + eval(sum()) + 2 * eval(copy());
+    }
+};
+
+// the values cached in k are read from the neighboring j-rows through a temporary written by another stage
+class kcache_j_dependencies : public ::testing::Test {
+  protected:
+    typedef storage_traits<backend_t>::storage_info_t<0, 3, halo<1, 1, 0>> storage_info_t;
+    typedef storage_traits<backend_t>::data_store_t<float_type, storage_info_t> storage_t;
+
+    typedef arg<0, storage_t> p_in;
+    typedef arg<1, storage_t> p_out;
+    typedef tmp_arg<2, storage_t> p_sum;
+    typedef tmp_arg<3, storage_t> p_copy;
+
+    const uint_t m_d1 = 13, m_d2 = 11, m_d3 = 10;
+
+    grid<axis_t::axis_interval_t> m_grid;
+    storage_info_t m_meta;
+    storage_t m_in, m_out, m_ref;
+
+    kcache_j_dependencies()
+        : m_grid(make_grid(halo_descriptor{1, 1, 1, m_d1 - 2, m_d1},
+              halo_descriptor{1, 1, 1, m_d2 - 2, m_d2},
+              axis_t(2u, m_d3 - 4u, 2u))),
+          m_meta(m_d1, m_d2, m_d3), m_in(m_meta, [](int i, int j, int k) { return i + 3 * j + 7 * k + 1; }, "in"),
+          m_out(m_meta, -1., "out"), m_ref(m_meta, -1., "ref") {}
+
+    void compute_reference(bool forward, int j_offset = 1) {
+        auto in = make_host_view(m_in);
+        auto ref = make_host_view(m_ref);
+        std::vector<float_type> sum(m_d1 * m_d2 * m_d3);
+        auto at = [&](uint_t i, uint_t j, uint_t k) -> float_type & { return sum[(k * m_d2 + j) * m_d1 + i]; };
+        for (uint_t i = 0; i < m_d1; ++i)
+            for (uint_t j = 0; j < m_d2; ++j)
+                for (uint_t kk = 0; kk < m_d3; ++kk) {
+                    uint_t k = forward ? kk : m_d3 - 1 - kk;
+                    at(i, j, k) = in(i, j, k) + (kk ? at(i, j, forward ? k - 1 : k + 1) : 0);
+                }
+        for (uint_t i = 1; i < m_d1 - 1; ++i)
+            for (uint_t j = 1; j < m_d2 - 1; ++j)
+                for (uint_t k = 0; k < m_d3; ++k)
+                    ref(i, j, k) = at(i, j - j_offset, k) + at(i, j, k) + 2 * at(i, j + j_offset, k);
+    }
+
+    void verify() {
+        m_out.sync();
+        m_out.reactivate_host_write_views();
+#if GT_FLOAT_PRECISION == 4
+        verifier verif(1e-6);
+#else
+        verifier verif(1e-10);
+#endif
+        array<array<uint_t, 2>, 3> halos{{{1, 1}, {1, 1}, {0, 0}}};
+        ASSERT_TRUE(verif.verify(m_grid, m_ref, m_out, halos));
+    }
+};
+
+TEST_F(kcache_j_dependencies, forward) {
+    compute_reference(true);
+
+    auto kcache_stencil = make_computation<backend_t>(m_grid,
+        p_in() = m_in,
+        p_out() = m_out,
+        make_multistage(execute::forward(),
+            define_caches(cache<cache_type::k, cache_io_policy::local>(p_sum())),
+            make_stage<sum_forward>(p_in(), p_sum()),
+            make_stage<copy_sum>(p_sum(), p_copy()),
+            make_stage<j_neighbors>(p_sum(), p_copy(), p_out())));
+
+    kcache_stencil.run();
+    verify();
+}
+
+TEST_F(kcache_j_dependencies, backward) {
+    compute_reference(false);
+
+    auto kcache_stencil = make_computation<backend_t>(m_grid,
+        p_in() = m_in,
+        p_out() = m_out,
+        make_multistage(execute::backward(),
+            define_caches(cache<cache_type::k, cache_io_policy::local>(p_sum())),
+            make_stage<sum_backward>(p_in(), p_sum()),
+            make_stage<copy_sum>(p_sum(), p_copy()),
+            make_stage<j_neighbors>(p_sum(), p_copy(), p_out())));
+
+    kcache_stencil.run();
+    verify();
+}
+
+TEST_F(kcache_j_dependencies, same_row) {
+    compute_reference(true, 0);
+
+    auto kcache_stencil = make_computation<backend_t>(m_grid,
+        p_in() = m_in,
+        p_out() = m_out,
+        make_multistage(execute::forward(),
+            define_caches(cache<cache_type::k, cache_io_policy::local>(p_sum())),
+            make_stage<sum_forward>(p_in(), p_sum()),
+            make_stage<copy_sum>(p_sum(), p_copy()),
+            make_stage<same_row>(p_sum(), p_copy(), p_out())));
+
+    kcache_stencil.run();
+    verify();
+}
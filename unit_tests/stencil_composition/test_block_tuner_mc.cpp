@@ -0,0 +1,175 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include <string>
+#include <utility>
+
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/stencil_composition/backend_mc/block_tuner_mc.hpp>
+#include <gridtools/stencil_composition/stencil_composition.hpp>
+#include <gridtools/storage/storage_facility.hpp>
+#include <gridtools/tools/backend_select.hpp>
+#include <gridtools/tools/verifier.hpp>
+
+using namespace gridtools;
+
+namespace {
+    using shape_t = std::pair<int_t, int_t>;
+
+    shape_t shape(execinfo_mc const &exinfo) { return {exinfo.i_block_size(), exinfo.j_block_size()}; }
+
+    // all candidates but the target one are slow
+    struct slow_f {
+        shape_t m_target;
+        std::set<shape_t> &m_seen;
+
+        void operator()(execinfo_mc const &exinfo) const {
+            m_seen.insert(shape(exinfo));
+            if (shape(exinfo) != m_target)
+                for (double start = omp_get_wtime(); omp_get_wtime() - start < 1e-3;)
+                    ;
+        }
+    };
+} // namespace
+
+TEST(block_tuner_mc, tunes_and_persists) {
+    const char *file = "test_block_tuner_mc.cache";
+    std::remove(file);
+
+    auto grid = make_grid(40, 64, 5);
+    execinfo_mc default_exinfo(grid);
+    auto candidates = _impl_block_tuner_mc::candidates(default_exinfo.i_block_size(), default_exinfo.j_block_size());
+    ASSERT_FALSE(candidates.empty());
+    EXPECT_EQ(shape(default_exinfo), candidates.front());
+    shape_t target = candidates.back();
+
+    std::set<shape_t> seen;
+    {
+        block_tuner_mc tuner(file, 2);
+        for (std::size_t i = 0; i < 2 * candidates.size(); ++i)
+            tuner.run<int>(grid, slow_f{target, seen});
+        EXPECT_EQ(candidates.size(), seen.size());
+        for (auto const &s : seen) {
+            EXPECT_LE(s.first, default_exinfo.i_block_size());
+            EXPECT_LE(s.second, default_exinfo.j_block_size());
+        }
+        ASSERT_EQ(1, tuner.cache().size());
+        EXPECT_EQ(target, tuner.cache().at(block_tuner_mc::key<int>(grid)));
+        // the cache file is written through a temporary file of this process
+        EXPECT_FALSE(std::ifstream(file + std::string(".") + std::to_string(getpid()) + ".tmp"));
+
+        seen.clear();
+        tuner.run<int>(grid, slow_f{target, seen});
+        EXPECT_EQ(std::set<shape_t>{target}, seen);
+    }
+
+    // a new tuner starts with the tuned block sizes
+    seen.clear();
+    block_tuner_mc tuner(file);
+    tuner.run<int>(grid, slow_f{target, seen});
+    EXPECT_EQ(std::set<shape_t>{target}, seen);
+
+    // other stencils are tuned separately
+    seen.clear();
+    tuner.run<double>(grid, slow_f{target, seen});
+    EXPECT_EQ(std::set<shape_t>{candidates.front()}, seen);
+
+    std::remove(file);
+}
+
+TEST(block_tuner_mc, throws_if_cache_not_writable) {
+    auto grid = make_grid(40, 64, 5);
+    execinfo_mc default_exinfo(grid);
+    auto candidates = _impl_block_tuner_mc::candidates(default_exinfo.i_block_size(), default_exinfo.j_block_size());
+    std::set<shape_t> seen;
+    block_tuner_mc tuner("test_block_tuner_mc_missing_dir/test.cache", 1);
+    for (std::size_t i = 0; i + 1 < candidates.size(); ++i)
+        tuner.run<int>(grid, slow_f{candidates.back(), seen});
+    EXPECT_THROW(tuner.run<int>(grid, slow_f{candidates.back(), seen}), std::runtime_error);
+}
+
+#ifdef GT_BACKEND_MC
+namespace {
+    struct lap_functor {
+        using in = accessor<0, intent::in, extent<-1, 1, -1, 1>>;
+        using out = accessor<1, intent::inout>;
+        using param_list = make_param_list<in, out>;
+
+        template <typename Evaluation>
+        GT_FUNCTION static void apply(Evaluation &eval) {
+            eval(out()) = 4 * eval(in()) - eval(in(-1, 0, 0)) - eval(in(1, 0, 0)) - eval(in(0, -1, 0)) -
+                          eval(in(0, 1, 0));
+        }
+    };
+
+    struct copy_functor {
+        using in = accessor<0, intent::in, extent<-1, 1, -1, 1>>;
+        using out = accessor<1, intent::inout>;
+        using param_list = make_param_list<in, out>;
+
+        template <typename Evaluation>
+        GT_FUNCTION static void apply(Evaluation &eval) {
+            eval(out()) = eval(in(-1, 0, 0)) + eval(in(1, 0, 0)) + eval(in(0, -1, 0)) + eval(in(0, 1, 0));
+        }
+    };
+} // namespace
+
+TEST(block_tuner_mc, stencil) {
+    using storage_info_t = storage_traits<backend_t>::storage_info_t<0, 3, halo<2, 2, 0>>;
+    using storage_t = storage_traits<backend_t>::data_store_t<float_type, storage_info_t>;
+    using p_in = arg<0, storage_t>;
+    using p_out = arg<1, storage_t>;
+    using p_tmp = tmp_arg<2, storage_t>;
+
+    const uint_t d1 = 37, d2 = 23, d3 = 5;
+    storage_info_t info{d1 + 4, d2 + 4, d3};
+    storage_t in{info, [](int i, int j, int k) { return i + 10 * j + 100 * k; }};
+    storage_t out{info, 0};
+    storage_t ref{info, 0};
+
+    auto inv = make_host_view(in);
+    auto refv = make_host_view(ref);
+    auto lap = [&](int i, int j, int k) {
+        return 4 * inv(i, j, k) - inv(i - 1, j, k) - inv(i + 1, j, k) - inv(i, j - 1, k) - inv(i, j + 1, k);
+    };
+    for (int i = 2; i < d1 + 2; ++i)
+        for (int j = 2; j < d2 + 2; ++j)
+            for (int k = 0; k < d3; ++k)
+                refv(i, j, k) = lap(i - 1, j, k) + lap(i + 1, j, k) + lap(i, j - 1, k) + lap(i, j + 1, k);
+
+    halo_descriptor di{2, 2, 2, d1 + 1, d1 + 4};
+    halo_descriptor dj{2, 2, 2, d2 + 1, d2 + 4};
+    auto grid = make_grid(di, dj, d3);
+
+    block_tuner_mc tuner;
+    auto comp = make_computation<backend_t>(grid,
+        tuner,
+        p_in() = in,
+        p_out() = out,
+        make_multistage(
+            execute::forward(), make_stage<lap_functor>(p_in(), p_tmp()), make_stage<copy_functor>(p_tmp(), p_out())));
+
+    verifier verif(1e-10);
+    array<array<uint_t, 2>, 3> halos{{{2, 2}, {2, 2}, {0, 0}}};
+    for (int run = 0; run < 40; ++run) {
+        make_host_view(out)(2, 2, 0) = -1;
+        comp.run();
+        out.sync();
+        ASSERT_TRUE(verif.verify(grid, ref, out, halos)) << "run " << run;
+    }
+    EXPECT_EQ(1, tuner.cache().size());
+}
+#endif
@@ -0,0 +1,115 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gtest/gtest.h>
+
+#include <gridtools/stencil_composition/stencil_composition.hpp>
+#include <gridtools/storage/storage_facility.hpp>
+#include <gridtools/tools/backend_select.hpp>
+#include <gridtools/tools/verifier.hpp>
+
+using namespace gridtools;
+
+namespace {
+    using kfull = axis<1>::full_interval;
+
+    struct smooth_functor {
+        using in = accessor<0, intent::in, extent<-1, 1, -1, 1>>;
+        using out = accessor<1, intent::inout>;
+        using param_list = make_param_list<in, out>;
+
+        template <typename Evaluation>
+        GT_FUNCTION static void apply(Evaluation &eval) {
+            eval(out()) = eval(in(-1, 0, 0)) + eval(in(1, 0, 0)) + eval(in(0, -1, 0)) + eval(in(0, 1, 0));
+        }
+    };
+
+    struct accumulate_functor {
+        using in = accessor<0>;
+        using out = accessor<1, intent::inout, extent<0, 0, 0, 0, -1, 0>>;
+        using param_list = make_param_list<in, out>;
+
+        template <typename Evaluation>
+        GT_FUNCTION static void apply(Evaluation &eval, kfull::first_level) {
+            eval(out()) += eval(in());
+        }
+
+        template <typename Evaluation>
+        GT_FUNCTION static void apply(Evaluation &eval, kfull::modify<1, 0>) {
+            eval(out()) += eval(out(0, 0, -1)) + eval(in());
+        }
+    };
+
+    using storage_info_t = storage_traits<backend_t>::storage_info_t<0, 3, halo<1, 1, 0>>;
+    using storage_t = storage_traits<backend_t>::data_store_t<float_type, storage_info_t>;
+
+    using p_in = arg<0, storage_t>;
+    using p_out = arg<1, storage_t>;
+    using p_tmp = tmp_arg<2, storage_t>;
+
+    class execution_plan_test : public ::testing::Test {
+      protected:
+        static constexpr uint_t d1 = 9, d2 = 14, d3 = 5;
+
+        storage_info_t m_info{d1 + 2, d2 + 2, d3};
+        storage_t m_in{m_info, [](int i, int j, int k) { return i + 10 * j + 100 * k; }};
+        halo_descriptor m_di{1, 1, 1, d1, d1 + 2};
+        halo_descriptor m_dj{1, 1, 1, d2, d2 + 2};
+
+        bool verify(storage_t const &expected, storage_t const &actual) {
+            expected.sync();
+            actual.sync();
+            verifier verif(1e-10);
+            array<array<uint_t, 2>, 3> halos{{{1, 1}, {1, 1}, {0, 0}}};
+            return verif.verify(make_grid(m_di, m_dj, d3), expected, actual, halos);
+        }
+
+        template <class... Args>
+        auto make_comp(Args const &... args) {
+            return make_computation<backend_t>(make_grid(m_di, m_dj, d3),
+                args...,
+                make_multistage(execute::forward(),
+                    make_stage<smooth_functor>(p_in(), p_tmp()),
+                    make_stage<accumulate_functor>(p_tmp(), p_out())));
+        }
+    };
+} // namespace
+
+TEST_F(execution_plan_test, same_as_run) {
+    storage_t expected{m_info, 0}, actual{m_info, 0};
+
+    auto comp = make_comp(p_in() = m_in);
+    for (int step = 0; step < 3; ++step)
+        comp.run(p_out() = expected);
+
+    auto plan = comp.make_plan(p_out() = actual);
+    for (int step = 0; step < 3; ++step)
+        plan.run();
+
+    EXPECT_TRUE(verify(expected, actual));
+}
+
+TEST_F(execution_plan_test, plans_are_independent) {
+    storage_t expected{m_info, 0}, first{m_info, 0}, second{m_info, 0};
+
+    auto comp = make_comp(p_in() = m_in);
+    comp.run(p_out() = expected);
+    comp.run(p_out() = expected);
+
+    auto first_plan = comp.make_plan(p_out() = first);
+    auto second_plan = comp.make_plan(p_out() = second);
+    first_plan.run();
+    second_plan.run();
+    first_plan.run();
+    second_plan.run();
+
+    EXPECT_TRUE(verify(expected, first));
+    EXPECT_TRUE(verify(expected, second));
+}
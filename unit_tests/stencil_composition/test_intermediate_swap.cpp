@@ -0,0 +1,167 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/stencil_composition/stencil_composition.hpp>
+#include <gridtools/storage/storage_facility.hpp>
+#include <gridtools/tools/backend_select.hpp>
+#include <gridtools/tools/verifier.hpp>
+
+using namespace gridtools;
+
+namespace {
+    struct smooth_functor {
+        using in = accessor<0, intent::in, extent<-1, 1, -1, 1>>;
+        using out = accessor<1, intent::inout>;
+        using param_list = make_param_list<in, out>;
+
+        template <typename Evaluation>
+        GT_FUNCTION static void apply(Evaluation &eval) {
+            eval(out()) = (eval(in()) + eval(in(-1, 0, 0)) + eval(in(1, 0, 0)) + eval(in(0, -1, 0)) +
+                              eval(in(0, 1, 0))) /
+                          5;
+        }
+    };
+
+    struct increment_functor {
+        using in = accessor<0>;
+        using out = accessor<1, intent::inout>;
+        using param_list = make_param_list<in, out>;
+
+        template <typename Evaluation>
+        GT_FUNCTION static void apply(Evaluation &eval) {
+            eval(out()) = eval(in()) + 1;
+        }
+    };
+
+    using storage_info_t = storage_traits<backend_t>::storage_info_t<0, 3, halo<1, 1, 0>>;
+    using storage_t = storage_traits<backend_t>::data_store_t<float_type, storage_info_t>;
+
+    using p_in = arg<0, storage_t>;
+    using p_out = arg<1, storage_t>;
+    using p_mid = arg<2, storage_t>;
+    using p_tmp = tmp_arg<3, storage_t>;
+
+    class intermediate_swap : public ::testing::Test {
+      protected:
+        static constexpr uint_t d1 = 11, d2 = 9, d3 = 4;
+
+        storage_info_t m_info{d1 + 2, d2 + 2, d3};
+        halo_descriptor m_di{1, 1, 1, d1, d1 + 2};
+        halo_descriptor m_dj{1, 1, 1, d2, d2 + 2};
+
+        storage_t make_storage() const {
+            return {m_info, [](int i, int j, int k) { return (i * 7 + j * 13 + k * 5) % 17; }};
+        }
+
+        bool verify(storage_t const &expected, storage_t const &actual) {
+            expected.sync();
+            actual.sync();
+            verifier verif(1e-10);
+            array<array<uint_t, 2>, 3> halos{{{1, 1}, {1, 1}, {0, 0}}};
+            return verif.verify(make_grid(m_di, m_dj, d3), expected, actual, halos);
+        }
+
+        // runs the computation step by step with the data stores passed to run and swapped explicitly
+        template <class Comp>
+        std::pair<storage_t, storage_t> reference(Comp &comp, int steps) {
+            storage_t in = make_storage(), out = make_storage();
+            for (int step = 0; step < steps; ++step) {
+                comp.run(p_in() = in, p_out() = out);
+                std::swap(in, out);
+            }
+            return {in, out};
+        }
+
+        template <class... Msses>
+        void test(Msses... msses) {
+            auto free_comp = make_computation<backend_t>(make_grid(m_di, m_dj, d3), msses...);
+            for (int steps : {1, 2, 5}) {
+                auto expected = reference(free_comp, steps);
+
+                storage_t in = make_storage(), out = make_storage();
+                auto comp =
+                    make_computation<backend_t>(make_grid(m_di, m_dj, d3), p_in() = in, p_out() = out, msses...);
+                for (int step = 0; step < steps; ++step) {
+                    comp.run();
+                    comp.swap(p_in(), p_out());
+                }
+                if (steps % 2)
+                    std::swap(in, out);
+                EXPECT_TRUE(verify(expected.first, in)) << "steps: " << steps;
+                EXPECT_TRUE(verify(expected.second, out)) << "steps: " << steps;
+            }
+        }
+    };
+
+    TEST_F(intermediate_swap, smooth) {
+        test(make_multistage(execute::parallel(), make_stage<smooth_functor>(p_in(), p_out())));
+    }
+
+    TEST_F(intermediate_swap, with_temporary) {
+        test(make_multistage(execute::forward(),
+            make_stage<smooth_functor>(p_in(), p_tmp()),
+            make_stage<increment_functor>(p_tmp(), p_out())));
+    }
+
+    TEST_F(intermediate_swap, separate_msses) {
+        // each local domain uses only one of the swapped placeholders
+        storage_t mid = make_storage();
+        test(p_mid() = mid,
+            make_multistage(execute::parallel(), make_stage<smooth_functor>(p_in(), p_mid())),
+            make_multistage(execute::parallel(), make_stage<increment_functor>(p_mid(), p_out())));
+    }
+
+    TEST_F(intermediate_swap, run_steps_keeps_bindings) {
+        storage_t expected_in = make_storage(), expected_out = make_storage();
+        auto mss = make_multistage(execute::parallel(), make_stage<smooth_functor>(p_in(), p_out()));
+        auto free_comp = make_computation<backend_t>(make_grid(m_di, m_dj, d3), mss);
+        for (int step = 0; step < 3; ++step) {
+            free_comp.run(p_in() = expected_in, p_out() = expected_out);
+            std::swap(expected_in, expected_out);
+        }
+        free_comp.run(p_in() = expected_in, p_out() = expected_out);
+
+        storage_t in = make_storage(), out = make_storage();
+        auto comp = make_computation<backend_t>(make_grid(m_di, m_dj, d3), p_in() = in, p_out() = out, mss);
+        comp.run_steps(3, make_swap_spec(p_in(), p_out()));
+        comp.swap(p_in(), p_out());
+        comp.run();
+
+        EXPECT_TRUE(verify(expected_in, out));
+        EXPECT_TRUE(verify(expected_out, in));
+    }
+
+    TEST_F(intermediate_swap, run_syncs_bound_data_stores) {
+        storage_t in = make_storage(), out = make_storage();
+        auto comp = make_computation<backend_t>(make_grid(m_di, m_dj, d3),
+            p_in() = in,
+            p_out() = out,
+            make_multistage(execute::parallel(), make_stage<increment_functor>(p_in(), p_out())));
+        comp.run();
+
+        // modify the bound data stores on the host between the runs
+        out.sync();
+        {
+            auto view = make_host_view(in);
+            for (int i = 0; i < d1 + 2; ++i)
+                for (int j = 0; j < d2 + 2; ++j)
+                    for (int k = 0; k < d3; ++k)
+                        view(i, j, k) = i + j + k;
+        }
+        comp.run();
+
+        storage_t expected{m_info, [](int i, int j, int k) { return i + j + k + 1; }};
+        EXPECT_TRUE(verify(expected, out));
+    }
+} // namespace
@@ -0,0 +1,144 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/stencil_composition/stencil_composition.hpp>
+#include <gridtools/storage/storage_facility.hpp>
+#include <gridtools/tools/backend_select.hpp>
+#include <gridtools/tools/verifier.hpp>
+
+using namespace gridtools;
+
+#ifdef GT_BACKEND_NAIVE
+namespace {
+    using kfull = axis<1>::full_interval;
+
+    using storage_info_t = storage_traits<backend_t>::storage_info_t<0, 3, halo<1, 1, 0>>;
+    using storage_t = storage_traits<backend_t>::data_store_t<float_type, storage_info_t>;
+
+    using p_in = arg<0, storage_t>;
+    using p_out = arg<1, storage_t>;
+    using p_out2 = arg<2, storage_t>;
+    using p_tmp = tmp_arg<3, storage_t>;
+    using p_tmp2 = tmp_arg<4, storage_t>;
+
+    // accumulation in k, run on the extended area of the following stage
+    struct forward_sum {
+        using in = accessor<0>;
+        using out = accessor<1, intent::inout, extent<0, 0, 0, 0, -1, 0>>;
+        using param_list = make_param_list<in, out>;
+
+        template <typename Evaluation>
+        GT_FUNCTION static void apply(Evaluation &eval, kfull::first_level) {
+            eval(out()) = eval(in());
+        }
+
+        template <typename Evaluation>
+        GT_FUNCTION static void apply(Evaluation &eval, kfull::modify<1, 0>) {
+            eval(out()) = eval(out(0, 0, -1)) + eval(in());
+        }
+    };
+
+    struct backward_sum {
+        using in = accessor<0>;
+        using out = accessor<1, intent::inout, extent<0, 0, 0, 0, 0, 1>>;
+        using param_list = make_param_list<in, out>;
+
+        template <typename Evaluation>
+        GT_FUNCTION static void apply(Evaluation &eval, kfull::last_level) {
+            eval(out()) = eval(in());
+        }
+
+        template <typename Evaluation>
+        GT_FUNCTION static void apply(Evaluation &eval, kfull::modify<0, -1>) {
+            eval(out()) = eval(out(0, 0, 1)) + eval(in());
+        }
+    };
+
+    struct neighbours {
+        using in = accessor<0, intent::in, extent<-1, 1, -1, 1>>;
+        using out = accessor<1, intent::inout>;
+        using param_list = make_param_list<in, out>;
+
+        template <typename Evaluation>
+        GT_FUNCTION static void apply(Evaluation &eval) {
+            eval(out()) = eval(in(-1, 0, 0)) + 2 * eval(in(1, 0, 0)) + 3 * eval(in(0, -1, 0)) + 4 * eval(in(0, 1, 0));
+        }
+    };
+
+    struct combine {
+        using in = accessor<0, intent::in, extent<0, 1, -1, 0>>;
+        using other = accessor<1>;
+        using out = accessor<2, intent::inout>;
+        using param_list = make_param_list<in, other, out>;
+
+        template <typename Evaluation>
+        GT_FUNCTION static void apply(Evaluation &eval) {
+            eval(out()) = eval(other()) + eval(in(1, 0, 0)) - 2 * eval(in(0, -1, 0));
+        }
+    };
+} // namespace
+
+// the columns are distributed among the threads, the stages with k-dependencies on the extended area of the next
+// stage and a backward multistage reading the output of a forward one are compared to a serial computation
+TEST(naive_columns, forward_backward) {
+    const int d1 = 17, d2 = 13, d3 = 9;
+    storage_info_t info(d1 + 2, d2 + 2, d3);
+    storage_t in(info, [](int i, int j, int k) { return (i * 7 + j * 3 + k * 5) % 11 + 1; });
+    storage_t out(info, 0), out2(info, 0), ref(info, 0), ref2(info, 0);
+
+    const int size = (d1 + 2) * (d2 + 2) * d3;
+    std::vector<float_type> fwd(size), bwd(size);
+    auto at = [&](std::vector<float_type> &v, int i, int j, int k) -> float_type & {
+        return v[(k * (d2 + 2) + j) * (d1 + 2) + i];
+    };
+    auto inv = make_host_view(in);
+    for (int i = 0; i < d1 + 2; ++i)
+        for (int j = 0; j < d2 + 2; ++j) {
+            for (int k = 0; k < d3; ++k)
+                at(fwd, i, j, k) = (k ? at(fwd, i, j, k - 1) : 0) + inv(i, j, k);
+            for (int k = d3 - 1; k >= 0; --k)
+                at(bwd, i, j, k) = (k < d3 - 1 ? at(bwd, i, j, k + 1) : 0) + inv(i, j, k);
+        }
+    auto refv = make_host_view(ref);
+    auto ref2v = make_host_view(ref2);
+    for (int i = 1; i <= d1; ++i)
+        for (int j = 1; j <= d2; ++j)
+            for (int k = 0; k < d3; ++k) {
+                refv(i, j, k) = at(fwd, i - 1, j, k) + 2 * at(fwd, i + 1, j, k) + 3 * at(fwd, i, j - 1, k) +
+                                4 * at(fwd, i, j + 1, k);
+                ref2v(i, j, k) = refv(i, j, k) + at(bwd, i + 1, j, k) - 2 * at(bwd, i, j - 1, k);
+            }
+
+    halo_descriptor di{1, 1, 1, d1, d1 + 2};
+    halo_descriptor dj{1, 1, 1, d2, d2 + 2};
+    auto comp = make_computation<backend_t>(make_grid(di, dj, d3),
+        p_in() = in,
+        p_out() = out,
+        p_out2() = out2,
+        make_multistage(execute::forward(),
+            make_stage<forward_sum>(p_in(), p_tmp()),
+            make_stage<neighbours>(p_tmp(), p_out())),
+        make_multistage(execute::backward(),
+            make_stage<backward_sum>(p_in(), p_tmp2()),
+            make_stage<combine>(p_tmp2(), p_out(), p_out2())));
+    comp.run();
+
+    out.sync();
+    out2.sync();
+    verifier verif(1e-10);
+    array<array<uint_t, 2>, 3> halos{{{1, 1}, {1, 1}, {0, 0}}};
+    EXPECT_TRUE(verif.verify(make_grid(di, dj, d3), ref, out, halos));
+    EXPECT_TRUE(verif.verify(make_grid(di, dj, d3), ref2, out2, halos));
+}
+#endif
@@ -0,0 +1,114 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/stencil_composition/stencil_composition.hpp>
+#include <gridtools/storage/storage_facility.hpp>
+#include <gridtools/tools/backend_select.hpp>
+#include <gridtools/tools/verifier.hpp>
+
+using namespace gridtools;
+
+namespace {
+    struct smooth_functor {
+        using in = accessor<0, intent::in, extent<-1, 1, -1, 1>>;
+        using out = accessor<1, intent::inout>;
+        using param_list = make_param_list<in, out>;
+
+        template <typename Evaluation>
+        GT_FUNCTION static void apply(Evaluation &eval) {
+            eval(out()) = (eval(in()) + eval(in(-1, 0, 0)) + eval(in(1, 0, 0)) + eval(in(0, -1, 0)) +
+                              eval(in(0, 1, 0))) /
+                          5;
+        }
+    };
+
+    struct shift_functor {
+        using in = accessor<0, intent::in, extent<0, 0, 0, 1>>;
+        using out = accessor<1, intent::inout>;
+        using param_list = make_param_list<in, out>;
+
+        template <typename Evaluation>
+        GT_FUNCTION static void apply(Evaluation &eval) {
+            eval(out()) = eval(in(0, 1, 0)) + 1;
+        }
+    };
+
+    using storage_info_t = storage_traits<backend_t>::storage_info_t<0, 3, halo<3, 3, 0>>;
+    using storage_t = storage_traits<backend_t>::data_store_t<float_type, storage_info_t>;
+
+    using p_in = arg<0, storage_t>;
+    using p_out = arg<1, storage_t>;
+    using p_tmp = tmp_arg<2, storage_t>;
+
+    class run_steps : public ::testing::Test {
+      protected:
+        static constexpr uint_t d1 = 11, d2 = 23, d3 = 4, h = 3;
+
+        storage_info_t m_info{d1 + 2 * h, d2 + 2 * h, d3};
+        halo_descriptor m_di{h, h, h, d1 + h - 1, d1 + 2 * h};
+        halo_descriptor m_dj{h, h, h, d2 + h - 1, d2 + 2 * h};
+
+        storage_t make_storage() const {
+            return {m_info, [](int i, int j, int k) { return (i * 7 + j * 13 + k * 5) % 17; }};
+        }
+
+        // runs the computation step by step with explicit swapping
+        template <class Comp>
+        std::pair<storage_t, storage_t> reference(Comp &comp, int_t steps) {
+            storage_t in = make_storage(), out = make_storage();
+            for (int_t step = 0; step < steps; ++step) {
+                comp.run(p_in() = in, p_out() = out);
+                std::swap(in, out);
+            }
+            return {in, out};
+        }
+
+        bool verify(storage_t const &expected, storage_t const &actual) {
+            expected.sync();
+            actual.sync();
+            verifier verif(1e-10);
+            array<array<uint_t, 2>, 3> halos{{{h, h}, {h, h}, {0, 0}}};
+            return verif.verify(make_grid(m_di, m_dj, d3), expected, actual, halos);
+        }
+
+        template <class... Msses>
+        void test(Msses... msses) {
+            auto comp = make_computation<backend_t>(make_grid(m_di, m_dj, d3), msses...);
+            for (int_t steps : {0, 1, 2, 5})
+                for (int_t tile : {0, 1, 3, 40}) {
+                    auto expected = reference(comp, steps);
+                    storage_t in = make_storage(), out = make_storage();
+                    comp.run_steps(steps, make_swap_spec(p_in(), p_out()).tile_size(tile), p_in() = in, p_out() = out);
+                    if (steps % 2)
+                        std::swap(in, out);
+                    EXPECT_TRUE(verify(expected.first, in)) << "steps: " << steps << ", tile: " << tile;
+                    EXPECT_TRUE(verify(expected.second, out)) << "steps: " << steps << ", tile: " << tile;
+                }
+        }
+    };
+
+    TEST_F(run_steps, smooth) {
+        test(make_multistage(execute::parallel(), make_stage<smooth_functor>(p_in(), p_out())));
+    }
+
+    TEST_F(run_steps, with_temporary) {
+        test(make_multistage(execute::forward(),
+            make_stage<smooth_functor>(p_in(), p_tmp()),
+            make_stage<smooth_functor>(p_tmp(), p_out())));
+    }
+
+    TEST_F(run_steps, asymmetric_extent) {
+        test(make_multistage(execute::parallel(), make_stage<shift_functor>(p_in(), p_out())));
+    }
+} // namespace
@@ -0,0 +1,175 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <type_traits>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/common/simd_pack.hpp>
+#include <gridtools/stencil_composition/stencil_composition.hpp>
+#include <gridtools/storage/storage_facility.hpp>
+#include <gridtools/tools/backend_select.hpp>
+
+using namespace gridtools;
+
+namespace {
+    // the functors are evaluated on SIMD packs by the mc backend and on scalars by the other backends
+
+    struct lap_functor {
+        using simd = std::true_type;
+
+        using in = accessor<0, intent::in, extent<-1, 1, -1, 1>>;
+        using out = accessor<1, intent::inout>;
+        using param_list = make_param_list<in, out>;
+
+        template <typename Evaluation>
+        GT_FUNCTION static void apply(Evaluation &eval) {
+            eval(out()) = 4 * eval(in()) - (eval(in(1, 0, 0)) + eval(in(-1, 0, 0)) + eval(in(0, 1, 0)) +
+                                               eval(in(0, -1, 0)));
+        }
+    };
+
+    struct flx_functor {
+        using simd = std::true_type;
+
+        using in = accessor<0, intent::in, extent<0, 1, 0, 0>>;
+        using lap = accessor<1, intent::in, extent<0, 1, 0, 0>>;
+        using out = accessor<2, intent::inout>;
+        using param_list = make_param_list<in, lap, out>;
+
+        template <typename Evaluation>
+        GT_FUNCTION static void apply(Evaluation &eval) {
+            auto res = eval(lap(1, 0, 0)) - eval(lap());
+            eval(out()) = select(res * (eval(in(1, 0, 0)) - eval(in())) > 0, 0., res);
+        }
+    };
+
+    struct out_functor {
+        using simd = std::true_type;
+
+        using in = accessor<0, intent::in>;
+        using flx = accessor<1, intent::in, extent<-1, 0, 0, 0>>;
+        using coeff = global_accessor<2>;
+        using out = accessor<3, intent::inout>;
+        using param_list = make_param_list<in, flx, coeff, out>;
+
+        template <typename Evaluation>
+        GT_FUNCTION static void apply(Evaluation &eval) {
+            eval(out()) = eval(in()) - eval(coeff()) * (eval(flx()) - eval(flx(-1, 0, 0)));
+        }
+    };
+
+    struct positional_functor {
+        using simd = std::true_type;
+
+        using in = accessor<0, intent::inout>;
+        using out = accessor<1, intent::inout>;
+        using param_list = make_param_list<in, out>;
+
+        template <typename Evaluation>
+        GT_FUNCTION static void apply(Evaluation &eval) {
+            eval(out()) += eval.i() + 100 * eval.j() + math::max(eval(in()), eval(out()) - 1);
+        }
+    };
+
+    struct copy_functor {
+        using in = accessor<0, intent::in>;
+        using out = accessor<1, intent::inout>;
+        using param_list = make_param_list<in, out>;
+
+        template <typename Evaluation>
+        GT_FUNCTION static void apply(Evaluation &eval) {
+            eval(out()) = eval(in());
+        }
+    };
+
+    using storage_info_t = storage_traits<backend_t>::storage_info_t<0, 3, halo<2, 2, 0>>;
+    using storage_t = storage_traits<backend_t>::data_store_t<double, storage_info_t>;
+
+    double input(int i, int j, int k) { return (i * 7 + j * 13 + k * 5) % 17 + .5 * (i % 3); }
+
+    class simd_mc : public ::testing::TestWithParam<int> {
+      protected:
+        static constexpr int d2 = 5, d3 = 3;
+        const int d1 = GetParam();
+
+        storage_info_t m_info{d1 + 4, d2 + 4, d3};
+        storage_t m_in{m_info, input};
+        storage_t m_out{m_info, -1.};
+
+        grid<axis<1>::axis_interval_t> make_test_grid() const {
+            return make_grid(halo_descriptor(2, 2, 2, d1 + 1, d1 + 4), halo_descriptor(2, 2, 2, d2 + 1, d2 + 4), d3);
+        }
+    };
+
+    TEST_P(simd_mc, diffusion) {
+        const double coeff = .025;
+
+        arg<0, storage_t> p_in;
+        arg<1, storage_t> p_out;
+        arg<2, decltype(make_global_parameter<backend_t>(coeff))> p_coeff;
+        tmp_arg<3, storage_t> p_lap;
+        tmp_arg<4, storage_t> p_flx;
+
+        make_computation<backend_t>(make_test_grid(),
+            p_in = m_in,
+            p_out = m_out,
+            p_coeff = make_global_parameter<backend_t>(coeff),
+            make_multistage(execute::parallel(),
+                define_caches(cache<cache_type::ij, cache_io_policy::local>(p_lap, p_flx)),
+                make_stage<lap_functor>(p_in, p_lap),
+                make_stage<flx_functor>(p_in, p_lap, p_flx),
+                make_stage<out_functor>(p_in, p_flx, p_coeff, p_out)))
+            .run();
+
+        auto lap = [](int i, int j, int k) {
+            return 4 * input(i, j, k) -
+                   (input(i + 1, j, k) + input(i - 1, j, k) + input(i, j + 1, k) + input(i, j - 1, k));
+        };
+        auto flx = [&](int i, int j, int k) {
+            double res = lap(i + 1, j, k) - lap(i, j, k);
+            return res * (input(i + 1, j, k) - input(i, j, k)) > 0 ? 0 : res;
+        };
+        m_out.sync();
+        auto view = make_host_view(m_out);
+        for (int i = 0; i < d1 + 4; ++i)
+            for (int j = 0; j < d2 + 4; ++j)
+                for (int k = 0; k < d3; ++k) {
+                    bool inner = i > 1 && i <= d1 + 1 && j > 1 && j <= d2 + 1;
+                    double expected = inner ? input(i, j, k) - coeff * (flx(i, j, k) - flx(i - 1, j, k)) : -1;
+                    EXPECT_DOUBLE_EQ(expected, view(i, j, k)) << "i=" << i << " j=" << j << " k=" << k;
+                }
+    }
+
+    TEST_P(simd_mc, positional_and_mixed) {
+        arg<0, storage_t> p_in;
+        arg<1, storage_t> p_out;
+
+        make_positional_computation<backend_t>(make_test_grid(),
+            p_in = m_in,
+            p_out = m_out,
+            make_multistage(execute::forward(),
+                make_stage<copy_functor>(p_in, p_out),
+                make_stage<positional_functor>(p_in, p_out)))
+            .run();
+
+        m_out.sync();
+        auto view = make_host_view(m_out);
+        for (int i = 0; i < d1 + 4; ++i)
+            for (int j = 0; j < d2 + 4; ++j)
+                for (int k = 0; k < d3; ++k) {
+                    bool inner = i > 1 && i <= d1 + 1 && j > 1 && j <= d2 + 1;
+                    double expected = inner ? 2 * input(i, j, k) + i + 100 * j : -1;
+                    EXPECT_DOUBLE_EQ(expected, view(i, j, k)) << "i=" << i << " j=" << j << " k=" << k;
+                }
+    }
+
+    INSTANTIATE_TEST_CASE_P(i_sizes, simd_mc, ::testing::Values(1, 7, 8, 13, 16, 35));
+} // namespace
@@ -0,0 +1,203 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#define GT_ENABLE_STAGE_METERS
+
+#include <gridtools/stencil_composition/stage_meters.hpp>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/stencil_composition/stencil_composition.hpp>
+#include <gridtools/storage/storage_facility.hpp>
+#include <gridtools/tools/backend_select.hpp>
+
+using namespace gridtools;
+
+namespace {
+    struct scale_functor {
+        using in = accessor<0, intent::in>;
+        using coeff = global_accessor<1>;
+        using out = accessor<2, intent::inout>;
+        using param_list = make_param_list<in, coeff, out>;
+
+        template <typename Evaluation>
+        GT_FUNCTION static void apply(Evaluation &eval) {
+            eval(out()) = eval(coeff()) * eval(in());
+        }
+    };
+
+    struct lap_functor {
+        using in = accessor<0, intent::in, extent<-1, 1, -1, 1>>;
+        using out = accessor<1, intent::inout>;
+        using param_list = make_param_list<in, out>;
+
+        template <typename Evaluation>
+        GT_FUNCTION static void apply(Evaluation &eval) {
+            eval(out()) = 4 * eval(in()) - (eval(in(1, 0, 0)) + eval(in(-1, 0, 0)) + eval(in(0, 1, 0)) +
+                                               eval(in(0, -1, 0)));
+        }
+    };
+
+    struct copy_functor {
+        using in = accessor<0, intent::in>;
+        using out = accessor<1, intent::inout>;
+        using param_list = make_param_list<in, out>;
+
+        template <typename Evaluation>
+        GT_FUNCTION static void apply(Evaluation &eval) {
+            eval(out()) = eval(in());
+        }
+    };
+
+    using storage_info_t = storage_traits<backend_t>::storage_info_t<0, 3, halo<1, 1, 0>>;
+    using storage_t = storage_traits<backend_t>::data_store_t<double, storage_info_t>;
+
+    stage_record find(std::string const &name) {
+        for (auto const &record : stage_meters::instance().records())
+            if (record.name.find(name) != std::string::npos)
+                return record;
+        return {};
+    }
+
+    class stage_meters_test : public ::testing::Test {
+      protected:
+        static constexpr int d1 = 13, d2 = 9, d3 = 6;
+
+        storage_info_t m_info{d1 + 2, d2 + 2, d3};
+        storage_t m_in{m_info, [](int i, int j, int k) { return i + 10 * j + 100 * k; }};
+        storage_t m_tmp{m_info, 0.};
+        storage_t m_out{m_info, 0.};
+
+        stage_meters_test() { stage_meters::instance().reset(); }
+
+        template <class Execution>
+        void run(Execution execution) {
+            arg<0, storage_t> p_in;
+            arg<1, storage_t> p_tmp;
+            arg<2, storage_t> p_out;
+            arg<3, decltype(make_global_parameter<backend_t>(2.))> p_coeff;
+
+            make_computation<backend_t>(
+                make_grid(halo_descriptor(1, 1, 1, d1, d1 + 2), halo_descriptor(1, 1, 1, d2, d2 + 2), d3),
+                p_in = m_in,
+                p_tmp = m_tmp,
+                p_out = m_out,
+                p_coeff = make_global_parameter<backend_t>(2.),
+                make_multistage(execution,
+                    make_stage<scale_functor>(p_in, p_coeff, p_tmp),
+                    make_stage<lap_functor>(p_tmp, p_out)))
+                .run();
+        }
+    };
+
+    constexpr int stage_meters_test::d1;
+    constexpr int stage_meters_test::d2;
+    constexpr int stage_meters_test::d3;
+
+#if defined(GT_BACKEND_MC) || defined(GT_BACKEND_NAIVE)
+    void check_counter(long long value) { EXPECT_TRUE(value == -1 || value >= 0); }
+
+    void check_records(int d1, int d2, int d3) {
+        auto scale = find("scale_functor");
+        auto lap = find("lap_functor");
+        const std::size_t points = d1 * d2 * d3;
+
+        EXPECT_GT(scale.executions, 0);
+        EXPECT_GT(lap.executions, 0);
+
+        // the scale stage is computed on the halo points required by the laplacian, redundantly in every block
+        EXPECT_GE(scale.points, (d1 + 2) * (d2 + 2) * d3);
+        EXPECT_EQ(points, lap.points);
+
+        // one read and one read/write access per point, the global parameter does not count
+        EXPECT_NEAR(3 * sizeof(double) * scale.points, scale.bytes, 8 * scale.executions);
+        // the input is read with its halo, at least once per point
+        EXPECT_GE(lap.bytes + 8 * lap.executions, 3 * sizeof(double) * points);
+
+        EXPECT_GE(scale.time, 0);
+        for (auto &&record : {scale, lap}) {
+            check_counter(record.cycles);
+            check_counter(record.instructions);
+            check_counter(record.llc_misses);
+            check_counter(record.flops);
+        }
+    }
+
+    TEST_F(stage_meters_test, forward) {
+        run(execute::forward());
+        check_records(d1, d2, d3);
+    }
+
+    TEST_F(stage_meters_test, parallel) {
+        run(execute::parallel());
+        check_records(d1, d2, d3);
+    }
+
+    TEST_F(stage_meters_test, accumulate_and_reset) {
+        run(execute::forward());
+        auto first = find("lap_functor");
+        run(execute::forward());
+        auto second = find("lap_functor");
+        EXPECT_EQ(2 * first.executions, second.executions);
+        EXPECT_EQ(2 * first.points, second.points);
+
+        stage_meters::instance().reset();
+        EXPECT_TRUE(stage_meters::instance().records().empty());
+    }
+
+    TEST_F(stage_meters_test, json) {
+        run(execute::forward());
+        auto json = stage_meters::instance().to_json();
+        EXPECT_EQ('[', json.front());
+        EXPECT_EQ(']', json.back());
+        EXPECT_NE(std::string::npos, json.find("scale_functor"));
+        EXPECT_NE(std::string::npos, json.find("lap_functor"));
+        EXPECT_NE(std::string::npos, json.find("\"bytes\": "));
+    }
+
+#ifdef GT_BACKEND_MC
+    TEST_F(stage_meters_test, k_cached) {
+        // the stages are run row by row, they are recorded once per block
+        arg<0, storage_t> p_in;
+        tmp_arg<1, storage_t> p_tmp;
+        arg<2, storage_t> p_out;
+        arg<3, decltype(make_global_parameter<backend_t>(2.))> p_coeff;
+
+        auto grid = make_grid(halo_descriptor(1, 1, 1, d1, d1 + 2), halo_descriptor(1, 1, 1, d2, d2 + 2), d3);
+        make_computation<backend_t>(grid,
+            p_in = m_in,
+            p_out = m_out,
+            p_coeff = make_global_parameter<backend_t>(2.),
+            make_multistage(execute::forward(),
+                define_caches(cache<cache_type::k, cache_io_policy::local>(p_tmp)),
+                make_stage<scale_functor>(p_in, p_coeff, p_tmp),
+                make_stage<copy_functor>(p_tmp, p_out)))
+            .run();
+
+        execinfo_mc exinfo(grid);
+        const std::size_t blocks = exinfo.i_blocks() * exinfo.j_blocks();
+        const std::size_t points = d1 * d2 * d3;
+        for (auto &&record : {find("scale_functor"), find("copy_functor")}) {
+            EXPECT_EQ(blocks, record.executions);
+            EXPECT_EQ(points, record.points);
+            EXPECT_GE(record.time, 0);
+            check_counter(record.cycles);
+            check_counter(record.instructions);
+        }
+    }
+#endif
+#else
+    TEST_F(stage_meters_test, not_instrumented) {
+        run(execute::forward());
+        EXPECT_TRUE(stage_meters::instance().records().empty());
+        EXPECT_EQ("[]", stage_meters::instance().to_json());
+    }
+#endif
+} // namespace
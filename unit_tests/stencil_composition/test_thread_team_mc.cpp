@@ -0,0 +1,184 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <atomic>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/stencil_composition/backend_mc/thread_team_mc.hpp>
+#include <gridtools/stencil_composition/stencil_composition.hpp>
+#include <gridtools/storage/storage_facility.hpp>
+#include <gridtools/tools/backend_select.hpp>
+#include <gridtools/tools/verifier.hpp>
+
+using namespace gridtools;
+
+TEST(thread_team_mc, all_tasks_are_run_once) {
+    const int_t n = 1000;
+    std::unique_ptr<std::atomic<int>[]> counts(new std::atomic<int>[n]);
+    for (int_t i = 0; i < n; ++i)
+        counts[i] = 0;
+
+    thread_team_mc team;
+    EXPECT_EQ(omp_get_max_threads(), team.size());
+    for (int run = 0; run < 100; ++run)
+        team.run(n, [&](int_t task) { ++counts[task]; });
+
+    for (int_t i = 0; i < n; ++i)
+        EXPECT_EQ(100, counts[i]);
+}
+
+TEST(thread_team_mc, static_distribution) {
+    thread_team_mc team;
+    const int_t size = team.size();
+    const int_t n = 3 * size + 1;
+    std::vector<int_t> members(n, -1);
+    std::vector<std::thread::id> ids(n);
+    team.run(n, [&](int_t task) {
+        members[task] = thread_index_mc();
+        ids[task] = std::this_thread::get_id();
+    });
+
+    // contiguous ranges, the first member gets the extra task and runs on the calling thread
+    EXPECT_EQ(0, members[0]);
+    EXPECT_EQ(0, members[3]);
+    EXPECT_EQ(std::this_thread::get_id(), ids[0]);
+    for (int_t task = 1; task < n; ++task)
+        EXPECT_LE(members[task - 1], members[task]);
+    EXPECT_EQ(size - 1, members[n - 1]);
+    EXPECT_EQ((std::size_t)size, std::set<std::thread::id>(ids.begin(), ids.end()).size());
+    EXPECT_EQ(omp_get_thread_num(), thread_index_mc());
+}
+
+TEST(thread_team_mc, sleeping_members_are_woken_up) {
+    thread_team_mc team(0);
+    std::atomic<int> count{0};
+    for (int run = 0; run < 10; ++run) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        team.run(team.size(), [&](int_t) { ++count; });
+    }
+    EXPECT_EQ(10 * team.size(), count);
+}
+
+#ifdef GT_BACKEND_MC
+namespace {
+    using kfull = axis<1>::full_interval;
+
+    using storage_info_t = storage_traits<backend_t>::storage_info_t<0, 3, halo<1, 1, 0>>;
+    using storage_t = storage_traits<backend_t>::data_store_t<float_type, storage_info_t>;
+
+    using p_in = arg<0, storage_t>;
+    using p_out = arg<1, storage_t>;
+    using p_tmp = tmp_arg<2, storage_t>;
+
+    struct neighbours_functor {
+        using in = accessor<0, intent::in, extent<-1, 1, -1, 1>>;
+        using out = accessor<1, intent::inout>;
+        using param_list = make_param_list<in, out>;
+
+        template <typename Evaluation>
+        GT_FUNCTION static void apply(Evaluation &eval) {
+            eval(out()) = eval(in(-1, 0, 0)) + eval(in(1, 0, 0)) + eval(in(0, -1, 0)) + eval(in(0, 1, 0));
+        }
+    };
+
+    struct sum_functor {
+        using in = accessor<0>;
+        using out = accessor<1, intent::inout, extent<0, 0, 0, 0, -1, 0>>;
+        using param_list = make_param_list<in, out>;
+
+        template <typename Evaluation>
+        GT_FUNCTION static void apply(Evaluation &eval, kfull::first_level) {
+            eval(out()) = eval(in());
+        }
+
+        template <typename Evaluation>
+        GT_FUNCTION static void apply(Evaluation &eval, kfull::modify<1, 0>) {
+            eval(out()) = eval(out(0, 0, -1)) + eval(in());
+        }
+    };
+
+    class thread_team_mc_stencil : public ::testing::Test {
+      protected:
+        static constexpr uint_t d1 = 13, d2 = 29, d3 = 7;
+
+        storage_info_t m_info{d1 + 2, d2 + 2, d3};
+        storage_t m_in{m_info, [](int i, int j, int k) { return i + 10 * j + 100 * k; }};
+        storage_t m_out{m_info, 0};
+        storage_t m_ref{m_info, 0};
+        halo_descriptor m_di{1, 1, 1, d1, d1 + 2};
+        halo_descriptor m_dj{1, 1, 1, d2, d2 + 2};
+        thread_team_mc m_team;
+
+        bool verify() {
+            m_out.sync();
+            verifier verif(1e-10);
+            array<array<uint_t, 2>, 3> halos{{{1, 1}, {1, 1}, {0, 0}}};
+            return verif.verify(make_grid(m_di, m_dj, d3), m_ref, m_out, halos);
+        }
+    };
+} // namespace
+
+TEST_F(thread_team_mc_stencil, parallel) {
+    auto in = make_host_view(m_in);
+    auto ref = make_host_view(m_ref);
+    for (int i = 1; i <= d1; ++i)
+        for (int j = 1; j <= d2; ++j)
+            for (int k = 0; k < d3; ++k)
+                ref(i, j, k) = in(i - 1, j, k) + in(i + 1, j, k) + in(i, j - 1, k) + in(i, j + 1, k);
+
+    auto comp = make_computation<backend_t>(make_grid(m_di, m_dj, d3),
+        m_team,
+        p_in() = m_in,
+        make_multistage(execute::parallel(), make_stage<neighbours_functor>(p_in(), p_out())));
+    comp.run(p_out() = m_out);
+
+    EXPECT_TRUE(verify());
+}
+
+TEST_F(thread_team_mc_stencil, plan_with_temporary) {
+    auto in = make_host_view(m_in);
+    auto ref = make_host_view(m_ref);
+    for (int i = 1; i <= d1; ++i)
+        for (int j = 1; j <= d2; ++j)
+            for (int k = 0; k < d3; ++k)
+                ref(i, j, k) = (k ? ref(i, j, k - 1) : 0) + in(i - 1, j, k) + in(i + 1, j, k) + in(i, j - 1, k) +
+                               in(i, j + 1, k);
+
+    auto comp = make_computation<backend_t>(make_grid(m_di, m_dj, d3),
+        p_in() = m_in,
+        make_multistage(execute::forward(),
+            make_stage<neighbours_functor>(p_in(), p_tmp()),
+            make_stage<sum_functor>(p_tmp(), p_out())),
+        m_team);
+    auto plan = comp.make_plan(p_out() = m_out);
+    for (int run = 0; run < 5; ++run)
+        plan.run();
+
+    EXPECT_TRUE(verify());
+}
+
+TEST_F(thread_team_mc_stencil, throws_on_thread_count_change) {
+    auto comp = make_computation<backend_t>(make_grid(m_di, m_dj, d3),
+        m_team,
+        p_in() = m_in,
+        make_multistage(execute::parallel(), make_stage<neighbours_functor>(p_in(), p_out())));
+
+    const int threads = omp_get_max_threads();
+    omp_set_num_threads(threads + 1);
+    EXPECT_THROW(comp.run(p_out() = m_out), std::runtime_error);
+    omp_set_num_threads(threads);
+}
+#endif
@@ -0,0 +1,124 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <type_traits>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/stencil_composition/stencil_composition.hpp>
+#include <gridtools/storage/storage_facility.hpp>
+#include <gridtools/tools/backend_select.hpp>
+
+using namespace gridtools;
+
+#ifdef GT_BACKEND_MC
+namespace {
+    // evaluated on scalars, as SIMD packs would cross tile boundaries
+    struct lap_functor {
+        using simd = std::true_type;
+
+        using in = accessor<0, intent::in, extent<-1, 1, -1, 1>>;
+        using out = accessor<1, intent::inout>;
+        using param_list = make_param_list<in, out>;
+
+        template <typename Evaluation>
+        GT_FUNCTION static void apply(Evaluation &eval) {
+            eval(out()) = 4 * eval(in()) - (eval(in(1, 0, 0)) + eval(in(-1, 0, 0)) + eval(in(0, 1, 0)) +
+                                               eval(in(0, -1, 0)));
+        }
+    };
+
+    using axis_t = axis<2>;
+    using first_level_t = axis_t::get_interval<0>;
+    using other_levels_t = axis_t::get_interval<1>;
+
+    struct sum_functor {
+        using in = accessor<0, intent::in, extent<0, 0, 0, 0, -1, 0>>;
+        using out = accessor<1, intent::inout>;
+        using param_list = make_param_list<in, out>;
+
+        template <typename Evaluation>
+        GT_FUNCTION static void apply(Evaluation &eval, first_level_t) {
+            eval(out()) = eval(in());
+        }
+
+        template <typename Evaluation>
+        GT_FUNCTION static void apply(Evaluation &eval, other_levels_t) {
+            eval(out()) = eval(in(0, 0, -1)) + eval(in());
+        }
+    };
+
+    using storage_info_t = storage_traits<backend_t>::tiled_storage_info_t<0, halo<1, 1, 0>, tile<8, 4>>;
+    using storage_t = storage_traits<backend_t>::data_store_t<double, storage_info_t>;
+
+    double input(int i, int j, int k) { return (i * 7 + j * 13 + k * 5) % 17 + .5 * (i % 3); }
+
+    class tiled_storage_mc : public ::testing::TestWithParam<int> {
+      protected:
+        static constexpr int d2 = 9, d3 = 6;
+        const int d1 = GetParam();
+
+        storage_info_t m_info{d1 + 2, d2 + 2, d3};
+        storage_t m_in{m_info, input};
+        storage_t m_out{m_info, -1.};
+
+        halo_descriptor i_halo() const { return {1, 1, 1, (uint_t)d1, (uint_t)d1 + 2}; }
+        halo_descriptor j_halo() const { return {1, 1, 1, d2, d2 + 2}; }
+    };
+
+    TEST_P(tiled_storage_mc, laplacian) {
+        arg<0, storage_t> p_in;
+        arg<1, storage_t> p_out;
+
+        make_computation<backend_t>(make_grid(i_halo(), j_halo(), d3),
+            p_in = m_in,
+            p_out = m_out,
+            make_multistage(execute::parallel(), make_stage<lap_functor>(p_in, p_out)))
+            .run();
+
+        m_out.sync();
+        auto view = make_host_view(m_out);
+        for (int i = 0; i < d1 + 2; ++i)
+            for (int j = 0; j < d2 + 2; ++j)
+                for (int k = 0; k < d3; ++k) {
+                    bool inner = i > 0 && i <= d1 && j > 0 && j <= d2;
+                    double expected = inner ? 4 * input(i, j, k) - (input(i + 1, j, k) + input(i - 1, j, k) +
+                                                                       input(i, j + 1, k) + input(i, j - 1, k))
+                                            : -1;
+                    EXPECT_DOUBLE_EQ(expected, view(i, j, k)) << "i=" << i << " j=" << j << " k=" << k;
+                }
+    }
+
+    TEST_P(tiled_storage_mc, k_cache_fill) {
+        arg<0, storage_t> p_in;
+        arg<1, storage_t> p_out;
+
+        make_computation<backend_t>(make_grid(i_halo(), j_halo(), axis_t((uint_t)1, (uint_t)(d3 - 1))),
+            p_in = m_in,
+            p_out = m_out,
+            make_multistage(execute::forward(),
+                define_caches(cache<cache_type::k, cache_io_policy::fill>(p_in)),
+                make_stage<sum_functor>(p_in, p_out)))
+            .run();
+
+        m_out.sync();
+        auto view = make_host_view(m_out);
+        for (int i = 0; i < d1 + 2; ++i)
+            for (int j = 0; j < d2 + 2; ++j)
+                for (int k = 0; k < d3; ++k) {
+                    bool inner = i > 0 && i <= d1 && j > 0 && j <= d2;
+                    double expected = inner ? input(i, j, k) + (k > 0 ? input(i, j, k - 1) : 0) : -1;
+                    EXPECT_DOUBLE_EQ(expected, view(i, j, k)) << "i=" << i << " j=" << j << " k=" << k;
+                }
+    }
+
+    INSTANTIATE_TEST_CASE_P(i_sizes, tiled_storage_mc, ::testing::Values(1, 7, 8, 13, 35));
+} // namespace
+#endif
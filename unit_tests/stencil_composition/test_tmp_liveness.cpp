@@ -0,0 +1,142 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gtest/gtest.h>
+
+#include <gridtools/stencil_composition/stencil_composition.hpp>
+#include <gridtools/storage/storage_facility.hpp>
+#include <gridtools/tools/backend_select.hpp>
+
+using namespace gridtools;
+
+namespace {
+    struct add_functor {
+        using in = accessor<0>;
+        using out = accessor<1, intent::inout>;
+        using param_list = make_param_list<in, out>;
+
+        template <typename Evaluation>
+        GT_FUNCTION static void apply(Evaluation &eval) {
+            eval(out()) = eval(in()) + 1;
+        }
+    };
+
+    struct smooth_functor {
+        using in = accessor<0, intent::in, extent<-1, 1, -1, 1>>;
+        using out = accessor<1, intent::inout>;
+        using param_list = make_param_list<in, out>;
+
+        template <typename Evaluation>
+        GT_FUNCTION static void apply(Evaluation &eval) {
+            eval(out()) = eval(in(-1, 0, 0)) + 2 * eval(in(1, 0, 0)) + 3 * eval(in(0, -1, 0)) + 4 * eval(in(0, 1, 0));
+        }
+    };
+
+    struct sum_functor {
+        using in1 = accessor<0>;
+        using in2 = accessor<1>;
+        using out = accessor<2, intent::inout>;
+        using param_list = make_param_list<in1, in2, out>;
+
+        template <typename Evaluation>
+        GT_FUNCTION static void apply(Evaluation &eval) {
+            eval(out()) = eval(in1()) + eval(in2());
+        }
+    };
+
+    using storage_info_t = storage_traits<backend_t>::storage_info_t<0, 3, halo<2, 2, 0>>;
+    using storage_t = storage_traits<backend_t>::data_store_t<float_type, storage_info_t>;
+    using int_storage_t = storage_traits<backend_t>::data_store_t<int, storage_info_t>;
+
+    using p_in = arg<0, storage_t>;
+    using p_out = arg<1, storage_t>;
+    using p_tmp0 = tmp_arg<2, storage_t>;
+    using p_tmp1 = tmp_arg<3, storage_t>;
+    using p_tmp2 = tmp_arg<4, storage_t>;
+    using p_tmp3 = tmp_arg<5, storage_t>;
+    using p_int_tmp = tmp_arg<6, int_storage_t>;
+
+    TEST(tmp_liveness, owners) {
+        // tmp0: [0, 1], tmp1: [1, 2], int_tmp: [2, 3], tmp2: [2, 3], tmp3: [0, 3]
+        auto mss0 = make_multistage(execute::parallel(),
+            make_stage<add_functor>(p_in(), p_tmp0()),
+            make_stage<add_functor>(p_in(), p_tmp3()));
+        auto mss1 = make_multistage(execute::parallel(), make_stage<add_functor>(p_tmp0(), p_tmp1()));
+        auto mss2 = make_multistage(execute::parallel(),
+            make_stage<add_functor>(p_tmp1(), p_int_tmp()),
+            make_stage<add_functor>(p_int_tmp(), p_tmp2()));
+        auto mss3 = make_multistage(execute::parallel(), make_stage<sum_functor>(p_tmp2(), p_tmp3(), p_out()));
+        using msses_t = std::tuple<decltype(mss0), decltype(mss1), decltype(mss2), decltype(mss3)>;
+        using liveness_t = _impl::tmp_liveness<msses_t, meta::list<p_tmp0, p_tmp1, p_int_tmp, p_tmp2, p_tmp3>>;
+
+        EXPECT_EQ(0, liveness_t::owner(0));
+        EXPECT_EQ(1, liveness_t::owner(1));
+        // different data store type
+        EXPECT_EQ(2, liveness_t::owner(2));
+        // tmp0 is dead after mss1
+        EXPECT_EQ(0, liveness_t::owner(3));
+        // live everywhere
+        EXPECT_EQ(4, liveness_t::owner(4));
+    }
+
+    TEST(tmp_liveness, same_mss) {
+        auto mss = make_multistage(execute::parallel(),
+            make_stage<add_functor>(p_in(), p_tmp0()),
+            make_stage<add_functor>(p_tmp0(), p_tmp1()),
+            make_stage<add_functor>(p_tmp1(), p_out()));
+        using liveness_t = _impl::tmp_liveness<std::tuple<decltype(mss)>, meta::list<p_tmp0, p_tmp1>>;
+
+        EXPECT_EQ(0, liveness_t::owner(0));
+        EXPECT_EQ(1, liveness_t::owner(1));
+    }
+
+    float_type input(int i, int j, int k) { return i + 10 * j + 100 * k; }
+
+    TEST(tmp_liveness, shared_storages_give_same_result) {
+        constexpr int d1 = 12, d2 = 9, d3 = 4, halo_size = 2;
+
+        storage_info_t info(d1 + 2 * halo_size, d2 + 2 * halo_size, d3);
+        storage_t in(info, input);
+        storage_t out(info, -1);
+
+        auto grid = make_grid(halo_descriptor(halo_size, halo_size, halo_size, d1 + halo_size - 1, d1 + 2 * halo_size),
+            halo_descriptor(halo_size, halo_size, halo_size, d2 + halo_size - 1, d2 + 2 * halo_size),
+            d3);
+
+        // tmp2 shares the storage of tmp0, tmp3 the one of tmp1
+        make_computation<backend_t>(grid,
+            p_in() = in,
+            p_out() = out,
+            make_multistage(execute::parallel(), make_stage<add_functor>(p_in(), p_tmp0())),
+            make_multistage(execute::parallel(), make_stage<smooth_functor>(p_tmp0(), p_tmp1())),
+            make_multistage(execute::parallel(), make_stage<smooth_functor>(p_tmp1(), p_tmp2())),
+            make_multistage(execute::parallel(), make_stage<add_functor>(p_tmp2(), p_tmp3())),
+            make_multistage(execute::parallel(), make_stage<sum_functor>(p_tmp3(), p_in(), p_out())))
+            .run();
+
+        auto tmp0 = [](int i, int j, int k) { return input(i, j, k) + 1; };
+        auto smooth = [](auto f) {
+            return [f](int i, int j, int k) {
+                return f(i - 1, j, k) + 2 * f(i + 1, j, k) + 3 * f(i, j - 1, k) + 4 * f(i, j + 1, k);
+            };
+        };
+        auto tmp2 = smooth(smooth(tmp0));
+
+        out.sync();
+        auto view = make_host_view(out);
+        for (int i = 0; i < d1 + 2 * halo_size; ++i)
+            for (int j = 0; j < d2 + 2 * halo_size; ++j)
+                for (int k = 0; k < d3; ++k) {
+                    bool inner = i >= halo_size && i < d1 + halo_size && j >= halo_size && j < d2 + halo_size;
+                    float_type expected = inner ? tmp2(i, j, k) + 1 + input(i, j, k) : -1;
+                    EXPECT_FLOAT_EQ(expected, view(i, j, k)) << "i=" << i << " j=" << j << " k=" << k;
+                }
+    }
+} // namespace
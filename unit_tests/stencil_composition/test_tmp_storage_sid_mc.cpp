@@ -34,6 +34,11 @@ TEST(tmp_storage_sid_mc, allocator) {
         ptr[i] = 0;
         EXPECT_EQ(ptr[i], 0);
     }
+
+    auto info = allocator.hugepage_info();
+    ASSERT_EQ(1, info.size());
+    EXPECT_EQ(n * sizeof(double), info[0].size);
+    EXPECT_EQ(get_hugepage_strategy(), info[0].requested);
 }
 
 TEST(tmp_storage_sid_mc, nonzero_k_extents) {
@@ -84,6 +84,46 @@ TEST(StorageInfo, StridesAlignment) {
     }
 }
 
+TEST(StorageInfo, StridesPadding) {
+    {
+        // 512 doubles are 4 KiB: the i-length is padded in steps of the alignment, the j-length in steps of one
+        storage_info<0, layout_map<2, 1, 0>, halo<0, 0, 0>, alignment<8>, cache_padding<>> si(512, 64, 6);
+
+        EXPECT_EQ((si.padded_length<0>()), 520);
+        EXPECT_EQ((si.padded_length<1>()), 65);
+        EXPECT_EQ((si.padded_length<2>()), 6);
+        EXPECT_EQ((si.stride<0>()), 1);
+        EXPECT_EQ((si.stride<1>()), 520);
+        EXPECT_EQ((si.stride<2>()), 520 * 65);
+        EXPECT_EQ((si.padded_total_length()), 520 * 65 * 6);
+        EXPECT_EQ((si.total_length()), 512 * 64 * 6);
+    }
+    {
+        storage_info<0, layout_map<0, 1, 2>, halo<0, 0, 0>, alignment<1>, cache_padding<>> si(4, 8, 512);
+
+        EXPECT_EQ((si.stride<0>()), 513 * 8);
+        EXPECT_EQ((si.stride<1>()), 513);
+        EXPECT_EQ((si.stride<2>()), 1);
+    }
+    {
+        // a smaller critical stride or larger elements pad earlier
+        storage_info<0, layout_map<0, 1, 2>, halo<0, 0, 0>, alignment<1>, cache_padding<1024, 8>> si(4, 8, 256);
+
+        EXPECT_EQ((si.stride<0>()), 257 * 8);
+        EXPECT_EQ((si.stride<1>()), 257);
+    }
+    {
+        // masked dimensions are skipped, strides that do not alias are kept
+        storage_info<0, layout_map<1, -1, 0>, halo<2, 0, 2>, alignment<8>, cache_padding<>> si(100, 7, 80);
+
+        EXPECT_EQ((si.stride<0>()), 1);
+        EXPECT_EQ((si.stride<1>()), 0);
+        EXPECT_EQ((si.stride<2>()), 104);
+        EXPECT_EQ((si.padded_length<0>()), 104);
+        EXPECT_EQ((si.padded_length<2>()), 80);
+    }
+}
+
 TEST(StorageInfo, StridesAlignmentHalo) {
     {
         storage_info<0, layout_map<0, 1, 2>, halo<1, 2, 3>, alignment<32>> si(3, 5, 7);
@@ -59,3 +59,15 @@ TEST(StorageInfoRT, Make3Dmasked) {
     ASSERT_EQ(si.stride<1>(), strides[1]);
     ASSERT_EQ(si.stride<2>(), strides[2]);
 }
+
+TEST(StorageInfoRT, Paddings) {
+    using storage_info_t = storage_info<0, layout_map<2, 1, 0>, zero_halo<3>, alignment<8>, cache_padding<>>;
+    storage_info_t si(512, 64, 6);
+
+    auto paddings = make_storage_info_rt(si).paddings();
+    ASSERT_EQ(3, paddings.size());
+    EXPECT_EQ(si.padded_length<0>() - 512, paddings[0]);
+    EXPECT_EQ(si.padded_length<1>() - 64, paddings[1]);
+    EXPECT_EQ(0, paddings[2]);
+    EXPECT_NE(0, paddings[0]);
+}
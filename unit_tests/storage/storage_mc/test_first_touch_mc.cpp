@@ -0,0 +1,160 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#define GT_MC_FIRST_TOUCH
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <omp.h>
+
+#include <gridtools/stencil_composition/extent.hpp>
+#include <gridtools/stencil_composition/grid.hpp>
+#include <gridtools/stencil_composition/structured_grids/backend_mc/execinfo_mc.hpp>
+#include <gridtools/stencil_composition/structured_grids/backend_mc/tmp_storage_sid.hpp>
+#include <gridtools/storage/storage_facility.hpp>
+
+using namespace gridtools;
+
+namespace {
+    using storage_info_t = storage_traits<backend::mc>::storage_info_t<0, 3, halo<2, 1, 0>>;
+    using storage_info_4d_t = storage_traits<backend::mc>::storage_info_t<0, 4, halo<1, 2, 0, 0>>;
+
+    // checks that every point of the inner region is touched by the thread that processes it in a stencil run
+    template <class StorageInfo>
+    void check_owners(StorageInfo const &info) {
+        std::vector<int> touched(info.padded_total_length(), 0);
+        std::vector<int> owner(info.padded_total_length(), -1);
+        for_each_offset_mc(info, [&](int_t offset) {
+            ++touched[offset];
+            owner[offset] = omp_get_thread_num();
+        });
+        for (int count : touched)
+            ASSERT_EQ(1, count);
+
+        halo_descriptor di{info.template begin<0>(),
+            info.template begin<0>(),
+            info.template begin<0>(),
+            info.template end<0>(),
+            (uint_t)info.template total_length<0>()};
+        halo_descriptor dj{info.template begin<1>(),
+            info.template begin<1>(),
+            info.template begin<1>(),
+            info.template end<1>(),
+            (uint_t)info.template total_length<1>()};
+        auto grid = make_grid(di, dj, 1);
+        execinfo_mc exinfo(grid);
+        const int_t i_blocks = exinfo.i_blocks();
+        const int_t j_blocks = exinfo.j_blocks();
+        int_t mismatches = 0;
+#pragma omp parallel for collapse(2) reduction(+ : mismatches)
+        for (int_t bj = 0; bj < j_blocks; ++bj) {
+            for (int_t bi = 0; bi < i_blocks; ++bi) {
+                auto block = exinfo.block(bi, bj);
+                for (int_t j = block.j_first; j < block.j_first + block.j_block_size; ++j)
+                    for (int_t i = block.i_first; i < block.i_first + block.i_block_size; ++i)
+                        for (int_t k = 0; k < info.template total_length<2>(); ++k)
+                            if (owner[info.index(i, j, k)] != omp_get_thread_num())
+                                ++mismatches;
+            }
+        }
+        EXPECT_EQ(0, mismatches);
+    }
+} // namespace
+
+TEST(first_touch_mc, owners) {
+    check_owners(storage_info_t(30, 40, 7));
+    check_owners(storage_info_t(63, 3, 5));
+    check_owners(storage_info_t(5, 4, 1));
+}
+
+TEST(first_touch_mc, owners_4d) {
+    storage_info_4d_t info(13, 17, 4, 3);
+    std::vector<int> touched(info.padded_total_length(), 0);
+    for_each_offset_mc(info, [&](int_t offset) { ++touched[offset]; });
+    for (int count : touched)
+        ASSERT_EQ(1, count);
+}
+
+TEST(first_touch_mc, blocks) {
+    for (storage_info_t info : {storage_info_t(30, 40, 7), storage_info_t(63, 3, 5), storage_info_t(5, 4, 1)}) {
+        std::vector<int> offset_owner(info.padded_total_length(), -1);
+        for_each_offset_mc(info, [&](int_t offset) { offset_owner[offset] = omp_get_thread_num(); });
+
+        // every point is in one box, processed by the thread that touches it first
+        std::vector<int> owner(info.padded_total_length(), -1);
+        std::vector<int> visits(info.padded_total_length(), 0);
+        for_each_block_mc(info, [&](array<int_t, 3> const &first, array<int_t, 3> const &last) {
+            for (int_t i = first[0]; i < last[0]; ++i)
+                for (int_t j = first[1]; j < last[1]; ++j)
+                    for (int_t k = first[2]; k < last[2]; ++k) {
+                        owner[info.index(i, j, k)] = omp_get_thread_num();
+#pragma omp atomic
+                        ++visits[info.index(i, j, k)];
+                    }
+        });
+        for (int i = 0; i < info.total_length<0>(); ++i)
+            for (int j = 0; j < info.total_length<1>(); ++j)
+                for (int k = 0; k < info.total_length<2>(); ++k) {
+                    ASSERT_EQ(1, visits[info.index(i, j, k)]);
+                    EXPECT_EQ(offset_owner[info.index(i, j, k)], owner[info.index(i, j, k)]);
+                }
+    }
+}
+
+TEST(first_touch_mc, data_store) {
+    using data_store_t = storage_traits<backend::mc>::data_store_t<double, storage_info_t>;
+    storage_info_t info(12, 9, 4);
+
+    data_store_t zeros(info);
+    auto zeros_view = make_host_view(zeros);
+    for (int i = 0; i < 12; ++i)
+        for (int j = 0; j < 9; ++j)
+            for (int k = 0; k < 4; ++k)
+                EXPECT_EQ(0, zeros_view(i, j, k));
+
+    data_store_t values(info, [](int i, int j, int k) { return i + 100 * j + 10000 * k; });
+    auto values_view = make_host_view(values);
+    for (int i = 0; i < 12; ++i)
+        for (int j = 0; j < 9; ++j)
+            for (int k = 0; k < 4; ++k)
+                EXPECT_EQ(i + 100 * j + 10000 * k, values_view(i, j, k));
+}
+
+namespace {
+    // records the thread that default-initializes it
+    struct touched_by {
+        int thread = omp_get_thread_num();
+    };
+
+    // checks that the slice of every thread is touched by that thread, including the extents
+    template <class Extent>
+    void check_tmp_owners(pos3<std::size_t> const &block_size) {
+        tmp_allocator_mc allocator;
+        auto tmp = make_tmp_storage_mc<touched_by, Extent>(allocator, block_size);
+        touched_by *ptr = sid::get_origin(tmp)();
+        auto strides = sid::get_strides(tmp);
+        const int_t thread_stride = sid::get_stride<thread_dim_mc>(strides);
+        const int_t j_stride = sid::get_stride<dim::j>(strides);
+        const int_t k_stride = sid::get_stride<dim::k>(strides);
+        for (int_t t = 0; t < omp_get_max_threads(); ++t)
+            for (int_t k = Extent::kminus::value; k < (int_t)block_size.k + Extent::kplus::value; ++k)
+                for (int_t j = Extent::jminus::value; j < (int_t)block_size.j + Extent::jplus::value; ++j)
+                    for (int_t i = Extent::iminus::value; i < (int_t)block_size.i + Extent::iplus::value; ++i)
+                        EXPECT_EQ(t, ptr[t * thread_stride + k * k_stride + j * j_stride + i].thread)
+                            << "i=" << i << " j=" << j << " k=" << k;
+    }
+} // namespace
+
+TEST(first_touch_mc, tmp_storage) {
+    check_tmp_owners<extent<-1, 1, -1, 1>>({12, 3, 1});
+    check_tmp_owners<extent<-1, 1, -2, 1, -1, 2>>({12, 3, 8});
+}
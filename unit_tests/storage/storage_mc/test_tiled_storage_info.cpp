@@ -0,0 +1,105 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/stencil_composition/sid/concept.hpp>
+#include <gridtools/storage/sid.hpp>
+#include <gridtools/storage/storage_facility.hpp>
+
+using namespace gridtools;
+
+namespace {
+    using storage_info_t = storage_traits<backend::mc>::tiled_storage_info_t<0, halo<2, 1, 0>, tile<8, 4>>;
+    using data_store_t = storage_traits<backend::mc>::data_store_t<double, storage_info_t>;
+
+    TEST(tiled_storage_info, lengths) {
+        storage_info_t info(21, 11, 5);
+
+        // tiles start at the inner region: 6 unused points in front of i = 0, 3 in front of j = 0
+        EXPECT_EQ(6, storage_info_t::tile_offset<0>());
+        EXPECT_EQ(3, storage_info_t::tile_offset<1>());
+        EXPECT_EQ(4 * 8, info.padded_length<0>());
+        EXPECT_EQ(4 * 4, info.padded_length<1>());
+        EXPECT_EQ(5, info.padded_length<2>());
+        EXPECT_EQ(4 * 8 * 4 * 4 * 5, info.padded_total_length());
+        EXPECT_EQ(21 * 11 * 5, info.total_length());
+        EXPECT_EQ(17 * 9 * 5, info.length());
+
+        EXPECT_EQ(1, info.stride<0>());
+        EXPECT_EQ(8, info.stride<1>());
+        EXPECT_EQ(32, info.stride<2>());
+        EXPECT_EQ(8 * 4 * 5, info.tile_strides()[0]);
+        EXPECT_EQ(4 * 8 * 4 * 5, info.tile_strides()[1]);
+    }
+
+    TEST(tiled_storage_info, index) {
+        storage_info_t info(21, 11, 5);
+
+        // the first point of the inner region starts a tile
+        EXPECT_EQ(info.tile_strides()[0] + info.tile_strides()[1], info.first_index_of_inner_region());
+        EXPECT_EQ(info.index(2, 1, 0) + 1, info.index(3, 1, 0));
+        EXPECT_EQ(info.index(2, 1, 0) + 8, info.index(2, 2, 0));
+        EXPECT_EQ(info.index(2, 1, 0) + 32, info.index(2, 1, 1));
+        EXPECT_EQ(info.index(2, 1, 0) + info.tile_strides()[0], info.index(10, 1, 0));
+        EXPECT_EQ(info.index(2, 1, 0) + info.tile_strides()[1], info.index(2, 5, 0));
+
+        // all points map to distinct indices inside the allocation
+        std::vector<int> count(info.padded_total_length(), 0);
+        for (int i = 0; i < 21; ++i)
+            for (int j = 0; j < 11; ++j)
+                for (int k = 0; k < 5; ++k) {
+                    int index = info.index(i, j, k);
+                    ASSERT_GE(index, 0);
+                    ASSERT_LT(index, info.padded_total_length());
+                    EXPECT_EQ(1, ++count[index]);
+                }
+    }
+
+    TEST(tiled_storage_info, equality) {
+        EXPECT_EQ(storage_info_t(21, 11, 5), storage_info_t(21, 11, 5));
+        EXPECT_NE(storage_info_t(21, 11, 5), storage_info_t(21, 11, 6));
+    }
+
+    TEST(tiled_storage_info, view) {
+        storage_info_t info(21, 11, 5);
+        data_store_t ds(info, [](int i, int j, int k) { return i + 100 * j + 10000 * k; });
+        auto view = make_host_view(ds);
+        for (int i = 0; i < 21; ++i)
+            for (int j = 0; j < 11; ++j)
+                for (int k = 0; k < 5; ++k)
+                    EXPECT_EQ(i + 100 * j + 10000 * k, view(i, j, k));
+
+        view(20, 10, 4) = -1;
+        EXPECT_EQ(-1, make_host_view<access_mode::read_only>(ds)(20, 10, 4));
+        EXPECT_EQ(-1, ds.get_storage_ptr()->get_cpu_ptr()[info.index(20, 10, 4)]);
+    }
+
+    TEST(tiled_storage_info, sid) {
+        storage_info_t info(21, 11, 5);
+        data_store_t ds(info, 0.);
+        auto strides = sid::get_strides(ds);
+        EXPECT_EQ(1, (sid::get_stride<integral_constant<int, 0>>(strides)));
+        EXPECT_EQ(8, (sid::get_stride<integral_constant<int, 1>>(strides)));
+        EXPECT_EQ(32, (sid::get_stride<integral_constant<int, 2>>(strides)));
+        EXPECT_EQ(info.tile_strides()[0], (sid::get_stride<sid::blocked_dim<integral_constant<int, 0>>>(strides)));
+        EXPECT_EQ(info.tile_strides()[1], (sid::get_stride<sid::blocked_dim<integral_constant<int, 1>>>(strides)));
+    }
+
+    TEST(tiled_storage_info, for_each_offset) {
+        storage_info_t info(21, 11, 5);
+        std::vector<int> count(info.padded_total_length(), 0);
+        for_each_offset_mc(info, [&](int_t offset) { ++count[offset]; });
+        for (int c : count)
+            EXPECT_EQ(1, c);
+    }
+} // namespace
@@ -8,8 +8,12 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <complex>
+#include <string>
+
 #include "gtest/gtest.h"
 
+#include <gridtools/common/caching_arena.hpp>
 #include <gridtools/common/gt_assert.hpp>
 #include <gridtools/storage/storage_host/host_storage.hpp>
 
@@ -38,3 +42,38 @@ TEST(StorageHostTest, Simple) {
     EXPECT_EQ(s1.get_cpu_ptr()[1], 200);
     EXPECT_EQ(s1.get_cpu_ptr()[0], 100);
 }
+
+namespace {
+    struct counted {
+        static int alive;
+        std::string value = "init";
+
+        counted() { ++alive; }
+        ~counted() { --alive; }
+    };
+    int counted::alive = 0;
+} // namespace
+
+TEST(StorageHostTest, NonTrivialDataType) {
+    {
+        gridtools::host_storage<counted> s(5, 0u, gridtools::alignment<4>{});
+        EXPECT_EQ(5 + 4 - 1, counted::alive);
+        EXPECT_EQ("init", s.get_cpu_ptr()[4].value);
+        gridtools::host_storage<counted> other(2);
+        s.swap(other);
+        EXPECT_EQ("init", other.get_cpu_ptr()[4].value);
+    }
+    EXPECT_EQ(0, counted::alive);
+
+    // the elements are also constructed and destroyed in the blocks of a caching arena
+    gridtools::caching_arena_scope scope;
+    for (int run = 0; run < 2; ++run) {
+        gridtools::host_storage<counted> s(7);
+        EXPECT_EQ(7, counted::alive);
+        EXPECT_EQ("init", s.get_cpu_ptr()[6].value);
+    }
+    EXPECT_EQ(0, counted::alive);
+
+    gridtools::host_storage<std::complex<double>> c(3);
+    EXPECT_EQ(std::complex<double>(), c.get_cpu_ptr()[2]);
+}
@@ -0,0 +1,101 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/storage/storage_facility.hpp>
+#include <gridtools/tools/backend_select.hpp>
+
+using namespace gridtools;
+
+namespace {
+    using storage_info_t = storage_traits<backend_t>::storage_info_t<0, 3, halo<2, 1, 0>>;
+    using data_store_t = storage_traits<backend_t>::data_store_t<double, storage_info_t>;
+
+    double input(int i, int j, int k) { return i + 100 * j + 10000 * k; }
+
+    template <class DataStore, class F>
+    void expect_values(DataStore const &ds, F const &expected) {
+        auto view = make_host_view<access_mode::read_only>(ds);
+        for (int i = 0; i < ds.template total_length<0>(); ++i)
+            for (int j = 0; j < ds.template total_length<1>(); ++j)
+                for (int k = 0; k < ds.template total_length<2>(); ++k)
+                    ASSERT_EQ(expected(i, j, k), view(i, j, k)) << "i=" << i << " j=" << j << " k=" << k;
+    }
+
+    TEST(bulk_operations, fill) {
+        storage_info_t info(23, 11, 7);
+        data_store_t ds(info, -1.);
+        fill(ds, 3.);
+        expect_values(ds, [](int, int, int) { return 3.; });
+        fill(ds, input);
+        expect_values(ds, input);
+    }
+
+    TEST(bulk_operations, fill_masked) {
+        using info_t = storage_traits<backend_t>::special_storage_info_t<1, selector<1, 0, 1>, halo<1, 0, 0>>;
+        using ds_t = storage_traits<backend_t>::data_store_t<double, info_t>;
+        info_t info(9, 5, 4);
+        ds_t ds(info, -1.);
+        fill(ds, [](int i, int j, int k) { return input(i, j, k); });
+        expect_values(ds, [](int i, int, int k) { return input(i, 0, k); });
+    }
+
+    TEST(bulk_operations, copy) {
+        storage_info_t info(23, 11, 7);
+        data_store_t src(info, input);
+        data_store_t dst(info, -1.);
+        copy(src, dst);
+        expect_values(dst, input);
+
+        // different layout, halo and data type
+        using other_info_t =
+            storage_traits<backend_t>::custom_layout_storage_info_t<1, layout_map<0, 1, 2>, halo<0, 3, 0>>;
+        using other_ds_t = storage_traits<backend_t>::data_store_t<float, other_info_t>;
+        other_ds_t other(other_info_t(23, 11, 7), -1.f);
+        copy(src, other);
+        expect_values(other, [](int i, int j, int k) { return (float)input(i, j, k); });
+        fill(dst, 0.);
+        copy(other, dst);
+        expect_values(dst, input);
+
+        data_store_t smaller(storage_info_t(23, 11, 6), 0.);
+        EXPECT_THROW(copy(src, smaller), std::runtime_error);
+    }
+
+    TEST(bulk_operations, axpy) {
+        storage_info_t info(23, 11, 7);
+        data_store_t x(info, input);
+        data_store_t y(info, 1.);
+        axpy(2., x, y);
+        expect_values(y, [](int i, int j, int k) { return 2 * input(i, j, k) + 1; });
+
+        using other_info_t =
+            storage_traits<backend_t>::custom_layout_storage_info_t<1, layout_map<1, 2, 0>, halo<0, 0, 0>>;
+        using other_ds_t = storage_traits<backend_t>::data_store_t<double, other_info_t>;
+        other_ds_t other(other_info_t(23, 11, 7), input);
+        axpy(-1., other, y);
+        expect_values(y, [](int i, int j, int k) { return input(i, j, k) + 1; });
+    }
+
+#ifdef GT_BACKEND_MC
+    TEST(bulk_operations, mc_owners) {
+        // the points are written by the threads that touch them first in the mc storages
+        storage_info_t info(47, 13, 5);
+        std::vector<int> owner(info.padded_total_length(), -1);
+        for_each_offset_mc(info, [&](int_t offset) { owner[offset] = omp_get_thread_num(); });
+        data_store_t ds(info, -1.);
+        fill(ds, [](int, int, int) { return omp_get_thread_num(); });
+        expect_values(ds, [&](int i, int j, int k) { return owner[info.index(i, j, k)]; });
+    }
+#endif
+} // namespace
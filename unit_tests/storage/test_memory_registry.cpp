@@ -0,0 +1,133 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#define GT_ENABLE_MEMORY_REGISTRY
+
+#include <gridtools/storage/common/memory_registry.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/stencil_composition/stencil_composition.hpp>
+#include <gridtools/storage/storage_facility.hpp>
+#include <gridtools/tools/backend_select.hpp>
+
+using namespace gridtools;
+
+namespace {
+    using storage_info_t = storage_traits<backend_t>::storage_info_t<0, 3, halo<1, 1, 0>>;
+    using data_store_t = storage_traits<backend_t>::data_store_t<double, storage_info_t>;
+
+    memory_record find(std::vector<memory_record> const &records, std::string const &name) {
+        auto it = std::find_if(
+            records.begin(), records.end(), [&](memory_record const &record) { return record.name == name; });
+        return it == records.end() ? memory_record() : *it;
+    }
+
+    TEST(memory_registry, data_stores) {
+        auto &registry = memory_registry::instance();
+        storage_info_t info(12, 13, 7);
+        const std::size_t bytes = info.padded_total_length() * sizeof(double);
+        const std::size_t before = registry.bytes();
+        {
+            data_store_t a(info, "memory_registry_a");
+            data_store_t b(info, 1., "memory_registry_b");
+            data_store_t c("memory_registry_b");
+            c.allocate(info);
+            EXPECT_EQ(before + 3 * bytes, registry.bytes());
+            EXPECT_LE(before + 3 * bytes, registry.peak_bytes());
+
+            // copies share the storage
+            data_store_t a_copy = a;
+            EXPECT_EQ(before + 3 * bytes, registry.bytes());
+
+            auto record = find(registry.names(), "memory_registry_a");
+            EXPECT_EQ(bytes, record.bytes);
+            EXPECT_EQ(1, record.allocations);
+            record = find(registry.names(), "memory_registry_b");
+            EXPECT_EQ(2 * bytes, record.bytes);
+            EXPECT_EQ(2 * bytes, record.peak_bytes);
+            EXPECT_EQ(2, record.allocations);
+
+            a.reset();
+            EXPECT_EQ(before + 3 * bytes, registry.bytes());
+            a_copy.reset();
+            EXPECT_EQ(before + 2 * bytes, registry.bytes());
+        }
+        EXPECT_EQ(before, registry.bytes());
+
+        auto record = find(registry.names(), "memory_registry_b");
+        EXPECT_EQ(0, record.bytes);
+        EXPECT_EQ(2 * bytes, record.peak_bytes);
+        EXPECT_EQ(0, record.allocations);
+        EXPECT_EQ(2, record.total_allocations);
+
+        auto storage_types = registry.storage_types();
+        EXPECT_TRUE(std::any_of(storage_types.begin(), storage_types.end(), [&](memory_record const &record) {
+            return record.name.find("double") != std::string::npos && record.peak_bytes >= 3 * bytes;
+        }));
+
+        EXPECT_NE(std::string::npos, registry.to_json().find("\"name\": \"memory_registry_b\", \"bytes\": 0"));
+
+        registry.reset_peaks();
+        EXPECT_EQ(registry.bytes(), registry.peak_bytes());
+        EXPECT_EQ("", find(registry.names(), "memory_registry_b").name);
+    }
+
+    struct copy_functor {
+        using in = accessor<0, intent::in>;
+        using out = accessor<1, intent::inout>;
+        using param_list = make_param_list<in, out>;
+
+        template <typename Evaluation>
+        GT_FUNCTION static void apply(Evaluation &eval) {
+            eval(out()) = eval(in());
+        }
+    };
+
+    TEST(memory_registry, temporaries) {
+        auto &registry = memory_registry::instance();
+        storage_info_t info(12, 13, 7);
+        data_store_t in(info, 1.), out(info, 0.);
+        const std::size_t before = registry.bytes();
+        const auto computations_before = registry.computations().size();
+
+        arg<0, data_store_t> p_in;
+        arg<1, data_store_t> p_out;
+        tmp_arg<2, data_store_t> p_tmp;
+        {
+            auto comp = make_computation<backend_t>(make_grid(halo_descriptor(1, 1, 1, 10, 12),
+                                                        halo_descriptor(1, 1, 1, 11, 13),
+                                                        7),
+                p_in = in,
+                p_out = out,
+                make_multistage(execute::forward(),
+                    make_stage<copy_functor>(p_in, p_tmp),
+                    make_stage<copy_functor>(p_tmp, p_out)));
+            comp.run();
+
+            auto computations = registry.computations();
+            ASSERT_EQ(computations_before + 1, computations.size());
+            auto record = std::find_if(computations.begin(), computations.end(), [](memory_record const &record) {
+                return record.allocations == 1;
+            });
+            ASSERT_NE(computations.end(), record);
+            EXPECT_LT(0, record->bytes);
+            EXPECT_EQ(before + record->bytes, registry.bytes());
+            EXPECT_EQ(10 * 11 * 7 * sizeof(double), record->domain_bytes);
+        }
+        EXPECT_EQ(before, registry.bytes());
+        for (auto const &record : registry.computations())
+            EXPECT_EQ(0, record.allocations);
+    }
+} // namespace
@@ -0,0 +1,149 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/storage/storage_facility.hpp>
+#include <gridtools/tools/backend_select.hpp>
+
+using namespace gridtools;
+
+namespace {
+    using storage_info_t = storage_traits<backend_t>::storage_info_t<0, 3, halo<1, 2, 0>>;
+    using data_store_t = storage_traits<backend_t>::mmap_data_store_t<double, storage_info_t>;
+
+    class mmap_storage_test : public ::testing::Test {
+      protected:
+        std::string m_path = ::testing::TempDir() + "gt_test_mmap_storage.bin";
+        storage_info_t m_info{7, 8, 5};
+
+        ~mmap_storage_test() { std::remove(m_path.c_str()); }
+
+        void write_checkpoint() {
+            auto ds = make_mmap_data_store<data_store_t>(m_info, m_path, mmap_mode::create, "checkpoint");
+            auto view = make_host_view(ds);
+            for (int i = 0; i < 7; ++i)
+                for (int j = 0; j < 8; ++j)
+                    for (int k = 0; k < 5; ++k)
+                        view(i, j, k) = i + 10 * j + 100 * k;
+            flush_data_store(ds);
+        }
+
+        void check(data_store_t const &ds, double offset = 0) {
+            auto view = make_host_view<access_mode::read_only>(ds);
+            for (int i = 0; i < 7; ++i)
+                for (int j = 0; j < 8; ++j)
+                    for (int k = 0; k < 5; ++k)
+                        EXPECT_EQ(i + 10 * j + 100 * k + offset, view(i, j, k));
+        }
+    };
+
+    TEST_F(mmap_storage_test, create_is_zero_initialized) {
+        auto ds = make_mmap_data_store<data_store_t>(m_info, m_path, mmap_mode::create);
+        EXPECT_TRUE(ds.valid());
+        auto view = make_host_view(ds);
+        EXPECT_EQ(0, view(0, 0, 0));
+        EXPECT_EQ(0, view(6, 7, 4));
+    }
+
+    TEST_F(mmap_storage_test, restart) {
+        write_checkpoint();
+        auto ds = make_mmap_data_store<data_store_t>(m_info, m_path, mmap_mode::read_write, "restart");
+        EXPECT_EQ("restart", ds.name());
+        check(ds);
+
+        // the first element of the inner region is aligned as for the other storages
+        auto ptr = reinterpret_cast<std::uintptr_t>(ds.get_storage_ptr()->get_cpu_ptr());
+        EXPECT_EQ(0, (ptr + m_info.first_index_of_inner_region() * sizeof(double)) %
+                         (storage_info_t::alignment_t::value * sizeof(double)));
+    }
+
+    TEST_F(mmap_storage_test, read_write) {
+        write_checkpoint();
+        {
+            auto ds = make_mmap_data_store<data_store_t>(m_info, m_path, mmap_mode::read_write);
+            auto view = make_host_view(ds);
+            for (int i = 0; i < 7; ++i)
+                for (int j = 0; j < 8; ++j)
+                    for (int k = 0; k < 5; ++k)
+                        view(i, j, k) += 1;
+        }
+        check(make_mmap_data_store<data_store_t>(m_info, m_path, mmap_mode::copy_on_write), 1);
+    }
+
+    TEST_F(mmap_storage_test, copy_on_write) {
+        write_checkpoint();
+        {
+            auto ds = make_mmap_data_store<data_store_t>(m_info, m_path, mmap_mode::copy_on_write);
+            make_host_view(ds)(1, 2, 3) = -1;
+            EXPECT_EQ(-1, make_host_view(ds)(1, 2, 3));
+            flush_data_store(ds);
+        }
+        check(make_mmap_data_store<data_store_t>(m_info, m_path, mmap_mode::read_write));
+    }
+
+    TEST_F(mmap_storage_test, other_data_offset) {
+        write_checkpoint();
+
+        // move the data as if the file was written with a 4KB data area offset, e.g. on a system with 4KB pages
+        std::vector<char> content;
+        {
+            std::ifstream in(m_path, std::ios::binary);
+            content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+        _impl_mmap_storage::header header;
+        std::memcpy(&header, content.data(), sizeof(header));
+        const std::size_t old_offset = header.data_offset;
+        header.data_offset = old_offset - _impl_mmap_storage::data_area_offset + 4096;
+        {
+            std::ofstream out(m_path, std::ios::binary | std::ios::trunc);
+            out.write(reinterpret_cast<char const *>(&header), sizeof(header));
+            out.write(content.data() + sizeof(header), header.data_offset - sizeof(header));
+            out.write(content.data() + old_offset, content.size() - old_offset);
+        }
+        check(make_mmap_data_store<data_store_t>(m_info, m_path, mmap_mode::read_write));
+
+        // an offset that breaks the alignment of the elements is rejected
+        header.data_offset -= sizeof(double) / 2;
+        {
+            std::fstream out(m_path, std::ios::binary | std::ios::in | std::ios::out);
+            out.write(reinterpret_cast<char const *>(&header), sizeof(header));
+        }
+        EXPECT_THROW(make_mmap_data_store<data_store_t>(m_info, m_path, mmap_mode::read_write), std::runtime_error);
+    }
+
+    TEST_F(mmap_storage_test, mismatch) {
+        write_checkpoint();
+
+        storage_info_t other_lengths(7, 8, 6);
+        EXPECT_THROW(make_mmap_data_store<data_store_t>(other_lengths, m_path, mmap_mode::read_write),
+            std::runtime_error);
+
+        using other_halo_info_t = storage_traits<backend_t>::storage_info_t<0, 3, halo<2, 1, 0>>;
+        using other_halo_t = storage_traits<backend_t>::mmap_data_store_t<double, other_halo_info_t>;
+        EXPECT_THROW(make_mmap_data_store<other_halo_t>(other_halo_info_t(7, 8, 5), m_path, mmap_mode::read_write),
+            std::runtime_error);
+
+        using other_type_t = storage_traits<backend_t>::mmap_data_store_t<long, storage_info_t>;
+        EXPECT_THROW(
+            make_mmap_data_store<other_type_t>(m_info, m_path, mmap_mode::read_write), std::runtime_error);
+
+        EXPECT_THROW(make_mmap_data_store<data_store_t>(m_info, m_path + ".missing", mmap_mode::read_write),
+            std::system_error);
+    }
+} // namespace
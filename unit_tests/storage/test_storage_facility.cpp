@@ -39,6 +39,12 @@ struct static_type_tests {
                          storage_info<0, layout_map<0, 1, -1>, halo<1, 2, 3>, alignment<1>>>::type::value),
         "storage info test failed");
 
+    // padded storage info
+    typedef typename storage_traits_t::template padded_storage_info_t<0, 3, halo<1, 2, 3>> padded_storage_info_ty;
+    GT_STATIC_ASSERT((std::is_same<padded_storage_info_ty,
+                         storage_info<0, layout_map<0, 1, 2>, halo<1, 2, 3>, alignment<1>, cache_padding<>>>::value),
+        "storage info test failed");
+
     /*########## DATA STORE CHECKS ########## */
     typedef typename storage_traits_t::template data_store_t<double, storage_info_ty> data_store_t;
     GT_STATIC_ASSERT((std::is_same<typename data_store_t::storage_info_t, storage_info_ty>::type::value),
@@ -106,6 +112,10 @@ struct static_type_tests<backend::mc> {
                          storage_info<0, layout_map<1, 0, -1>, halo<1, 2, 3>, alignment<8>>>::type::value),
         "storage info test failed");
 
+    // padded storage info
+    typedef storage_traits_t::padded_storage_info_t<0, 3, halo<1, 2, 3>, no_padding> padded_storage_info_ty;
+    GT_STATIC_ASSERT((std::is_same<padded_storage_info_ty, storage_info_ty>::value), "storage info test failed");
+
     /*########## DATA STORE CHECKS ########## */
     typedef storage_traits_t::data_store_t<double, storage_info_ty> data_store_t;
     GT_STATIC_ASSERT((std::is_same<typename data_store_t::storage_info_t, storage_info_ty>::type::value),